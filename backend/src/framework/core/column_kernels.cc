@@ -0,0 +1,282 @@
+/*
+ * @Author: Nana5aki
+ * @Date: 2026-10-18 23:20:06
+ * @LastEditors: Nana5aki
+ * @LastEditTime: 2026-10-18 23:20:06
+ * @FilePath: \life_view\backend\src\framework\core\column_kernels.cc
+ */
+#include "column_kernels.h"
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#  if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    define COLUMN_SIMD_X86 1
+#    include <immintrin.h>
+#    if defined(_MSC_VER) && !defined(__clang__)
+#      include <intrin.h>
+#      define COLUMN_TARGET_AVX2
+#    else
+#      define COLUMN_TARGET_AVX2 __attribute__((target("avx2")))
+#    endif
+#  endif
+#endif
+
+namespace framework {
+
+namespace {
+
+using RangeMaskFn = void (*)(const int64_t*, size_t, int64_t, int64_t, uint64_t*);
+using BitwiseFn = void (*)(uint64_t*, const uint64_t*, size_t);
+using CountFn = size_t (*)(const uint64_t*, size_t);
+
+//////////////////////////////////////////////////////////////////////////////
+// 标量实现，也用于各SIMD实现处理不足一个向量的尾部
+
+void RangeMaskTail(const int64_t* values, size_t begin, size_t count, int64_t min, int64_t max,
+                   uint64_t* out) {
+  if (begin >= count) {
+    return;
+  }
+  uint64_t bits = 0;
+  for (size_t i = begin; i < count; ++i) {
+    bits |= static_cast<uint64_t>(values[i] >= min && values[i] < max) << (i % 64);
+    if (i % 64 == 63) {
+      out[i / 64] = bits;
+      bits = 0;
+    }
+  }
+  if (count % 64 != 0) {
+    out[count / 64] = bits;
+  }
+}
+
+void RangeMaskScalar(const int64_t* values, size_t count, int64_t min, int64_t max,
+                     uint64_t* out) {
+  RangeMaskTail(values, 0, count, min, max, out);
+}
+
+void BitmapAndScalar(uint64_t* dst, const uint64_t* src, size_t words) {
+  for (size_t i = 0; i < words; ++i) {
+    dst[i] &= src[i];
+  }
+}
+
+void BitmapOrScalar(uint64_t* dst, const uint64_t* src, size_t words) {
+  for (size_t i = 0; i < words; ++i) {
+    dst[i] |= src[i];
+  }
+}
+
+// 不依赖popcnt指令的SWAR计数
+size_t PopCount64(uint64_t x) {
+  x = x - ((x >> 1) & 0x5555555555555555ULL);
+  x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+  x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+  return static_cast<size_t>((x * 0x0101010101010101ULL) >> 56);
+}
+
+size_t BitmapCountScalar(const uint64_t* words, size_t count) {
+  size_t total = 0;
+  for (size_t i = 0; i < count; ++i) {
+    total += PopCount64(words[i]);
+  }
+  return total;
+}
+
+#ifdef COLUMN_SIMD_X86
+
+//////////////////////////////////////////////////////////////////////////////
+// SSE2：没有64位整数比较，用32位比较拼出来
+
+// 每个64位通道 a > b 时全1
+__m128i CompareGreaterInt64Sse2(__m128i a, __m128i b) {
+  // 低32位按无符号比较：两边都翻转符号位后做有符号比较
+  const __m128i low_bias = _mm_set_epi32(0, static_cast<int>(0x80000000), 0,
+                                         static_cast<int>(0x80000000));
+  __m128i greater = _mm_cmpgt_epi32(a, b);
+  __m128i equal = _mm_cmpeq_epi32(a, b);
+  __m128i low_greater = _mm_cmpgt_epi32(_mm_xor_si128(a, low_bias), _mm_xor_si128(b, low_bias));
+  // 高32位大，或高32位相等且低32位大；结果在每个通道的高32位，再广播到整个通道
+  __m128i result = _mm_or_si128(
+    greater, _mm_and_si128(equal, _mm_shuffle_epi32(low_greater, _MM_SHUFFLE(2, 2, 0, 0))));
+  return _mm_shuffle_epi32(result, _MM_SHUFFLE(3, 3, 1, 1));
+}
+
+void RangeMaskSse2(const int64_t* values, size_t count, int64_t min, int64_t max,
+                   uint64_t* out) {
+  const __m128i vmin = _mm_set1_epi64x(min);
+  const __m128i vmax = _mm_set1_epi64x(max);
+  size_t full = count / 64 * 64;
+  for (size_t base = 0; base < full; base += 64) {
+    uint64_t bits = 0;
+    for (size_t j = 0; j < 64; j += 2) {
+      __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + base + j));
+      // !(v < min) && v < max
+      __m128i in = _mm_andnot_si128(CompareGreaterInt64Sse2(vmin, v),
+                                    CompareGreaterInt64Sse2(vmax, v));
+      bits |= static_cast<uint64_t>(_mm_movemask_pd(_mm_castsi128_pd(in))) << j;
+    }
+    out[base / 64] = bits;
+  }
+  RangeMaskTail(values, full, count, min, max, out);
+}
+
+void BitmapAndSse2(uint64_t* dst, const uint64_t* src, size_t words) {
+  size_t i = 0;
+  for (; i + 2 <= words; i += 2) {
+    __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+    __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_and_si128(a, b));
+  }
+  BitmapAndScalar(dst + i, src + i, words - i);
+}
+
+void BitmapOrSse2(uint64_t* dst, const uint64_t* src, size_t words) {
+  size_t i = 0;
+  for (; i + 2 <= words; i += 2) {
+    __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+    __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_or_si128(a, b));
+  }
+  BitmapOrScalar(dst + i, src + i, words - i);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// AVX2
+
+COLUMN_TARGET_AVX2 void RangeMaskAvx2(const int64_t* values, size_t count, int64_t min,
+                                      int64_t max, uint64_t* out) {
+  const __m256i vmin = _mm256_set1_epi64x(min);
+  const __m256i vmax = _mm256_set1_epi64x(max);
+  size_t full = count / 64 * 64;
+  for (size_t base = 0; base < full; base += 64) {
+    uint64_t bits = 0;
+    for (size_t j = 0; j < 64; j += 4) {
+      __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + base + j));
+      __m256i in =
+        _mm256_andnot_si256(_mm256_cmpgt_epi64(vmin, v), _mm256_cmpgt_epi64(vmax, v));
+      bits |= static_cast<uint64_t>(_mm256_movemask_pd(_mm256_castsi256_pd(in))) << j;
+    }
+    out[base / 64] = bits;
+  }
+  RangeMaskTail(values, full, count, min, max, out);
+}
+
+COLUMN_TARGET_AVX2 void BitmapAndAvx2(uint64_t* dst, const uint64_t* src, size_t words) {
+  size_t i = 0;
+  for (; i + 4 <= words; i += 4) {
+    __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+    __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_and_si256(a, b));
+  }
+  BitmapAndScalar(dst + i, src + i, words - i);
+}
+
+COLUMN_TARGET_AVX2 void BitmapOrAvx2(uint64_t* dst, const uint64_t* src, size_t words) {
+  size_t i = 0;
+  for (; i + 4 <= words; i += 4) {
+    __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+    __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_or_si256(a, b));
+  }
+  BitmapOrScalar(dst + i, src + i, words - i);
+}
+
+// 按半字节查表计数(Mula)，每个字节的计数用sad累加到64位通道
+COLUMN_TARGET_AVX2 size_t BitmapCountAvx2(const uint64_t* words, size_t count) {
+  const __m256i table =
+    _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                     0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+  const __m256i low_mask = _mm256_set1_epi8(0x0F);
+  __m256i sum = _mm256_setzero_si256();
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(words + i));
+    __m256i low = _mm256_and_si256(v, low_mask);
+    __m256i high = _mm256_and_si256(_mm256_srli_epi16(v, 4), low_mask);
+    __m256i bytes =
+      _mm256_add_epi8(_mm256_shuffle_epi8(table, low), _mm256_shuffle_epi8(table, high));
+    sum = _mm256_add_epi64(sum, _mm256_sad_epu8(bytes, _mm256_setzero_si256()));
+  }
+  uint64_t lanes[4];
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), sum);
+  return static_cast<size_t>(lanes[0] + lanes[1] + lanes[2] + lanes[3]) +
+         BitmapCountScalar(words + i, count - i);
+}
+
+bool CpuHasAvx2() {
+#  if defined(_MSC_VER) && !defined(__clang__)
+  int info[4];
+  __cpuid(info, 0);
+  if (info[0] < 7) {
+    return false;
+  }
+  __cpuid(info, 1);
+  // OSXSAVE且系统开启了YMM状态保存
+  bool os_avx = (info[2] & (1 << 27)) != 0 && (_xgetbv(0) & 0x6) == 0x6;
+  __cpuidex(info, 7, 0);
+  return os_avx && (info[1] & (1 << 5)) != 0;
+#  else
+  return __builtin_cpu_supports("avx2");
+#  endif
+}
+
+#endif   // COLUMN_SIMD_X86
+
+// 环境变量LIFE_VIEW_COLUMN_KERNELS=scalar/sse2可强制使用指定实现，便于对比测试
+const ColumnKernels& SelectKernels() {
+  static const ColumnKernels& kernels = []() -> const ColumnKernels& {
+    const std::vector<ColumnKernels>& available = AvailableColumnKernels();
+    const char* forced = std::getenv("LIFE_VIEW_COLUMN_KERNELS");
+    for (const ColumnKernels& item : available) {
+      if (forced && std::strcmp(forced, item.name) == 0) {
+        return item;
+      }
+    }
+    return available.front();
+  }();
+  return kernels;
+}
+
+}   // namespace
+
+void RangeMaskInt64(const int64_t* values, size_t count, int64_t min, int64_t max,
+                    uint64_t* out) {
+  SelectKernels().range_mask(values, count, min, max, out);
+}
+
+void BitmapAnd(uint64_t* dst, const uint64_t* src, size_t words) {
+  SelectKernels().bitmap_and(dst, src, words);
+}
+
+void BitmapOr(uint64_t* dst, const uint64_t* src, size_t words) {
+  SelectKernels().bitmap_or(dst, src, words);
+}
+
+size_t BitmapCount(const uint64_t* words, size_t count) {
+  return SelectKernels().bitmap_count(words, count);
+}
+
+const char* ColumnKernelName() {
+  return SelectKernels().name;
+}
+
+const std::vector<ColumnKernels>& AvailableColumnKernels() {
+  static const std::vector<ColumnKernels> kernels = []() {
+    std::vector<ColumnKernels> result;
+#ifdef COLUMN_SIMD_X86
+    if (CpuHasAvx2()) {
+      result.push_back({RangeMaskAvx2, BitmapAndAvx2, BitmapOrAvx2, BitmapCountAvx2, "avx2"});
+    }
+    // SSE2没有popcnt/pshufb，计数用标量SWAR
+    result.push_back({RangeMaskSse2, BitmapAndSse2, BitmapOrSse2, BitmapCountScalar, "sse2"});
+#endif
+    result.push_back(
+      {RangeMaskScalar, BitmapAndScalar, BitmapOrScalar, BitmapCountScalar, "scalar"});
+    return result;
+  }();
+  return kernels;
+}
+
+}   // namespace framework
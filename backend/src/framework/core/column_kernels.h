@@ -0,0 +1,52 @@
+/*
+ * @Author: Nana5aki
+ * @Date: 2026-10-18 23:20:06
+ * @LastEditors: Nana5aki
+ * @LastEditTime: 2026-10-18 23:20:06
+ * @FilePath: \life_view\backend\src\framework\core\column_kernels.h
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace framework {
+
+// 列式数据的过滤和计数核函数，按CPU选择AVX2/SSE2实现，其他平台为标量实现。
+//
+// 位图按64位字存储，第i行对应第i/64个字的第i%64位；
+// 行数不是64的倍数时最后一个字的多余高位始终为0，计数不需要再截断。
+
+inline size_t BitmapWords(size_t rows) {
+  return (rows + 63) / 64;
+}
+
+// values[i]在[min, max)内的行置1，out需要BitmapWords(count)个字
+void RangeMaskInt64(const int64_t* values, size_t count, int64_t min, int64_t max,
+                    uint64_t* out);
+
+// dst &= src / dst |= src
+void BitmapAnd(uint64_t* dst, const uint64_t* src, size_t words);
+void BitmapOr(uint64_t* dst, const uint64_t* src, size_t words);
+
+// 置1的位数
+size_t BitmapCount(const uint64_t* words, size_t count);
+
+// 当前使用的实现: "avx2" / "sse2" / "scalar"
+const char* ColumnKernelName();
+
+// 一组实现，语义与上面的同名函数相同
+struct ColumnKernels {
+  void (*range_mask)(const int64_t* values, size_t count, int64_t min, int64_t max,
+                     uint64_t* out);
+  void (*bitmap_and)(uint64_t* dst, const uint64_t* src, size_t words);
+  void (*bitmap_or)(uint64_t* dst, const uint64_t* src, size_t words);
+  size_t (*bitmap_count)(const uint64_t* words, size_t count);
+  const char* name;
+};
+
+// 本机可用的全部实现，第一个为默认选择，最后一个为标量实现。用于对比测试和基准
+const std::vector<ColumnKernels>& AvailableColumnKernels();
+
+}   // namespace framework
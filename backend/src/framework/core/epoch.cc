@@ -0,0 +1,167 @@
+/*
+ * @Author: Nana5aki
+ * @Date: 2026-10-19 00:12:40
+ * @LastEditors: Nana5aki
+ * @LastEditTime: 2026-10-19 00:12:40
+ * @FilePath: \life_view\backend\src\framework\core\epoch.cc
+ */
+#include "epoch.h"
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace framework {
+
+namespace {
+
+// 每个读过的线程一条，线程退出后留给新线程复用，不释放
+struct ThreadRecord {
+  // 读者进入时的全局epoch，0表示不在读
+  std::atomic<uint64_t> epoch{0};
+  std::atomic<bool> in_use{false};
+  ThreadRecord* next = nullptr;
+};
+
+struct RetiredObject {
+  void* object;
+  Epoch::Deleter deleter;
+  uint64_t epoch;
+};
+
+struct Domain {
+  // 从1开始，0留给"不在读"
+  std::atomic<uint64_t> epoch{1};
+  std::atomic<ThreadRecord*> records{nullptr};
+  std::mutex mutex;
+  std::vector<RetiredObject> retired;
+};
+
+// 不析构：退出时其他静态对象的析构仍可能调用Retire
+Domain* GetDomain() {
+  static Domain* domain = new Domain();
+  return domain;
+}
+
+ThreadRecord* AcquireRecord() {
+  Domain* domain = GetDomain();
+  for (ThreadRecord* record = domain->records.load(std::memory_order_acquire); record;
+       record = record->next) {
+    bool expected = false;
+    if (!record->in_use.load(std::memory_order_relaxed) &&
+        record->in_use.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+      return record;
+    }
+  }
+  ThreadRecord* record = new ThreadRecord();
+  record->in_use.store(true, std::memory_order_relaxed);
+  ThreadRecord* head = domain->records.load(std::memory_order_relaxed);
+  do {
+    record->next = head;
+  } while (!domain->records.compare_exchange_weak(
+    head, record, std::memory_order_release, std::memory_order_relaxed));
+  return record;
+}
+
+struct LocalRecord {
+  ThreadRecord* record = nullptr;
+  int depth = 0;
+
+  ~LocalRecord() {
+    if (record) {
+      record->epoch.store(0, std::memory_order_release);
+      record->in_use.store(false, std::memory_order_release);
+    }
+  }
+};
+
+thread_local LocalRecord local_record;
+
+// 需持有domain->mutex。所有正在读的线程都已进入当前epoch时前进一步，
+// 把epoch落后两步以上的对象移入freed
+void CollectLocked(Domain* domain, std::vector<RetiredObject>* freed) {
+  uint64_t current = domain->epoch.load(std::memory_order_relaxed);
+  bool can_advance = true;
+  for (ThreadRecord* record = domain->records.load(std::memory_order_acquire); record;
+       record = record->next) {
+    uint64_t epoch = record->epoch.load(std::memory_order_acquire);
+    if (epoch != 0 && epoch != current) {
+      can_advance = false;
+      break;
+    }
+  }
+  if (can_advance) {
+    domain->epoch.store(++current, std::memory_order_release);
+  }
+
+  auto& retired = domain->retired;
+  size_t kept = 0;
+  for (size_t i = 0; i < retired.size(); ++i) {
+    if (retired[i].epoch + 2 <= current) {
+      freed->push_back(retired[i]);
+    } else {
+      retired[kept++] = retired[i];
+    }
+  }
+  retired.resize(kept);
+}
+
+void Free(const std::vector<RetiredObject>& freed) {
+  for (const auto& item : freed) {
+    item.deleter(item.object);
+  }
+}
+
+}   // namespace
+
+EpochGuard::EpochGuard() {
+  LocalRecord& local = local_record;
+  if (local.depth++ > 0) {
+    return;
+  }
+  if (!local.record) {
+    local.record = AcquireRecord();
+  }
+  local.record->epoch.store(GetDomain()->epoch.load(std::memory_order_relaxed),
+                            std::memory_order_relaxed);
+  // 公告epoch必须先于之后对发布指针的读取对写者可见
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+}
+
+EpochGuard::~EpochGuard() {
+  LocalRecord& local = local_record;
+  if (--local.depth == 0) {
+    local.record->epoch.store(0, std::memory_order_release);
+  }
+}
+
+void Epoch::Retire(void* object, Deleter deleter) {
+  // 与读者的公告配对：替换指针先于扫描读者记录
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  Domain* domain = GetDomain();
+  std::vector<RetiredObject> freed;
+  {
+    std::lock_guard<std::mutex> lock(domain->mutex);
+    domain->retired.push_back(
+      {object, deleter, domain->epoch.load(std::memory_order_relaxed)});
+    CollectLocked(domain, &freed);
+  }
+  // 在锁外释放，析构中再Retire不会死锁
+  Free(freed);
+}
+
+size_t Epoch::Reclaim() {
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  Domain* domain = GetDomain();
+  std::vector<RetiredObject> freed;
+  size_t pending;
+  {
+    std::lock_guard<std::mutex> lock(domain->mutex);
+    CollectLocked(domain, &freed);
+    pending = domain->retired.size();
+  }
+  Free(freed);
+  return pending;
+}
+
+}   // namespace framework
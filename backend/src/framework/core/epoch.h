@@ -0,0 +1,47 @@
+/*
+ * @Author: Nana5aki
+ * @Date: 2026-10-19 00:12:40
+ * @LastEditors: Nana5aki
+ * @LastEditTime: 2026-10-19 00:12:40
+ * @FilePath: \life_view\backend\src\framework\core\epoch.h
+ */
+#pragma once
+
+#include <cstddef>
+
+namespace framework {
+
+// 基于epoch的延迟回收(EBR)，用于写者发布不可变对象、读者在任意线程无锁读取。
+//
+// 读者在EpochGuard范围内读取发布的指针，进入和离开各是一次原子写，不加锁也不等待。
+// 写者换上新对象后把旧对象交给Retire；全局epoch前进两次之后才释放，
+// 而每次前进都要求所有正在读的线程已经进入当前epoch，因此释放时不可能还有读者持有它。
+// 读者长时间停留在Guard内会推迟回收，Guard只应包住一次读取。
+
+// 可以嵌套，只有最外层生效
+class EpochGuard {
+public:
+  EpochGuard();
+  ~EpochGuard();
+
+  EpochGuard(const EpochGuard&) = delete;
+  EpochGuard& operator=(const EpochGuard&) = delete;
+};
+
+class Epoch {
+public:
+  using Deleter = void (*)(void*);
+
+  // 任意线程调用；调用前object必须已经对新的读者不可见
+  static void Retire(void* object, Deleter deleter);
+
+  template <typename T>
+  static void Retire(const T* object) {
+    Retire(const_cast<T*>(object), [](void* pointer) { delete static_cast<T*>(pointer); });
+  }
+
+  // 尝试推进epoch并释放已经安全的对象，返回仍在等待释放的对象数
+  static size_t Reclaim();
+};
+
+}   // namespace framework
@@ -0,0 +1,61 @@
+/*
+ * @Author: Nana5aki
+ * @Date: 2026-10-18 10:15:40
+ * @LastEditors: Nana5aki
+ * @LastEditTime: 2026-10-18 10:15:40
+ * @FilePath: \life_view\backend\src\framework\core\main_thread.cc
+ */
+#include "main_thread.h"
+#include <deque>
+#include <mutex>
+
+namespace framework {
+
+namespace {
+
+std::mutex& QueueMutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
+std::deque<MainThread::Task>& Queue() {
+  static std::deque<MainThread::Task> queue;
+  return queue;
+}
+
+MainThread::Waker& CurrentWaker() {
+  static MainThread::Waker waker;
+  return waker;
+}
+
+}   // namespace
+
+void MainThread::Post(Task task) {
+  Waker waker;
+  {
+    std::lock_guard<std::mutex> lock(QueueMutex());
+    Queue().push_back(std::move(task));
+    waker = CurrentWaker();
+  }
+  if (waker) {
+    waker();
+  }
+}
+
+void MainThread::RunPending() {
+  std::deque<Task> tasks;
+  {
+    std::lock_guard<std::mutex> lock(QueueMutex());
+    tasks.swap(Queue());
+  }
+  for (auto& task : tasks) {
+    task();
+  }
+}
+
+void MainThread::SetWaker(Waker waker) {
+  std::lock_guard<std::mutex> lock(QueueMutex());
+  CurrentWaker() = std::move(waker);
+}
+
+}   // namespace framework
@@ -0,0 +1,31 @@
+/*
+ * @Author: Nana5aki
+ * @Date: 2026-10-18 10:15:40
+ * @LastEditors: Nana5aki
+ * @LastEditTime: 2026-10-18 10:15:40
+ * @FilePath: \life_view\backend\src\framework\core\main_thread.h
+ */
+#pragma once
+
+#include <functional>
+
+namespace framework {
+
+// ViewModel属性和监听器只能在主线程(JS线程)访问。
+// 后台线程通过Post把任务投递回主线程，由平台层负责唤醒主线程调用RunPending。
+class MainThread {
+public:
+  using Task = std::function<void()>;
+  using Waker = std::function<void()>;
+
+  // 任意线程调用，任务按投递顺序在主线程执行
+  static void Post(Task task);
+
+  // 主线程调用，执行当前所有待处理任务
+  static void RunPending();
+
+  // 平台层设置唤醒函数，每次Post后调用（可能在任意线程）
+  static void SetWaker(Waker waker);
+};
+
+}   // namespace framework
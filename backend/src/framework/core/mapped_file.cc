@@ -0,0 +1,142 @@
+/*
+ * @Author: Nana5aki
+ * @Date: 2026-10-18 10:31:05
+ * @LastEditors: Nana5aki
+ * @LastEditTime: 2026-10-18 10:31:05
+ * @FilePath: \life_view\backend\src\framework\core\mapped_file.cc
+ */
+#include "mapped_file.h"
+
+#ifdef _WIN32
+#  ifndef WIN32_LEAN_AND_MEAN
+#    define WIN32_LEAN_AND_MEAN
+#  endif
+#  include <windows.h>
+#else
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+namespace framework {
+
+MappedFile::~MappedFile() {
+  Close();
+}
+
+#ifdef _WIN32
+
+bool MappedFile::Open(const std::string& path, std::string* error) {
+  Close();
+  int wide_len = MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, nullptr, 0);
+  std::wstring wide_path(wide_len > 0 ? wide_len - 1 : 0, L'\0');
+  if (wide_len > 1) {
+    MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, &wide_path[0], wide_len);
+  }
+
+  HANDLE file = CreateFileW(wide_path.c_str(),
+                            GENERIC_READ,
+                            FILE_SHARE_READ,
+                            nullptr,
+                            OPEN_EXISTING,
+                            FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+                            nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    if (error) *error = "cannot open file: " + path;
+    return false;
+  }
+
+  LARGE_INTEGER file_size;
+  if (!GetFileSizeEx(file, &file_size)) {
+    CloseHandle(file);
+    if (error) *error = "cannot stat file: " + path;
+    return false;
+  }
+
+  file_handle_ = file;
+  size_ = static_cast<size_t>(file_size.QuadPart);
+  if (size_ == 0) {
+    return true;
+  }
+
+  HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (mapping == nullptr) {
+    Close();
+    if (error) *error = "cannot map file: " + path;
+    return false;
+  }
+  mapping_handle_ = mapping;
+
+  data_ = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+  if (data_ == nullptr) {
+    Close();
+    if (error) *error = "cannot map file: " + path;
+    return false;
+  }
+  return true;
+}
+
+void MappedFile::Close() {
+  if (data_) {
+    UnmapViewOfFile(data_);
+  }
+  if (mapping_handle_) {
+    CloseHandle(static_cast<HANDLE>(mapping_handle_));
+  }
+  if (file_handle_) {
+    CloseHandle(static_cast<HANDLE>(file_handle_));
+  }
+  data_ = nullptr;
+  size_ = 0;
+  mapping_handle_ = nullptr;
+  file_handle_ = nullptr;
+}
+
+#else
+
+bool MappedFile::Open(const std::string& path, std::string* error) {
+  Close();
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    if (error) *error = "cannot open file: " + path;
+    return false;
+  }
+
+  struct stat st;
+  if (::fstat(fd, &st) != 0) {
+    ::close(fd);
+    if (error) *error = "cannot stat file: " + path;
+    return false;
+  }
+
+  size_ = static_cast<size_t>(st.st_size);
+  if (size_ == 0) {
+    ::close(fd);
+    return true;
+  }
+
+  void* addr = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+  // 映射建立后即可关闭fd
+  ::close(fd);
+  if (addr == MAP_FAILED) {
+    size_ = 0;
+    if (error) *error = "cannot map file: " + path;
+    return false;
+  }
+  ::madvise(addr, size_, MADV_SEQUENTIAL);
+  data_ = static_cast<const char*>(addr);
+  return true;
+}
+
+void MappedFile::Close() {
+  if (data_) {
+    ::munmap(const_cast<char*>(data_), size_);
+  }
+  data_ = nullptr;
+  size_ = 0;
+}
+
+#endif
+
+}   // namespace framework
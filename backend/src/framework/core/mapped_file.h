@@ -0,0 +1,44 @@
+/*
+ * @Author: Nana5aki
+ * @Date: 2026-10-18 10:31:05
+ * @LastEditors: Nana5aki
+ * @LastEditTime: 2026-10-18 10:31:05
+ * @FilePath: \life_view\backend\src\framework\core\mapped_file.h
+ */
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace framework {
+
+// 只读内存映射文件，大文件导入时避免整体read到内存
+class MappedFile {
+public:
+  MappedFile() = default;
+  ~MappedFile();
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  // 映射失败返回false，error写入失败原因
+  bool Open(const std::string& path, std::string* error = nullptr);
+  void Close();
+
+  const char* Data() const {
+    return data_;
+  }
+  size_t Size() const {
+    return size_;
+  }
+
+private:
+  const char* data_ = nullptr;
+  size_t size_ = 0;
+#ifdef _WIN32
+  void* file_handle_ = nullptr;
+  void* mapping_handle_ = nullptr;
+#endif
+};
+
+}   // namespace framework
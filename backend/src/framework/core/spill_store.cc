@@ -0,0 +1,92 @@
+/*
+ * @Author: Nana5aki
+ * @Date: 2026-10-18 21:10:26
+ * @LastEditors: Nana5aki
+ * @LastEditTime: 2026-10-18 21:10:26
+ * @FilePath: \life_view\backend\src\framework\core\spill_store.cc
+ */
+#include "spill_store.h"
+#include <cassert>
+#include <iostream>
+
+namespace framework {
+
+namespace {
+
+bool Seek(FILE* file, uint64_t offset) {
+#ifdef _WIN32
+  return _fseeki64(file, static_cast<__int64>(offset), SEEK_SET) == 0;
+#else
+  return fseeko(file, static_cast<off_t>(offset), SEEK_SET) == 0;
+#endif
+}
+
+}   // namespace
+
+SpillStore::~SpillStore() {
+  if (file_) {
+    fclose(file_);
+  }
+}
+
+SpillStore* SpillStore::GetInstance() {
+  static SpillStore* instance = new SpillStore();
+  return instance;
+}
+
+bool SpillStore::Open() {
+  if (file_) {
+    return true;
+  }
+  // tmpfile创建的文件在关闭或进程退出时由系统删除
+  file_ = tmpfile();
+  if (!file_) {
+    std::cerr << "SpillStore: failed to create temp file" << std::endl;
+    return false;
+  }
+  end_ = 0;
+  live_ = 0;
+  return true;
+}
+
+bool SpillStore::Write(const std::string& bytes, Handle* handle) {
+  if (!Open()) {
+    return false;
+  }
+  if (!Seek(file_, end_) ||
+      fwrite(bytes.data(), 1, bytes.size(), file_) != bytes.size()) {
+    std::cerr << "SpillStore: write failed" << std::endl;
+    clearerr(file_);
+    return false;
+  }
+  handle->offset = end_;
+  handle->size = bytes.size();
+  end_ += bytes.size();
+  live_ += bytes.size();
+  return true;
+}
+
+bool SpillStore::Read(const Handle& handle, std::string* bytes) {
+  assert(file_ && handle.offset + handle.size <= end_);
+  bytes->resize(handle.size);
+  if (!Seek(file_, handle.offset) ||
+      fread(&(*bytes)[0], 1, handle.size, file_) != handle.size) {
+    std::cerr << "SpillStore: read failed" << std::endl;
+    clearerr(file_);
+    return false;
+  }
+  return true;
+}
+
+void SpillStore::Release(const Handle& handle) {
+  assert(live_ >= handle.size);
+  live_ -= handle.size;
+  // 没有存活数据时关闭文件，下次写入重新创建，释放磁盘空间
+  if (live_ == 0 && file_) {
+    fclose(file_);
+    file_ = nullptr;
+    end_ = 0;
+  }
+}
+
+}   // namespace framework
@@ -0,0 +1,56 @@
+/*
+ * @Author: Nana5aki
+ * @Date: 2026-10-18 21:10:26
+ * @LastEditors: Nana5aki
+ * @LastEditTime: 2026-10-18 21:10:26
+ * @FilePath: \life_view\backend\src\framework\core\spill_store.h
+ */
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+namespace framework {
+
+// 内存超出预算时换出的数据所在的临时文件。只追加写入，释放的区间记为垃圾，
+// 全部释放后截断文件重新使用。进程退出时文件自动删除。只能在主线程使用
+class SpillStore {
+public:
+  struct Handle {
+    uint64_t offset = 0;
+    uint64_t size = 0;
+  };
+
+  ~SpillStore();
+
+  SpillStore(const SpillStore&) = delete;
+  SpillStore& operator=(const SpillStore&) = delete;
+
+  static SpillStore* GetInstance();
+
+  bool Write(const std::string& bytes, Handle* handle);
+  bool Read(const Handle& handle, std::string* bytes);
+  // 释放后handle不能再读取
+  void Release(const Handle& handle);
+
+  // 文件当前大小
+  uint64_t FileBytes() const {
+    return end_;
+  }
+  // 仍被引用的字节数
+  uint64_t LiveBytes() const {
+    return live_;
+  }
+
+private:
+  SpillStore() = default;
+  bool Open();
+
+private:
+  FILE* file_ = nullptr;
+  uint64_t end_ = 0;
+  uint64_t live_ = 0;
+};
+
+}   // namespace framework
@@ -0,0 +1,63 @@
+/*
+ * @Author: Nana5aki
+ * @Date: 2026-10-18 10:02:11
+ * @LastEditors: Nana5aki
+ * @LastEditTime: 2026-10-18 10:02:11
+ * @FilePath: \life_view\backend\src\framework\core\thread_pool.cc
+ */
+#include "thread_pool.h"
+
+namespace framework {
+
+ThreadPool::ThreadPool(size_t thread_count) {
+  if (thread_count == 0) {
+    thread_count = std::max(1u, std::thread::hardware_concurrency());
+  }
+  workers_.reserve(thread_count);
+  for (size_t i = 0; i < thread_count; ++i) {
+    workers_.emplace_back([this]() { WorkerLoop(); });
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  cv_.notify_all();
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+}
+
+ThreadPool* ThreadPool::GetInstance() {
+  // 进程退出时不析构，避免在静态析构阶段join仍在运行的任务
+  static ThreadPool* instance = new ThreadPool();
+  return instance;
+}
+
+void ThreadPool::Post(std::function<void()> task) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    tasks_.push_back(std::move(task));
+  }
+  cv_.notify_one();
+}
+
+void ThreadPool::WorkerLoop() {
+  for (;;) {
+    std::function<void()> task;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [this]() { return stopping_ || !tasks_.empty(); });
+      if (stopping_ && tasks_.empty()) {
+        return;
+      }
+      task = std::move(tasks_.front());
+      tasks_.pop_front();
+    }
+    task();
+  }
+}
+
+}   // namespace framework
@@ -0,0 +1,60 @@
+/*
+ * @Author: Nana5aki
+ * @Date: 2026-10-18 10:02:11
+ * @LastEditors: Nana5aki
+ * @LastEditTime: 2026-10-18 10:02:11
+ * @FilePath: \life_view\backend\src\framework\core\thread_pool.h
+ */
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace framework {
+
+// 固定大小的工作线程池，用于批量解析/序列化等可并行的后台任务
+class ThreadPool {
+public:
+  // thread_count为0时使用硬件并发数
+  explicit ThreadPool(size_t thread_count = 0);
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  // 全局共享线程池
+  static ThreadPool* GetInstance();
+
+  size_t ThreadCount() const {
+    return workers_.size();
+  }
+
+  template <typename F>
+  auto Submit(F&& task) -> std::future<std::invoke_result_t<std::decay_t<F>>> {
+    using Result = std::invoke_result_t<std::decay_t<F>>;
+    auto packaged = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(task));
+    std::future<Result> future = packaged->get_future();
+    Post([packaged]() { (*packaged)(); });
+    return future;
+  }
+
+private:
+  void Post(std::function<void()> task);
+  void WorkerLoop();
+
+private:
+  std::vector<std::thread> workers_;
+  std::deque<std::function<void()>> tasks_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool stopping_ = false;
+};
+
+}   // namespace framework
@@ -0,0 +1,137 @@
+/*
+ * @Author: Nana5aki
+ * @Date: 2026-10-18 21:48:05
+ * @LastEditors: Nana5aki
+ * @LastEditTime: 2026-10-18 21:48:05
+ * @FilePath: \life_view\backend\src\framework\core\timer_service.cc
+ */
+#include "timer_service.h"
+#include "main_thread.h"
+#include <algorithm>
+#include <chrono>
+
+namespace framework {
+
+namespace {
+
+// 系统时间可能跳变(休眠、校时)，睡眠时间分段，每段醒来后按新的系统时间重新计算
+constexpr uint64_t kMaxSleepMs = 60 * 1000;
+
+uint64_t NowTick() {
+  using namespace std::chrono;
+  return static_cast<uint64_t>(
+    duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count());
+}
+
+// 与JS Date相同的时间范围，超出的时间(包括Infinity)转换为整数是未定义行为
+constexpr double kMaxDueMs = 8.64e15;
+
+bool DueTick(double due_ms, uint64_t* tick) {
+  if (!(due_ms <= kMaxDueMs)) {
+    return false;
+  }
+  // 已经过去的时间(包括-Infinity)在下一个tick到期
+  *tick = due_ms > 0 ? static_cast<uint64_t>(due_ms) : 0;
+  return true;
+}
+
+}   // namespace
+
+TimerService::TimerService()
+  : wheel_(NowTick()) {
+  sleeper_ = std::thread([this]() { SleeperLoop(); });
+}
+
+TimerService::~TimerService() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  cv_.notify_one();
+  if (sleeper_.joinable()) {
+    sleeper_.join();
+  }
+}
+
+TimerService* TimerService::GetInstance() {
+  // 进程退出时不析构，与ThreadPool一致
+  static TimerService* instance = new TimerService();
+  return instance;
+}
+
+double TimerService::NowMs() {
+  return static_cast<double>(NowTick());
+}
+
+TimerService::TimerId TimerService::Schedule(double due_ms, Task task) {
+  uint64_t tick;
+  if (!DueTick(due_ms, &tick)) {
+    return TimerWheel::kInvalidTimer;
+  }
+  TimerId id = wheel_.Insert(tick, std::move(task));
+  // 执行到期任务期间新加的定时器在RunDue结束时统一更新唤醒时间
+  if (!running_due_) {
+    UpdateDeadline();
+  }
+  return id;
+}
+
+bool TimerService::Cancel(TimerId id) {
+  // 取消不会让下一次推进提前，唤醒时间不用更新，最多多醒一次
+  return wheel_.Cancel(id);
+}
+
+void TimerService::UpdateDeadline() {
+  uint64_t next = wheel_.NextTick();
+  bool notify = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (wake_posted_) {
+      return;
+    }
+    notify = next < deadline_;
+    deadline_ = next;
+  }
+  if (notify) {
+    cv_.notify_one();
+  }
+}
+
+void TimerService::RunDue() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    wake_posted_ = false;
+  }
+  running_due_ = true;
+  // 到期的任务已从时间轮中移出，执行时可以再调度或取消定时器
+  std::vector<Task> tasks;
+  wheel_.Advance(std::max(NowTick(), wheel_.Now()), &tasks);
+  for (auto& task : tasks) {
+    task();
+  }
+  running_due_ = false;
+  UpdateDeadline();
+}
+
+void TimerService::SleeperLoop() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!stopping_) {
+    if (wake_posted_ || deadline_ == TimerWheel::kNever) {
+      cv_.wait(lock);
+      continue;
+    }
+    uint64_t now = NowTick();
+    if (deadline_ > now) {
+      uint64_t sleep_ms = std::min(deadline_ - now, kMaxSleepMs);
+      cv_.wait_for(lock, std::chrono::milliseconds(sleep_ms));
+      continue;
+    }
+    wake_posted_ = true;
+    deadline_ = TimerWheel::kNever;
+    lock.unlock();
+    MainThread::Post([this]() { RunDue(); });
+    lock.lock();
+  }
+}
+
+}   // namespace framework
@@ -0,0 +1,67 @@
+/*
+ * @Author: Nana5aki
+ * @Date: 2026-10-18 21:48:05
+ * @LastEditors: Nana5aki
+ * @LastEditTime: 2026-10-18 21:48:05
+ * @FilePath: \life_view\backend\src\framework\core\timer_service.h
+ */
+#pragma once
+
+#include "timer_wheel.h"
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace framework {
+
+// 主线程上的定时器，时间为UTC毫秒时间戳，精度1ms。
+// 时间轮只在主线程访问；后台线程只负责睡到下一个需要推进的时刻，
+// 然后通过MainThread::Post唤醒主线程推进并执行到期任务，所以取消总是精确的。
+class TimerService {
+public:
+  using TimerId = TimerWheel::TimerId;
+  using Task = TimerWheel::Task;
+
+  static constexpr TimerId kInvalidTimer = TimerWheel::kInvalidTimer;
+
+  ~TimerService();
+
+  TimerService(const TimerService&) = delete;
+  TimerService& operator=(const TimerService&) = delete;
+
+  static TimerService* GetInstance();
+
+  static double NowMs();
+
+  // 以下只能在主线程调用。已经过去的时间在下一轮主线程任务中触发；
+  // 晚于8.64e15(JS Date的上限)或为NaN时不调度，返回kInvalidTimer
+  TimerId Schedule(double due_ms, Task task);
+  bool Cancel(TimerId id);
+
+  size_t PendingCount() const {
+    return wheel_.Size();
+  }
+
+private:
+  TimerService();
+
+  void RunDue();
+  // 把后台线程的唤醒时间设为时间轮的下一个推进时刻
+  void UpdateDeadline();
+  void SleeperLoop();
+
+private:
+  TimerWheel wheel_;
+  bool running_due_ = false;
+
+  std::thread sleeper_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  // 以下受mutex_保护
+  uint64_t deadline_ = TimerWheel::kNever;
+  // 已投递RunDue还没执行，期间不需要再唤醒
+  bool wake_posted_ = false;
+  bool stopping_ = false;
+};
+
+}   // namespace framework
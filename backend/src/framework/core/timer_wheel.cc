@@ -0,0 +1,201 @@
+/*
+ * @Author: Nana5aki
+ * @Date: 2026-10-18 21:48:05
+ * @LastEditors: Nana5aki
+ * @LastEditTime: 2026-10-18 21:48:05
+ * @FilePath: \life_view\backend\src\framework\core\timer_wheel.cc
+ */
+#include "timer_wheel.h"
+#include <cassert>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#  include <intrin.h>
+#endif
+
+namespace framework {
+
+namespace {
+
+int TrailingZeros(uint64_t bits) {
+#if defined(_MSC_VER) && !defined(__clang__)
+  unsigned long index;
+  _BitScanForward64(&index, bits);
+  return static_cast<int>(index);
+#else
+  return __builtin_ctzll(bits);
+#endif
+}
+
+int HighestBit(uint64_t bits) {
+#if defined(_MSC_VER) && !defined(__clang__)
+  unsigned long index;
+  _BitScanReverse64(&index, bits);
+  return static_cast<int>(index);
+#else
+  return 63 - __builtin_clzll(bits);
+#endif
+}
+
+}   // namespace
+
+TimerWheel::TimerWheel(uint64_t now_tick)
+  : now_(now_tick) {
+  for (auto& head : heads_) {
+    head = kNil;
+  }
+}
+
+TimerWheel::TimerId TimerWheel::Insert(uint64_t expiry_tick, Task task) {
+  uint32_t index;
+  if (!free_nodes_.empty()) {
+    index = free_nodes_.back();
+    free_nodes_.pop_back();
+  } else {
+    index = static_cast<uint32_t>(nodes_.size());
+    nodes_.emplace_back();
+  }
+  Node& node = nodes_[index];
+  node.expiry = expiry_tick > now_ ? expiry_tick : now_ + 1;
+  node.task = std::move(task);
+  Link(index);
+  ++size_;
+  // 低32位为下标+1，保证有效id不为0
+  return (static_cast<uint64_t>(node.generation) << 32) | (index + 1);
+}
+
+bool TimerWheel::Cancel(TimerId id) {
+  uint32_t index = static_cast<uint32_t>(id & 0xffffffffu) - 1;
+  uint32_t generation = static_cast<uint32_t>(id >> 32);
+  if (id == kInvalidTimer || index >= nodes_.size()) {
+    return false;
+  }
+  Node& node = nodes_[index];
+  if (node.generation != generation || node.bucket == kNil) {
+    return false;
+  }
+  Unlink(index);
+  FreeNode(index);
+  return true;
+}
+
+void TimerWheel::Link(uint32_t index) {
+  Node& node = nodes_[index];
+  uint64_t delta = node.expiry - now_;
+  uint64_t tick = node.expiry;
+  int level = delta < kSlots ? 0 : HighestBit(delta) / kSlotBits;
+  if (level >= kLevels) {
+    // 超出覆盖范围，先放在最高层最远的位置，下放时按真实到期时间重新放置
+    level = kLevels - 1;
+    tick = now_ + (uint64_t(1) << (kLevels * kSlotBits)) - 1;
+  }
+  uint32_t slot = static_cast<uint32_t>(tick >> (level * kSlotBits)) & (kSlots - 1);
+  uint32_t bucket = level * kSlots + slot;
+
+  node.bucket = bucket;
+  node.prev = kNil;
+  node.next = heads_[bucket];
+  if (node.next != kNil) {
+    nodes_[node.next].prev = index;
+  }
+  heads_[bucket] = index;
+  occupied_[level] |= uint64_t(1) << slot;
+}
+
+void TimerWheel::Unlink(uint32_t index) {
+  Node& node = nodes_[index];
+  if (node.prev != kNil) {
+    nodes_[node.prev].next = node.next;
+  } else {
+    heads_[node.bucket] = node.next;
+    if (node.next == kNil) {
+      occupied_[node.bucket / kSlots] &= ~(uint64_t(1) << (node.bucket % kSlots));
+    }
+  }
+  if (node.next != kNil) {
+    nodes_[node.next].prev = node.prev;
+  }
+  node.bucket = kNil;
+}
+
+uint32_t TimerWheel::TakeBucket(uint32_t bucket) {
+  uint32_t head = heads_[bucket];
+  heads_[bucket] = kNil;
+  occupied_[bucket / kSlots] &= ~(uint64_t(1) << (bucket % kSlots));
+  return head;
+}
+
+void TimerWheel::FreeNode(uint32_t index) {
+  Node& node = nodes_[index];
+  node.bucket = kNil;
+  node.task = nullptr;
+  ++node.generation;
+  free_nodes_.push_back(index);
+  --size_;
+}
+
+uint64_t TimerWheel::NextTick() const {
+  uint64_t next = kNever;
+  for (int level = 0; level < kLevels; ++level) {
+    uint64_t occupied = occupied_[level];
+    if (occupied == 0) {
+      continue;
+    }
+    int shift = level * kSlotBits;
+    uint64_t unit = now_ >> shift;
+    uint32_t pos = static_cast<uint32_t>(unit) & (kSlots - 1);
+    // 当前位置之后的槽在这一圈处理，其余(含当前位置)在下一圈
+    uint64_t later = pos == kSlots - 1 ? 0 : occupied & (~uint64_t(0) << (pos + 1));
+    uint64_t target_unit = later ? unit - pos + TrailingZeros(later)
+                                 : unit - pos + kSlots + TrailingZeros(occupied);
+    uint64_t tick = target_unit << shift;
+    if (tick < next) {
+      next = tick;
+    }
+  }
+  return next;
+}
+
+void TimerWheel::Advance(uint64_t tick, std::vector<Task>* expired) {
+  while (size_ > 0) {
+    uint64_t next = NextTick();
+    if (next > tick) {
+      break;
+    }
+    now_ = next;
+
+    // 先从高到低下放到达边界的槽，下放后恰好在now_到期的会进入第0层当前槽
+    for (int level = kLevels - 1; level > 0; --level) {
+      int shift = level * kSlotBits;
+      if (now_ & ((uint64_t(1) << shift) - 1)) {
+        continue;
+      }
+      uint32_t slot = static_cast<uint32_t>(now_ >> shift) & (kSlots - 1);
+      if (!(occupied_[level] & (uint64_t(1) << slot))) {
+        continue;
+      }
+      uint32_t index = TakeBucket(level * kSlots + slot);
+      while (index != kNil) {
+        uint32_t next_index = nodes_[index].next;
+        Link(index);
+        index = next_index;
+      }
+    }
+
+    uint32_t slot = static_cast<uint32_t>(now_) & (kSlots - 1);
+    if (occupied_[0] & (uint64_t(1) << slot)) {
+      uint32_t index = TakeBucket(slot);
+      while (index != kNil) {
+        uint32_t next_index = nodes_[index].next;
+        assert(nodes_[index].expiry == now_);
+        expired->push_back(std::move(nodes_[index].task));
+        FreeNode(index);
+        index = next_index;
+      }
+    }
+  }
+  if (tick > now_) {
+    now_ = tick;
+  }
+}
+
+}   // namespace framework
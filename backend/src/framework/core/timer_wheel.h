@@ -0,0 +1,84 @@
+/*
+ * @Author: Nana5aki
+ * @Date: 2026-10-18 21:48:05
+ * @LastEditors: Nana5aki
+ * @LastEditTime: 2026-10-18 21:48:05
+ * @FilePath: \life_view\backend\src\framework\core\timer_wheel.h
+ */
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace framework {
+
+// 分层时间轮：6层，每层64个槽，第l层一个槽跨64^l个tick，共覆盖2^36个tick，
+// 更远的定时器先放在最高层，下放时重新计算。插入和取消O(1)；
+// 推进时按位图跳过空槽，每个定时器最多被下放6次。不是线程安全的
+class TimerWheel {
+public:
+  using TimerId = uint64_t;
+  using Task = std::function<void()>;
+
+  static constexpr TimerId kInvalidTimer = 0;
+  static constexpr uint64_t kNever = UINT64_MAX;
+
+  explicit TimerWheel(uint64_t now_tick = 0);
+
+  TimerWheel(const TimerWheel&) = delete;
+  TimerWheel& operator=(const TimerWheel&) = delete;
+
+  // 不晚于当前tick的定时器在下一个tick到期
+  TimerId Insert(uint64_t expiry_tick, Task task);
+  // 已到期或已取消时返回false
+  bool Cancel(TimerId id);
+
+  // 推进到tick，到期的任务按到期时间顺序追加到expired，由调用方执行
+  void Advance(uint64_t tick, std::vector<Task>* expired);
+
+  // 下一次需要推进到的tick：最早的到期时间或某一层的下放时间，不会晚于最早的到期时间。
+  // 没有定时器时返回kNever
+  uint64_t NextTick() const;
+
+  uint64_t Now() const {
+    return now_;
+  }
+  size_t Size() const {
+    return size_;
+  }
+
+private:
+  static constexpr int kLevels = 6;
+  static constexpr int kSlotBits = 6;
+  static constexpr uint32_t kSlots = 1u << kSlotBits;
+  static constexpr uint32_t kNil = UINT32_MAX;
+
+  struct Node {
+    uint64_t expiry = 0;
+    uint32_t prev = kNil;
+    uint32_t next = kNil;
+    // 节点复用时自增，使旧的TimerId失效
+    uint32_t generation = 0;
+    // level * kSlots + slot，空闲节点为kNil
+    uint32_t bucket = kNil;
+    Task task;
+  };
+
+  void Link(uint32_t index);
+  void Unlink(uint32_t index);
+  // 取下整个槽的链表，返回表头
+  uint32_t TakeBucket(uint32_t bucket);
+  void FreeNode(uint32_t index);
+
+private:
+  std::vector<Node> nodes_;
+  std::vector<uint32_t> free_nodes_;
+  uint32_t heads_[kLevels * kSlots];
+  // 每层非空槽的位图
+  uint64_t occupied_[kLevels] = {};
+  uint64_t now_;
+  size_t size_ = 0;
+};
+
+}   // namespace framework
@@ -0,0 +1,242 @@
+/*
+ * @Author: Nana5aki
+ * @Date: 2026-10-18 22:58:12
+ * @LastEditors: Nana5aki
+ * @LastEditTime: 2026-10-18 22:58:12
+ * @FilePath: \life_view\backend\src\framework\mvvm\command_trace.cc
+ */
+#include "command_trace.h"
+#include "variant_codec.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unordered_map>
+
+namespace framework {
+
+namespace {
+
+constexpr char kTraceMagic[] = "LVTRACE1";
+constexpr size_t kMagicSize = sizeof(kTraceMagic) - 1;
+// 缓冲区超过这个大小或距上次写入超过kFlushInterval时写入文件，进程被强制结束时最多丢失这么多
+constexpr size_t kFlushBytes = 64 * 1024;
+constexpr std::chrono::seconds kFlushInterval(1);
+
+struct Recorder {
+  FILE* file = nullptr;
+  bool record_values = false;
+  std::chrono::steady_clock::time_point start;
+  std::chrono::steady_clock::time_point last_flush;
+  std::string buffer;
+  std::unordered_map<const ViewModel*, uint64_t> instances;
+  uint64_t next_instance = 1;
+};
+
+Recorder& GetRecorder() {
+  static Recorder recorder;
+  return recorder;
+}
+
+void Flush(Recorder& recorder) {
+  if (!recorder.buffer.empty()) {
+    fwrite(recorder.buffer.data(), 1, recorder.buffer.size(), recorder.file);
+    fflush(recorder.file);
+    recorder.buffer.clear();
+  }
+  recorder.last_flush = std::chrono::steady_clock::now();
+}
+
+void WriteString(const std::string& text, std::string* out) {
+  WriteVarint(text.size(), out);
+  out->append(text);
+}
+
+// 开始录制前创建的ViewModel第一次出现时分配序号，类型未知
+uint64_t InstanceOf(Recorder& recorder, const ViewModel* viewmodel) {
+  auto it = recorder.instances.find(viewmodel);
+  if (it != recorder.instances.end()) {
+    return it->second;
+  }
+  uint64_t instance = recorder.next_instance++;
+  recorder.instances.emplace(viewmodel, instance);
+  return instance;
+}
+
+void BeginRecord(Recorder& recorder, TraceRecordType type, uint64_t time_us, uint64_t instance) {
+  recorder.buffer.push_back(static_cast<char>(type));
+  WriteVarint(time_us, &recorder.buffer);
+  WriteVarint(instance, &recorder.buffer);
+}
+
+void EndRecord(Recorder& recorder) {
+  if (recorder.buffer.size() >= kFlushBytes ||
+      std::chrono::steady_clock::now() - recorder.last_flush >= kFlushInterval) {
+    Flush(recorder);
+  }
+}
+
+bool ReadString(const uint8_t* data, size_t size, size_t* offset, std::string* text) {
+  uint64_t length;
+  if (!ReadVarint(data, size, offset, &length) || length > size - *offset) {
+    return false;
+  }
+  text->assign(reinterpret_cast<const char*>(data + *offset), static_cast<size_t>(length));
+  *offset += static_cast<size_t>(length);
+  return true;
+}
+
+}   // namespace
+
+bool CommandTrace::enabled_ = false;
+
+bool CommandTrace::Start(const std::string& path, bool record_values, std::string* error) {
+  Stop();
+  Recorder& recorder = GetRecorder();
+  recorder.file = fopen(path.c_str(), "wb");
+  if (!recorder.file) {
+    if (error) {
+      *error = "cannot open trace file: " + path;
+    }
+    return false;
+  }
+  recorder.record_values = record_values;
+  recorder.start = std::chrono::steady_clock::now();
+  recorder.last_flush = recorder.start;
+  recorder.buffer.assign(kTraceMagic, kMagicSize);
+  recorder.instances.clear();
+  recorder.next_instance = 1;
+  enabled_ = true;
+
+  static bool exit_hooked = false;
+  if (!exit_hooked) {
+    exit_hooked = true;
+    std::atexit([]() { CommandTrace::Stop(); });
+  }
+  return true;
+}
+
+void CommandTrace::Stop() {
+  if (!enabled_) {
+    return;
+  }
+  Recorder& recorder = GetRecorder();
+  Flush(recorder);
+  fclose(recorder.file);
+  recorder.file = nullptr;
+  recorder.instances.clear();
+  enabled_ = false;
+}
+
+uint64_t CommandTrace::Now() {
+  return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+                                 std::chrono::steady_clock::now() - GetRecorder().start)
+                                 .count());
+}
+
+void CommandTrace::RecordCreate(const ViewModel* viewmodel, const std::string& type) {
+  if (!enabled_) {
+    return;
+  }
+  Recorder& recorder = GetRecorder();
+  // 构造函数中的SetProp已经分配过序号时沿用，否则构造期间的属性变化记到不存在的实例上
+  BeginRecord(recorder, TraceRecordType::Create, Now(), InstanceOf(recorder, viewmodel));
+  WriteString(type, &recorder.buffer);
+  EndRecord(recorder);
+}
+
+void CommandTrace::Forget(const ViewModel* viewmodel) {
+  if (!enabled_) {
+    return;
+  }
+  GetRecorder().instances.erase(viewmodel);
+}
+
+void CommandTrace::RecordCommand(const ViewModel* viewmodel, const std::string& name,
+                                 const Variant* params, uint64_t start_us) {
+  if (!enabled_) {
+    return;
+  }
+  Recorder& recorder = GetRecorder();
+  uint64_t end_us = Now();
+  BeginRecord(recorder, TraceRecordType::Command, start_us, InstanceOf(recorder, viewmodel));
+  WriteVarint(end_us - start_us, &recorder.buffer);
+  WriteString(name, &recorder.buffer);
+  recorder.buffer.push_back(params ? 1 : 0);
+  if (params) {
+    EncodeVariant(*params, &recorder.buffer);
+  }
+  EndRecord(recorder);
+}
+
+void CommandTrace::RecordPropChanged(const ViewModel* viewmodel, const std::string& name,
+                                     const Variant& value) {
+  if (!enabled_) {
+    return;
+  }
+  Recorder& recorder = GetRecorder();
+  BeginRecord(recorder, TraceRecordType::PropChanged, Now(), InstanceOf(recorder, viewmodel));
+  WriteString(name, &recorder.buffer);
+  recorder.buffer.push_back(recorder.record_values ? 1 : 0);
+  if (recorder.record_values) {
+    EncodeVariant(value, &recorder.buffer);
+  }
+  EndRecord(recorder);
+}
+
+bool TraceReader::Open(const std::string& path, std::string* error) {
+  if (!file_.Open(path, error)) {
+    return false;
+  }
+  if (file_.Size() < kMagicSize || memcmp(file_.Data(), kTraceMagic, kMagicSize) != 0) {
+    *error = "not a trace file: " + path;
+    return false;
+  }
+  offset_ = kMagicSize;
+  return true;
+}
+
+bool TraceReader::Next(TraceRecord* record, std::string* error) {
+  error->clear();
+  const uint8_t* data = reinterpret_cast<const uint8_t*>(file_.Data());
+  size_t size = file_.Size();
+  if (offset_ >= size) {
+    return false;
+  }
+
+  size_t offset = offset_;
+  uint8_t type = data[offset++];
+  bool ok = ReadVarint(data, size, &offset, &record->time_us) &&
+            ReadVarint(data, size, &offset, &record->instance);
+  record->duration_us = 0;
+  record->has_value = false;
+  record->value = Variant();
+  switch (static_cast<TraceRecordType>(type)) {
+  case TraceRecordType::Create:
+    ok = ok && ReadString(data, size, &offset, &record->name);
+    break;
+  case TraceRecordType::Command:
+  case TraceRecordType::PropChanged:
+    if (type == static_cast<uint8_t>(TraceRecordType::Command)) {
+      ok = ok && ReadVarint(data, size, &offset, &record->duration_us);
+    }
+    ok = ok && ReadString(data, size, &offset, &record->name) && offset < size;
+    if (ok) {
+      record->has_value = data[offset++] != 0;
+      ok = !record->has_value || DecodeVariant(data, size, &offset, &record->value);
+    }
+    break;
+  default:
+    ok = false;
+  }
+  if (!ok) {
+    // 录制进程异常退出时最后一条记录可能不完整
+    *error = "corrupt trace record at offset " + std::to_string(offset_);
+    return false;
+  }
+  record->type = static_cast<TraceRecordType>(type);
+  offset_ = offset;
+  return true;
+}
+
+}   // namespace framework
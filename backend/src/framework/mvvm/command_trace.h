@@ -0,0 +1,83 @@
+/*
+ * @Author: Nana5aki
+ * @Date: 2026-10-18 22:58:12
+ * @LastEditors: Nana5aki
+ * @LastEditTime: 2026-10-18 22:58:12
+ * @FilePath: \life_view\backend\src\framework\mvvm\command_trace.h
+ */
+#pragma once
+
+#include "framework/core/mapped_file.h"
+#include "variant.h"
+#include <cstdint>
+#include <string>
+
+namespace framework {
+
+class ViewModel;
+
+// 命令流录制文件，用于无界面回放(tools/replay)。整数均为小端，varint为LEB128：
+//   文件头 "LVTRACE1"
+//   每条记录: u8类型 + varint距开始的微秒数 + varint ViewModel序号 + 各类型字段
+//     1 Create       type: 字符串
+//     2 Command      duration_us: varint, name: 字符串, has_param: u8, [param]
+//     3 PropChanged  name: 字符串, has_value: u8, [value]
+//   字符串为varint字节数 + UTF-8，值为variant_codec编码
+enum class TraceRecordType : uint8_t {
+  Create = 1,
+  Command,
+  PropChanged,
+};
+
+struct TraceRecord {
+  TraceRecordType type = TraceRecordType::Create;
+  uint64_t time_us = 0;
+  uint64_t instance = 0;
+  uint64_t duration_us = 0;
+  // Create为ViewModel类型，Command为命令名，PropChanged为属性名
+  std::string name;
+  bool has_value = false;
+  Variant value;
+};
+
+// 录制。只能在主线程使用，未开启时各Record调用只有一次判断
+class CommandTrace {
+public:
+  // record_values为false时属性变化只记录属性名，文件小很多
+  static bool Start(const std::string& path, bool record_values, std::string* error);
+  static void Stop();
+
+  static bool Enabled() {
+    return enabled_;
+  }
+
+  // 录制时钟，微秒
+  static uint64_t Now();
+
+  static void RecordCreate(const ViewModel* viewmodel, const std::string& type);
+  // ViewModel析构时调用，地址之后可能被新的ViewModel复用，不能沿用旧序号
+  static void Forget(const ViewModel* viewmodel);
+  // start_us为命令开始执行时的Now()
+  static void RecordCommand(const ViewModel* viewmodel, const std::string& name,
+                            const Variant* params, uint64_t start_us);
+  static void RecordPropChanged(const ViewModel* viewmodel, const std::string& name,
+                                const Variant& value);
+
+private:
+  static bool enabled_;
+};
+
+// 顺序读取录制文件
+class TraceReader {
+public:
+  bool Open(const std::string& path, std::string* error);
+
+  // 读到结尾返回false且error为空；文件损坏时返回false并写入error
+  bool Next(TraceRecord* record, std::string* error);
+
+private:
+  MappedFile file_;
+  size_t offset_ = 0;
+};
+
+}   // namespace framework
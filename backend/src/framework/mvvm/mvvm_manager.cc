@@ -6,6 +6,9 @@
  * @FilePath: \life_view\backend\src\framework\mvvm\mvvm_manager.cc
  */
 #include "mvvm_manager.h"
+#include "command_trace.h"
+#include "framework/core/main_thread.h"
+#include <algorithm>
 #include <iostream>
 #include <sstream>
 
@@ -27,6 +30,8 @@ std::shared_ptr<framework::ViewModel> MVVMManager::createViewModel(
     std::cerr << "Failed to create ViewModel: " << viewmodel_type << std::endl;
     return nullptr;
   }
+  viewmodels_.push_back({viewmodel, viewmodel_type});
+  framework::CommandTrace::RecordCreate(viewmodel.get(), viewmodel_type);
   return viewmodel;
 }
 
@@ -35,4 +40,113 @@ void MVVMManager::registerViewModelFactory(
   std::function<std::shared_ptr<framework::ViewModel>()> factory) {
   viewmodel_factories_[viewmodel_type] = factory;
   std::cout << "ViewModel factory registered: " << viewmodel_type << std::endl;
-}
\ No newline at end of file
+}
+
+std::vector<std::shared_ptr<framework::ViewModel>> MVVMManager::getViewModels() {
+  viewmodels_.erase(
+    std::remove_if(viewmodels_.begin(),
+                   viewmodels_.end(),
+                   [](const ViewModelEntry& entry) { return entry.viewmodel.expired(); }),
+    viewmodels_.end());
+  std::vector<std::shared_ptr<framework::ViewModel>> alive;
+  alive.reserve(viewmodels_.size());
+  for (const auto& entry : viewmodels_) {
+    alive.push_back(entry.viewmodel.lock());
+  }
+  return alive;
+}
+
+void MVVMManager::setMemoryBudget(size_t bytes) {
+  memory_budget_ = bytes;
+  if (bytes == 0) {
+    framework::ViewModel::SetMemoryGrowthListener(nullptr);
+    return;
+  }
+  // 写入时只投递检查，不在SetProp的调用栈里换出
+  framework::ViewModel::SetMemoryGrowthListener([this]() {
+    if (enforce_scheduled_) {
+      return;
+    }
+    enforce_scheduled_ = true;
+    framework::MainThread::Post([this]() {
+      enforce_scheduled_ = false;
+      enforceMemoryBudget();
+    });
+  });
+  enforceMemoryBudget();
+}
+
+size_t MVVMManager::enforceMemoryBudget() {
+  if (memory_budget_ == 0) {
+    return 0;
+  }
+  auto viewmodels = getViewModels();
+  size_t resident = 0;
+  for (const auto& viewmodel : viewmodels) {
+    resident += viewmodel->GetMemoryUsage().resident_bytes;
+  }
+  if (resident <= memory_budget_) {
+    return 0;
+  }
+
+  struct Candidate {
+    uint64_t last_access;
+    size_t bytes;
+    framework::ViewModel* viewmodel;
+    const std::string* name;
+  };
+  // 小属性换出省下的内存不值一次文件读写
+  constexpr size_t kMinSpillBytes = 1024;
+  std::vector<Candidate> candidates;
+  for (const auto& viewmodel : viewmodels) {
+    // 发布快照的ViewModel换出也释放不了内存(快照仍持有值)，整体计为常驻
+    if (viewmodel->ConcurrentReadsEnabled()) {
+      continue;
+    }
+    for (const auto& [name, memory] : viewmodel->GetPropMemory()) {
+      if (!memory.spilled && memory.bytes >= kMinSpillBytes &&
+          !viewmodel->IsPropSubscribed(name)) {
+        candidates.push_back({memory.last_access, memory.bytes, viewmodel.get(), &name});
+      }
+    }
+  }
+  std::sort(candidates.begin(), candidates.end(),
+            [](const Candidate& a, const Candidate& b) { return a.last_access < b.last_access; });
+
+  size_t target = memory_budget_ / 10 * 9;
+  size_t spilled = 0;
+  for (const auto& candidate : candidates) {
+    if (resident <= target) {
+      break;
+    }
+    size_t before = candidate.viewmodel->GetMemoryUsage().resident_bytes;
+    // name指向prop_memory_的键，SpillProp不增删节点，换出过程中保持有效
+    if (candidate.viewmodel->SpillProp(*candidate.name)) {
+      resident -= before - candidate.viewmodel->GetMemoryUsage().resident_bytes;
+      ++spilled;
+    }
+  }
+  if (resident > memory_budget_) {
+    std::cerr << "MVVM memory budget exceeded: " << resident << " > " << memory_budget_
+              << " bytes after spilling " << spilled << " properties" << std::endl;
+  }
+  return spilled;
+}
+
+bool MVVMManager::startTrace(const std::string& path, bool record_values, std::string* error) {
+  if (!framework::CommandTrace::Start(path, record_values, error)) {
+    return false;
+  }
+  // 回放时按类型重新创建，录制开始前的状态不会还原
+  getViewModels();
+  for (const auto& entry : viewmodels_) {
+    if (auto viewmodel = entry.viewmodel.lock()) {
+      framework::CommandTrace::RecordCreate(viewmodel.get(), entry.type);
+    }
+  }
+  return true;
+}
+
+void MVVMManager::stopTrace() {
+  framework::CommandTrace::Stop();
+}
@@ -11,7 +11,8 @@
 #include <functional>
 #include <map>
 #include <memory>
-#include <napi.h>
+#include <string>
+#include <vector>
 
 class MVVMManager {
 public:
@@ -27,6 +28,25 @@ public:
   void registerViewModelFactory(const std::string& viewmodel_type,
                                 std::function<std::shared_ptr<framework::ViewModel>()> factory);
 
+  // 当前存活的ViewModel，已销毁的在这里顺带清理
+  std::vector<std::shared_ptr<framework::ViewModel>> getViewModels();
+
+  // 所有ViewModel属性的常驻内存上限(字节)，0表示不限制。
+  // 超出后把最久未访问、没有属性监听的属性换出到临时文件，降到上限的90%为止。
+  // 只换出属性，不驱逐整个ViewModel：ViewModel由界面持有，生命周期跟随界面，
+  // 不再使用的ViewModel的全部属性自然最冷，会被先换出，留下的只有键和空指针
+  void setMemoryBudget(size_t bytes);
+  size_t getMemoryBudget() const {
+    return memory_budget_;
+  }
+
+  // 立即按预算换出，返回换出的属性数
+  size_t enforceMemoryBudget();
+
+  // 录制命令流(见command_trace.h)，已存在的ViewModel先各记一条Create
+  bool startTrace(const std::string& path, bool record_values, std::string* error);
+  void stopTrace();
+
 private:
   MVVMManager() = default;
 
@@ -34,4 +54,12 @@ private:
   static MVVMManager* instance_;
   std::map<std::string, std::function<std::shared_ptr<framework::ViewModel>()>>
     viewmodel_factories_;
+  struct ViewModelEntry {
+    std::weak_ptr<framework::ViewModel> viewmodel;
+    std::string type;
+  };
+  std::vector<ViewModelEntry> viewmodels_;
+  size_t memory_budget_ = 0;
+  // 已投递检查任务，同一轮内的多次增长只检查一次
+  bool enforce_scheduled_ = false;
 };
\ No newline at end of file
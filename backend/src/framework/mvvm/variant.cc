@@ -62,6 +62,11 @@ Variant::Variant(const std::string& val)
   data_.string_ptr = new std::string(val);
 }
 
+Variant::Variant(std::string&& val)
+  : type_(VariantType::String) {
+  data_.string_ptr = new std::string(std::move(val));
+}
+
 Variant::Variant(const char* val)
   : type_(VariantType::String) {
   data_.string_ptr = new std::string(val);
@@ -72,11 +77,21 @@ Variant::Variant(const VariantArray& val)
   data_.array_ptr = new VariantArray(val);
 }
 
+Variant::Variant(VariantArray&& val)
+  : type_(VariantType::Array) {
+  data_.array_ptr = new VariantArray(std::move(val));
+}
+
 Variant::Variant(const VariantMap& val)
   : type_(VariantType::Map) {
   data_.map_ptr = new VariantMap(val);
 }
 
+Variant::Variant(VariantMap&& val)
+  : type_(VariantType::Map) {
+  data_.map_ptr = new VariantMap(std::move(val));
+}
+
 // 拷贝构造
 Variant::Variant(const Variant& other)
   : type_(VariantType::Null) {
@@ -159,6 +174,34 @@ const VariantMap Variant::AsMap() const {
   return *data_.map_ptr;
 }
 
+// 只读引用
+const std::string& Variant::StringRef() const {
+  if (type_ != VariantType::String) {
+    assert(false && "Not a string");
+    static const std::string empty;
+    return empty;
+  }
+  return *data_.string_ptr;
+}
+
+const VariantArray& Variant::ArrayRef() const {
+  if (type_ != VariantType::Array) {
+    assert(false && "Not an array");
+    static const VariantArray empty;
+    return empty;
+  }
+  return *data_.array_ptr;
+}
+
+const VariantMap& Variant::MapRef() const {
+  if (type_ != VariantType::Map) {
+    assert(false && "Not a map");
+    static const VariantMap empty;
+    return empty;
+  }
+  return *data_.map_ptr;
+}
+
 // 获取可修改引用
 VariantArray& Variant::GetArray() {
   if (type_ != VariantType::Array) {
@@ -183,13 +226,18 @@ VariantMap& Variant::GetMap() {
 // 数组操作
 void Variant::Push(const Variant& val) {
   GetArray().push_back(val);
+  MarkModified();
 }
 
 Variant& Variant::At(size_t index) {
   if (!IsArray()) {
     assert(false && "not a array");
-    return Variant(VariantType::Null);
+    static Variant null_variant;
+    null_variant = Variant();
+    return null_variant;
   }
+  // 返回可修改引用，调用方可能修改子元素，缓存的哈希直接失效
+  MarkModified();
   auto& arr = GetArray();
   if (index >= arr.size()) {
     arr.resize(index + 1);
@@ -208,10 +256,18 @@ size_t Variant::ArraySize() const {
 // 对象操作
 void Variant::Set(const std::string& key, const Variant& val) {
   GetMap()[key] = val;
+  MarkModified();
 }
 
 const Variant& Variant::Get(const std::string& key) {
-  return GetMap()[key];
+  auto& map = GetMap();
+  auto it = map.find(key);
+  if (it != map.end()) {
+    return it->second;
+  }
+  // 不存在时插入Null
+  MarkModified();
+  return map[key];
 }
 
 bool Variant::Has(const std::string& key) const {
@@ -222,6 +278,175 @@ bool Variant::Has(const std::string& key) const {
   return data_.map_ptr != nullptr && data_.map_ptr->find(key) != data_.map_ptr->end();
 }
 
+const Variant* Variant::Find(const std::string& key) const {
+  if (!IsMap()) {
+    return nullptr;
+  }
+  auto it = data_.map_ptr->find(key);
+  return it != data_.map_ptr->end() ? &it->second : nullptr;
+}
+
+// 结构哈希
+namespace {
+
+constexpr uint64_t kHashMul = 0x9E3779B97F4A7C15ULL;
+
+uint64_t Mix(uint64_t h, uint64_t v) {
+  h ^= v + kHashMul + (h << 6) + (h >> 2);
+  h *= 0xBF58476D1CE4E5B9ULL;
+  return h ^ (h >> 31);
+}
+
+uint64_t HashBytes(const char* data, size_t size) {
+  uint64_t h = Mix(kHashMul, size);
+  size_t i = 0;
+  for (; i + 8 <= size; i += 8) {
+    uint64_t word;
+    memcpy(&word, data + i, 8);
+    h = Mix(h, word);
+  }
+  uint64_t tail = 0;
+  memcpy(&tail, data + i, size - i);
+  return Mix(h, tail);
+}
+
+}   // namespace
+
+uint64_t Variant::Hash() const {
+  if (hash_valid_) {
+    return hash_;
+  }
+  uint64_t h = Mix(kHashMul, static_cast<uint64_t>(type_));
+  switch (type_) {
+  case VariantType::Null:
+    break;
+  case VariantType::Bool:
+    h = Mix(h, data_.bool_val ? 1 : 0);
+    break;
+  case VariantType::Int:
+    h = Mix(h, static_cast<uint64_t>(static_cast<int64_t>(data_.int_val)));
+    break;
+  case VariantType::Double: {
+    uint64_t bits;
+    memcpy(&bits, &data_.double_val, sizeof(bits));
+    h = Mix(h, bits);
+    break;
+  }
+  case VariantType::String:
+    h = Mix(h, HashBytes(data_.string_ptr->data(), data_.string_ptr->size()));
+    break;
+  case VariantType::Array:
+    for (const auto& item : *data_.array_ptr) {
+      h = Mix(h, item.Hash());
+    }
+    break;
+  case VariantType::Map:
+    for (const auto& [key, item] : *data_.map_ptr) {
+      h = Mix(h, HashBytes(key.data(), key.size()));
+      h = Mix(h, item.Hash());
+    }
+    break;
+  }
+  hash_ = h;
+  hash_valid_ = true;
+  return h;
+}
+
+bool Variant::operator==(const Variant& other) const {
+  if (this == &other) {
+    return true;
+  }
+  if (type_ != other.type_) {
+    return false;
+  }
+  if (hash_valid_ && other.hash_valid_ && hash_ != other.hash_) {
+    return false;
+  }
+  switch (type_) {
+  case VariantType::Null:
+    return true;
+  case VariantType::Bool:
+    return data_.bool_val == other.data_.bool_val;
+  case VariantType::Int:
+    return data_.int_val == other.data_.int_val;
+  case VariantType::Double:
+    return memcmp(&data_.double_val, &other.data_.double_val, sizeof(double)) == 0;
+  case VariantType::String:
+    return *data_.string_ptr == *other.data_.string_ptr;
+  case VariantType::Array:
+    return *data_.array_ptr == *other.data_.array_ptr;
+  case VariantType::Map:
+    return *data_.map_ptr == *other.data_.map_ptr;
+  }
+  return false;
+}
+
+namespace {
+
+// libstdc++/libc++/MSVC的红黑树节点头均为颜色+3个指针，按4个指针估算
+constexpr size_t kMapNodeHeader = 4 * sizeof(void*);
+
+// 字符串缓冲区在对象内(SSO)时不占堆内存
+size_t StringHeapSize(const std::string& str) {
+  const char* data = str.data();
+  const char* object = reinterpret_cast<const char*>(&str);
+  if (data >= object && data < object + sizeof(std::string)) {
+    return 0;
+  }
+  return str.capacity() + 1;
+}
+
+}   // namespace
+
+size_t Variant::MapEntryOverhead(const std::string& key) {
+  return kMapNodeHeader + sizeof(VariantMap::value_type) - sizeof(Variant) + StringHeapSize(key);
+}
+
+size_t Variant::ShallowSize() const {
+  size_t size = sizeof(Variant);
+  switch (type_) {
+  case VariantType::String:
+    size += sizeof(std::string) + StringHeapSize(*data_.string_ptr);
+    break;
+  case VariantType::Array:
+    size += sizeof(VariantArray) + data_.array_ptr->capacity() * sizeof(Variant);
+    break;
+  case VariantType::Map:
+    size += sizeof(VariantMap);
+    for (const auto& item : *data_.map_ptr) {
+      size += MapEntryOverhead(item.first) + sizeof(Variant);
+    }
+    break;
+  default:
+    break;
+  }
+  return size;
+}
+
+size_t Variant::DeepSize() const {
+  size_t size = ShallowSize();
+  // 子元素对象本身已按槽位计入，这里只加它们各自的堆内存
+  switch (type_) {
+  case VariantType::Array:
+    for (const auto& item : *data_.array_ptr) {
+      if (item.type_ >= VariantType::String) {
+        size += item.DeepSize() - sizeof(Variant);
+      }
+    }
+    break;
+  case VariantType::Map:
+    for (const auto& item : *data_.map_ptr) {
+      if (item.second.type_ >= VariantType::String) {
+        size += item.second.DeepSize() - sizeof(Variant);
+      }
+    }
+    break;
+  default:
+    break;
+  }
+  return size;
+}
+
 // 辅助方法
 void Variant::Clear() {
   switch (type_) {
@@ -239,10 +464,14 @@ void Variant::Clear() {
   }
   type_ = VariantType::Null;
   memset(&data_, 0, sizeof(data_));
+  hash_valid_ = false;
 }
 
 void Variant::CopyFrom(const Variant& other) {
   type_ = other.type_;
+  // 内容相同，哈希缓存可以直接沿用
+  hash_valid_ = other.hash_valid_;
+  hash_ = other.hash_;
 
   switch (type_) {
   case VariantType::Null:
@@ -271,9 +500,12 @@ void Variant::CopyFrom(const Variant& other) {
 void Variant::MoveFrom(Variant&& other) {
   type_ = other.type_;
   data_ = other.data_;
+  hash_valid_ = other.hash_valid_;
+  hash_ = other.hash_;
 
   other.type_ = VariantType::Null;
   memset(&other.data_, 0, sizeof(other.data_));
+  other.MarkModified();
 }
 
 }   // namespace framework
\ No newline at end of file
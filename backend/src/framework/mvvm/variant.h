@@ -7,6 +7,7 @@
  */
 #pragma once
 
+#include <cstdint>
 #include <cstring>
 #include <iostream>
 #include <map>
@@ -32,9 +33,12 @@ public:
   Variant(int val);
   Variant(double val);
   Variant(const std::string& val);
+  Variant(std::string&& val);
   Variant(const char* val);
   Variant(const VariantArray& val);
+  Variant(VariantArray&& val);
   Variant(const VariantMap& val);
+  Variant(VariantMap&& val);
 
   // 拷贝构造和赋值
   Variant(const Variant& other);
@@ -81,6 +85,11 @@ public:
   const VariantArray AsArray() const;
   const VariantMap AsMap() const;
 
+  // 只读引用访问，避免AsXxx的拷贝
+  const std::string& StringRef() const;
+  const VariantArray& ArrayRef() const;
+  const VariantMap& MapRef() const;
+
   // 数组操作
   void Push(const Variant& val);
   Variant& At(size_t index);
@@ -90,8 +99,37 @@ public:
   void Set(const std::string& key, const Variant& val);
   const Variant& Get(const std::string& key);
   bool Has(const std::string& key) const;
+  // 不存在或不是map时返回nullptr
+  const Variant* Find(const std::string& key) const;
+
+  // 结构哈希：按类型和内容递归计算，结果缓存在各层节点上，修改时失效。
+  // 注意At()返回的子元素引用在父节点重新计算哈希前不能再被修改。
+  uint64_t Hash() const;
+  bool HashCached() const {
+    return hash_valid_;
+  }
+
+  // 结构相等。两边哈希都已缓存且不同时O(1)返回，否则逐层比较。
+  // Double按位比较，Int和Double即使数值相同也视为不同
+  bool operator==(const Variant& other) const;
+  bool operator!=(const Variant& other) const {
+    return !(*this == other);
+  }
+
+  // 内存占用(字节)，按实际分配计算，不含分配器自身的管理开销。
+  // ShallowSize: Variant对象本身 + 直接持有的堆内存(字符串缓冲区、数组元素槽、map节点和键)
+  // DeepSize:    再加上所有子元素各自持有的堆内存
+  size_t ShallowSize() const;
+  size_t DeepSize() const;
+
+  // map中一个节点除值本身以外的占用：红黑树节点头、键对象及键的堆内存
+  static size_t MapEntryOverhead(const std::string& key);
 
 private:
+  void MarkModified() {
+    hash_valid_ = false;
+  }
+
   // 获取可修改引用
   VariantArray& GetArray();
   VariantMap& GetMap();
@@ -103,6 +141,8 @@ private:
 
 private:
   VariantType type_;
+  mutable bool hash_valid_ = false;
+  mutable uint64_t hash_ = 0;
 
   // Union存储所有数据类型
   union Data {
@@ -0,0 +1,210 @@
+/*
+ * @Author: Nana5aki
+ * @Date: 2026-10-18 18:20:14
+ * @LastEditors: Nana5aki
+ * @LastEditTime: 2026-10-18 18:20:14
+ * @FilePath: \life_view\backend\src\framework\mvvm\variant_codec.cc
+ */
+#include "variant_codec.h"
+#include <cstring>
+#include <utility>
+
+namespace framework {
+
+namespace {
+
+constexpr int kMaxDepth = 1024;
+
+void AppendRaw(const void* data, size_t size, std::string* out) {
+  out->append(static_cast<const char*>(data), size);
+}
+
+// 按小端写入，大端平台逐字节翻转
+template <typename T>
+void AppendLittleEndian(T value, std::string* out) {
+  uint8_t bytes[sizeof(T)];
+  memcpy(bytes, &value, sizeof(T));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  for (size_t i = 0; i < sizeof(T) / 2; ++i) {
+    std::swap(bytes[i], bytes[sizeof(T) - 1 - i]);
+  }
+#endif
+  AppendRaw(bytes, sizeof(T), out);
+}
+
+template <typename T>
+T LoadLittleEndian(const uint8_t* data) {
+  uint8_t bytes[sizeof(T)];
+  memcpy(bytes, data, sizeof(T));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  for (size_t i = 0; i < sizeof(T) / 2; ++i) {
+    std::swap(bytes[i], bytes[sizeof(T) - 1 - i]);
+  }
+#endif
+  T value;
+  memcpy(&value, bytes, sizeof(T));
+  return value;
+}
+
+void AppendString(const std::string& text, std::string* out) {
+  WriteVarint(text.size(), out);
+  out->append(text);
+}
+
+bool ReadString(const uint8_t* data, size_t size, size_t* offset, std::string* text) {
+  uint64_t len = 0;
+  if (!ReadVarint(data, size, offset, &len) || len > size - *offset) {
+    return false;
+  }
+  text->assign(reinterpret_cast<const char*>(data + *offset), static_cast<size_t>(len));
+  *offset += static_cast<size_t>(len);
+  return true;
+}
+
+void Encode(const Variant& value, std::string* out) {
+  switch (value.GetType()) {
+  case VariantType::Null:
+    out->push_back(static_cast<char>(VariantTag::Null));
+    break;
+  case VariantType::Bool:
+    out->push_back(static_cast<char>(value.AsBool() ? VariantTag::True : VariantTag::False));
+    break;
+  case VariantType::Int:
+    out->push_back(static_cast<char>(VariantTag::Int));
+    AppendLittleEndian<int32_t>(value.AsInt(), out);
+    break;
+  case VariantType::Double:
+    out->push_back(static_cast<char>(VariantTag::Double));
+    AppendLittleEndian<double>(value.AsDouble(), out);
+    break;
+  case VariantType::String:
+    out->push_back(static_cast<char>(VariantTag::String));
+    AppendString(value.StringRef(), out);
+    break;
+  case VariantType::Array: {
+    const auto& arr = value.ArrayRef();
+    out->push_back(static_cast<char>(VariantTag::Array));
+    WriteVarint(arr.size(), out);
+    for (const auto& item : arr) {
+      Encode(item, out);
+    }
+    break;
+  }
+  case VariantType::Map: {
+    const auto& map = value.MapRef();
+    out->push_back(static_cast<char>(VariantTag::Map));
+    WriteVarint(map.size(), out);
+    for (const auto& [key, item] : map) {
+      AppendString(key, out);
+      Encode(item, out);
+    }
+    break;
+  }
+  }
+}
+
+bool Decode(const uint8_t* data, size_t size, size_t* offset, int depth, Variant* out) {
+  if (*offset >= size || depth > kMaxDepth) {
+    return false;
+  }
+  VariantTag tag = static_cast<VariantTag>(data[(*offset)++]);
+  switch (tag) {
+  case VariantTag::Null:
+    *out = Variant();
+    return true;
+  case VariantTag::False:
+  case VariantTag::True:
+    *out = Variant(tag == VariantTag::True);
+    return true;
+  case VariantTag::Int:
+    if (size - *offset < 4) {
+      return false;
+    }
+    *out = Variant(static_cast<int>(LoadLittleEndian<int32_t>(data + *offset)));
+    *offset += 4;
+    return true;
+  case VariantTag::Double:
+    if (size - *offset < 8) {
+      return false;
+    }
+    *out = Variant(LoadLittleEndian<double>(data + *offset));
+    *offset += 8;
+    return true;
+  case VariantTag::String: {
+    std::string text;
+    if (!ReadString(data, size, offset, &text)) {
+      return false;
+    }
+    *out = Variant(std::move(text));
+    return true;
+  }
+  case VariantTag::Array: {
+    uint64_t count = 0;
+    // 每个元素至少1字节，可以据此拒绝伪造的超大长度
+    if (!ReadVarint(data, size, offset, &count) || count > size - *offset) {
+      return false;
+    }
+    VariantArray arr(static_cast<size_t>(count));
+    for (auto& item : arr) {
+      if (!Decode(data, size, offset, depth + 1, &item)) {
+        return false;
+      }
+    }
+    *out = Variant(std::move(arr));
+    return true;
+  }
+  case VariantTag::Map: {
+    uint64_t count = 0;
+    if (!ReadVarint(data, size, offset, &count) || count > size - *offset) {
+      return false;
+    }
+    VariantMap map;
+    std::string key;
+    for (uint64_t i = 0; i < count; ++i) {
+      Variant item;
+      if (!ReadString(data, size, offset, &key) ||
+          !Decode(data, size, offset, depth + 1, &item)) {
+        return false;
+      }
+      // C++编码的键有序，hint总能命中；JS端按插入顺序编码时退化为普通插入
+      map.emplace_hint(map.end(), std::move(key), std::move(item));
+    }
+    *out = Variant(std::move(map));
+    return true;
+  }
+  }
+  return false;
+}
+
+}   // namespace
+
+void WriteVarint(uint64_t value, std::string* out) {
+  while (value >= 0x80) {
+    out->push_back(static_cast<char>((value & 0x7F) | 0x80));
+    value >>= 7;
+  }
+  out->push_back(static_cast<char>(value));
+}
+
+bool ReadVarint(const uint8_t* data, size_t size, size_t* offset, uint64_t* value) {
+  uint64_t result = 0;
+  for (int shift = 0; shift < 64 && *offset < size; shift += 7) {
+    uint8_t byte = data[(*offset)++];
+    result |= static_cast<uint64_t>(byte & 0x7F) << shift;
+    if (!(byte & 0x80)) {
+      *value = result;
+      return true;
+    }
+  }
+  return false;
+}
+
+void EncodeVariant(const Variant& value, std::string* out) {
+  Encode(value, out);
+}
+
+bool DecodeVariant(const uint8_t* data, size_t size, size_t* offset, Variant* out) {
+  return Decode(data, size, offset, 0, out);
+}
+
+}   // namespace framework
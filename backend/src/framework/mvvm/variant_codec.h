@@ -0,0 +1,44 @@
+/*
+ * @Author: Nana5aki
+ * @Date: 2026-10-18 18:20:14
+ * @LastEditors: Nana5aki
+ * @LastEditTime: 2026-10-18 18:20:14
+ * @FilePath: \life_view\backend\src\framework\mvvm\variant_codec.h
+ */
+#pragma once
+
+#include "variant.h"
+#include <cstdint>
+#include <string>
+
+namespace framework {
+
+// Variant二进制编码，用于跨线程传输（与src/preload/variant_codec.ts保持一致）。
+//
+// 每个值以1字节类型标记开头，整数均为小端：
+//   0 Null | 1 false | 2 true | 3 Int: int32 | 4 Double: float64
+//   5 String: varint字节数 + UTF-8
+//   6 Array:  varint元素数 + 元素
+//   7 Map:    varint键值对数 + (varint字节数 + 键 + 值)...
+enum class VariantTag : uint8_t {
+  Null = 0,
+  False,
+  True,
+  Int,
+  Double,
+  String,
+  Array,
+  Map,
+};
+
+// 编码结果追加到out
+void EncodeVariant(const Variant& value, std::string* out);
+
+// 从data[*offset]开始解码一个值，成功后*offset指向其后。数据不完整或非法时返回false
+bool DecodeVariant(const uint8_t* data, size_t size, size_t* offset, Variant* out);
+
+// LEB128无符号变长整数
+void WriteVarint(uint64_t value, std::string* out);
+bool ReadVarint(const uint8_t* data, size_t size, size_t* offset, uint64_t* value);
+
+}   // namespace framework
@@ -0,0 +1,1060 @@
+/*
+ * @Author: Nana5aki
+ * @Date: 2026-10-18 16:10:27
+ * @LastEditors: Nana5aki
+ * @LastEditTime: 2026-10-18 16:10:27
+ * @FilePath: \life_view\backend\src\framework\mvvm\variant_json.cc
+ */
+#include "variant_json.h"
+#include <charconv>
+#include <climits>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#  if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    define JSON_SIMD_X86 1
+#    include <immintrin.h>
+#    if defined(_MSC_VER) && !defined(__clang__)
+#      include <intrin.h>
+#      define JSON_TARGET_AVX2
+#    else
+#      define JSON_TARGET_AVX2 __attribute__((target("avx2")))
+#    endif
+#  endif
+#endif
+
+namespace framework {
+
+namespace {
+
+constexpr int kMaxDepth = 1024;
+
+//////////////////////////////////////////////////////////////////////////////
+// 第一步：块分类
+
+// 一个64字节块中各类字符的位掩码，第i位对应块内第i个字节
+struct BlockMasks {
+  uint64_t quote;
+  uint64_t backslash;
+  uint64_t op;           // { } [ ] : ,
+  uint64_t whitespace;   // 空格 \t \n \r
+};
+
+using ClassifyFn = void (*)(const uint8_t* block, BlockMasks* masks);
+
+void ClassifyScalar(const uint8_t* block, BlockMasks* masks) {
+  uint64_t quote = 0, backslash = 0, op = 0, whitespace = 0;
+  for (int i = 0; i < 64; ++i) {
+    uint64_t bit = 1ULL << i;
+    switch (block[i]) {
+    case '"':
+      quote |= bit;
+      break;
+    case '\\':
+      backslash |= bit;
+      break;
+    case '{':
+    case '}':
+    case '[':
+    case ']':
+    case ':':
+    case ',':
+      op |= bit;
+      break;
+    case ' ':
+    case '\t':
+    case '\n':
+    case '\r':
+      whitespace |= bit;
+      break;
+    default:
+      break;
+    }
+  }
+  masks->quote = quote;
+  masks->backslash = backslash;
+  masks->op = op;
+  masks->whitespace = whitespace;
+}
+
+#ifdef JSON_SIMD_X86
+
+void ClassifySse2(const uint8_t* block, BlockMasks* masks) {
+  const __m128i quote = _mm_set1_epi8('"');
+  const __m128i backslash = _mm_set1_epi8('\\');
+  const __m128i ops[6] = {_mm_set1_epi8('{'),
+                          _mm_set1_epi8('}'),
+                          _mm_set1_epi8('['),
+                          _mm_set1_epi8(']'),
+                          _mm_set1_epi8(':'),
+                          _mm_set1_epi8(',')};
+  const __m128i spaces[4] = {
+    _mm_set1_epi8(' '), _mm_set1_epi8('\t'), _mm_set1_epi8('\n'), _mm_set1_epi8('\r')};
+
+  BlockMasks result = {0, 0, 0, 0};
+  for (int k = 0; k < 4; ++k) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + k * 16));
+    __m128i op = _mm_cmpeq_epi8(v, ops[0]);
+    for (int i = 1; i < 6; ++i) {
+      op = _mm_or_si128(op, _mm_cmpeq_epi8(v, ops[i]));
+    }
+    __m128i ws = _mm_cmpeq_epi8(v, spaces[0]);
+    for (int i = 1; i < 4; ++i) {
+      ws = _mm_or_si128(ws, _mm_cmpeq_epi8(v, spaces[i]));
+    }
+    const int shift = k * 16;
+    result.quote |=
+      static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, quote))))
+      << shift;
+    result.backslash |= static_cast<uint64_t>(
+                          static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, backslash))))
+                        << shift;
+    result.op |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(op))) << shift;
+    result.whitespace |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(ws)))
+                         << shift;
+  }
+  *masks = result;
+}
+
+JSON_TARGET_AVX2 void ClassifyAvx2(const uint8_t* block, BlockMasks* masks) {
+  const __m256i quote = _mm256_set1_epi8('"');
+  const __m256i backslash = _mm256_set1_epi8('\\');
+  const __m256i ops[6] = {_mm256_set1_epi8('{'),
+                          _mm256_set1_epi8('}'),
+                          _mm256_set1_epi8('['),
+                          _mm256_set1_epi8(']'),
+                          _mm256_set1_epi8(':'),
+                          _mm256_set1_epi8(',')};
+  const __m256i spaces[4] = {
+    _mm256_set1_epi8(' '), _mm256_set1_epi8('\t'), _mm256_set1_epi8('\n'), _mm256_set1_epi8('\r')};
+
+  BlockMasks result = {0, 0, 0, 0};
+  for (int k = 0; k < 2; ++k) {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + k * 32));
+    __m256i op = _mm256_cmpeq_epi8(v, ops[0]);
+    for (int i = 1; i < 6; ++i) {
+      op = _mm256_or_si256(op, _mm256_cmpeq_epi8(v, ops[i]));
+    }
+    __m256i ws = _mm256_cmpeq_epi8(v, spaces[0]);
+    for (int i = 1; i < 4; ++i) {
+      ws = _mm256_or_si256(ws, _mm256_cmpeq_epi8(v, spaces[i]));
+    }
+    const int shift = k * 32;
+    result.quote |= static_cast<uint64_t>(static_cast<uint32_t>(
+                      _mm256_movemask_epi8(_mm256_cmpeq_epi8(v, quote))))
+                    << shift;
+    result.backslash |= static_cast<uint64_t>(static_cast<uint32_t>(
+                          _mm256_movemask_epi8(_mm256_cmpeq_epi8(v, backslash))))
+                        << shift;
+    result.op |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(op))) << shift;
+    result.whitespace |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(ws)))
+                         << shift;
+  }
+  *masks = result;
+}
+
+bool CpuHasAvx2() {
+#  if defined(_MSC_VER) && !defined(__clang__)
+  int info[4];
+  __cpuid(info, 0);
+  if (info[0] < 7) {
+    return false;
+  }
+  __cpuid(info, 1);
+  // OSXSAVE且系统开启了YMM状态保存
+  bool os_avx = (info[2] & (1 << 27)) != 0 && (_xgetbv(0) & 0x6) == 0x6;
+  __cpuidex(info, 7, 0);
+  return os_avx && (info[1] & (1 << 5)) != 0;
+#  else
+  return __builtin_cpu_supports("avx2");
+#  endif
+}
+
+#endif   // JSON_SIMD_X86
+
+struct Classifier {
+  ClassifyFn fn;
+  const char* name;
+};
+
+// 本机可用的实现，按优先顺序排列，最后一个总是标量实现
+const std::vector<Classifier>& AvailableClassifiers() {
+  static const std::vector<Classifier> classifiers = []() {
+    std::vector<Classifier> result;
+#ifdef JSON_SIMD_X86
+    if (CpuHasAvx2()) {
+      result.push_back({ClassifyAvx2, "avx2"});
+    }
+    result.push_back({ClassifySse2, "sse2"});
+#endif
+    result.push_back({ClassifyScalar, "scalar"});
+    return result;
+  }();
+  return classifiers;
+}
+
+// 按名称查找，不可用时返回-1
+int FindClassifier(const char* name) {
+  const std::vector<Classifier>& classifiers = AvailableClassifiers();
+  for (size_t i = 0; i < classifiers.size(); ++i) {
+    if (std::strcmp(classifiers[i].name, name) == 0) {
+      return static_cast<int>(i);
+    }
+  }
+  return -1;
+}
+
+int SelectClassifier() {
+  static const int selected = []() {
+    // 环境变量LIFE_VIEW_JSON_SCANNER=scalar/sse2可强制使用指定实现，便于对比测试
+    const char* forced = std::getenv("LIFE_VIEW_JSON_SCANNER");
+    int index = forced ? FindClassifier(forced) : -1;
+    return index >= 0 ? index : 0;
+  }();
+  return selected;
+}
+
+// 前缀异或：结果第i位为输入第0..i位的异或，用于由引号位得到字符串区间
+uint64_t PrefixXor(uint64_t bits) {
+  bits ^= bits << 1;
+  bits ^= bits << 2;
+  bits ^= bits << 4;
+  bits ^= bits << 8;
+  bits ^= bits << 16;
+  bits ^= bits << 32;
+  return bits;
+}
+
+uint64_t TrailingZeros(uint64_t bits) {
+#if defined(_MSC_VER) && !defined(__clang__)
+  unsigned long index;
+  _BitScanForward64(&index, bits);
+  return index;
+#else
+  return static_cast<uint64_t>(__builtin_ctzll(bits));
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// 第二步：按结构索引构建Variant
+
+bool IsJsonSpace(char c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+bool IsTokenEnd(const char* data, size_t size, size_t pos) {
+  if (pos >= size) {
+    return true;
+  }
+  char c = data[pos];
+  return IsJsonSpace(c) || c == ',' || c == ']' || c == '}' || c == ':';
+}
+
+void AppendUtf8(uint32_t code_point, std::string* out) {
+  if (code_point < 0x80) {
+    out->push_back(static_cast<char>(code_point));
+  } else if (code_point < 0x800) {
+    out->push_back(static_cast<char>(0xC0 | (code_point >> 6)));
+    out->push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+  } else if (code_point < 0x10000) {
+    out->push_back(static_cast<char>(0xE0 | (code_point >> 12)));
+    out->push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+    out->push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+  } else {
+    out->push_back(static_cast<char>(0xF0 | (code_point >> 18)));
+    out->push_back(static_cast<char>(0x80 | ((code_point >> 12) & 0x3F)));
+    out->push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+    out->push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+  }
+}
+
+bool ReadHex4(const char* data, size_t size, size_t pos, uint32_t* value) {
+  if (pos + 4 > size) {
+    return false;
+  }
+  uint32_t result = 0;
+  for (size_t i = 0; i < 4; ++i) {
+    char c = data[pos + i];
+    result <<= 4;
+    if (c >= '0' && c <= '9') {
+      result |= static_cast<uint32_t>(c - '0');
+    } else if (c >= 'a' && c <= 'f') {
+      result |= static_cast<uint32_t>(c - 'a' + 10);
+    } else if (c >= 'A' && c <= 'F') {
+      result |= static_cast<uint32_t>(c - 'A' + 10);
+    } else {
+      return false;
+    }
+  }
+  *value = result;
+  return true;
+}
+
+// 找到下一个引号或反斜杠
+// 找到下一个引号、反斜杠或控制字符(< 0x20，字符串中不允许直接出现)
+size_t FindStringSpecial(const char* data, size_t size, size_t pos) {
+#ifdef JSON_SIMD_X86
+  const __m128i quote = _mm_set1_epi8('"');
+  const __m128i backslash = _mm_set1_epi8('\\');
+  const __m128i control_max = _mm_set1_epi8(0x1F);
+  while (pos + 16 <= size) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+    // 无符号比较v <= 0x1F
+    __m128i control = _mm_cmpeq_epi8(_mm_max_epu8(v, control_max), control_max);
+    int mask = _mm_movemask_epi8(_mm_or_si128(
+      _mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, backslash)), control));
+    if (mask != 0) {
+      return pos + TrailingZeros(static_cast<uint64_t>(mask));
+    }
+    pos += 16;
+  }
+#endif
+  while (pos < size && data[pos] != '"' && data[pos] != '\\' &&
+         static_cast<uint8_t>(data[pos]) >= 0x20) {
+    ++pos;
+  }
+  return pos;
+}
+
+class IndexedParser {
+public:
+  IndexedParser(const char* data, size_t size, const std::vector<uint32_t>& index,
+                std::string* error)
+    : data_(data)
+    , size_(size)
+    , index_(index)
+    , error_(error) {}
+
+  bool ParseDocument(Variant* out) {
+    if (index_.empty()) {
+      return Fail("empty document", 0);
+    }
+    if (!ParseValue(out, 0)) {
+      return false;
+    }
+    if (next_ != index_.size()) {
+      return Fail("unexpected trailing content", index_[next_]);
+    }
+    return true;
+  }
+
+private:
+  bool Fail(const char* message, size_t pos) {
+    if (error_) {
+      *error_ = std::string(message) + " at offset " + std::to_string(pos);
+    }
+    return false;
+  }
+
+  bool NextStructural(size_t* pos) {
+    if (next_ >= index_.size()) {
+      return Fail("unexpected end of input", size_);
+    }
+    *pos = index_[next_++];
+    return true;
+  }
+
+  bool ParseValue(Variant* out, int depth) {
+    size_t pos = 0;
+    if (!NextStructural(&pos)) {
+      return false;
+    }
+    switch (data_[pos]) {
+    case '{':
+      return ParseObject(pos, out, depth + 1);
+    case '[':
+      return ParseArray(pos, out, depth + 1);
+    case '"': {
+      std::string text;
+      if (!ParseString(pos, &text)) {
+        return false;
+      }
+      *out = Variant(std::move(text));
+      return true;
+    }
+    case 't':
+      return ParseLiteral(pos, "true", Variant(true), out);
+    case 'f':
+      return ParseLiteral(pos, "false", Variant(false), out);
+    case 'n':
+      return ParseLiteral(pos, "null", Variant(), out);
+    default:
+      return ParseNumber(pos, out);
+    }
+  }
+
+  bool ParseObject(size_t pos, Variant* out, int depth) {
+    if (depth > kMaxDepth) {
+      return Fail("nesting too deep", pos);
+    }
+    VariantMap map;
+    size_t next = 0;
+    if (next_ < index_.size() && data_[index_[next_]] == '}') {
+      ++next_;
+      *out = Variant(std::move(map));
+      return true;
+    }
+    for (;;) {
+      if (!NextStructural(&next)) {
+        return false;
+      }
+      if (data_[next] != '"') {
+        return Fail("object key expected", next);
+      }
+      std::string key;
+      if (!ParseString(next, &key)) {
+        return false;
+      }
+      if (!NextStructural(&next)) {
+        return false;
+      }
+      if (data_[next] != ':') {
+        return Fail("':' expected", next);
+      }
+      Variant value;
+      if (!ParseValue(&value, depth)) {
+        return false;
+      }
+      // 重复的键以后出现的为准，与JSON.parse一致
+      map.insert_or_assign(std::move(key), std::move(value));
+      if (!NextStructural(&next)) {
+        return false;
+      }
+      if (data_[next] == '}') {
+        break;
+      }
+      if (data_[next] != ',') {
+        return Fail("',' or '}' expected", next);
+      }
+    }
+    *out = Variant(std::move(map));
+    return true;
+  }
+
+  bool ParseArray(size_t pos, Variant* out, int depth) {
+    if (depth > kMaxDepth) {
+      return Fail("nesting too deep", pos);
+    }
+    VariantArray array;
+    if (next_ < index_.size() && data_[index_[next_]] == ']') {
+      ++next_;
+      *out = Variant(std::move(array));
+      return true;
+    }
+    size_t next = 0;
+    for (;;) {
+      array.emplace_back();
+      if (!ParseValue(&array.back(), depth)) {
+        return false;
+      }
+      if (!NextStructural(&next)) {
+        return false;
+      }
+      if (data_[next] == ']') {
+        break;
+      }
+      if (data_[next] != ',') {
+        return Fail("',' or ']' expected", next);
+      }
+    }
+    *out = Variant(std::move(array));
+    return true;
+  }
+
+  bool ParseString(size_t pos, std::string* out) {
+    size_t p = pos + 1;
+    for (;;) {
+      size_t stop = FindStringSpecial(data_, size_, p);
+      out->append(data_ + p, stop - p);
+      if (stop >= size_) {
+        return Fail("unterminated string", pos);
+      }
+      if (data_[stop] == '"') {
+        return true;
+      }
+      if (data_[stop] != '\\') {
+        return Fail("control character in string", stop);
+      }
+      // 转义序列
+      if (stop + 1 >= size_) {
+        return Fail("unterminated string", pos);
+      }
+      char c = data_[stop + 1];
+      p = stop + 2;
+      switch (c) {
+      case '"':
+      case '\\':
+      case '/':
+        out->push_back(c);
+        break;
+      case 'b':
+        out->push_back('\b');
+        break;
+      case 'f':
+        out->push_back('\f');
+        break;
+      case 'n':
+        out->push_back('\n');
+        break;
+      case 'r':
+        out->push_back('\r');
+        break;
+      case 't':
+        out->push_back('\t');
+        break;
+      case 'u': {
+        uint32_t code;
+        if (!ReadHex4(data_, size_, p, &code)) {
+          return Fail("invalid unicode escape", stop);
+        }
+        p += 4;
+        // 代理对，单独出现的代理项无法编码为UTF-8，按错误处理
+        if (code >= 0xDC00 && code <= 0xDFFF) {
+          return Fail("unpaired surrogate", stop);
+        }
+        if (code >= 0xD800 && code <= 0xDBFF) {
+          uint32_t low;
+          if (p + 6 > size_ || data_[p] != '\\' || data_[p + 1] != 'u' ||
+              !ReadHex4(data_, size_, p + 2, &low) || low < 0xDC00 || low > 0xDFFF) {
+            return Fail("unpaired surrogate", stop);
+          }
+          code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+          p += 6;
+        }
+        AppendUtf8(code, out);
+        break;
+      }
+      default:
+        return Fail("invalid escape", stop);
+      }
+    }
+  }
+
+  bool ParseLiteral(size_t pos, const char* literal, Variant value, Variant* out) {
+    size_t len = std::strlen(literal);
+    if (pos + len > size_ || std::memcmp(data_ + pos, literal, len) != 0 ||
+        !IsTokenEnd(data_, size_, pos + len)) {
+      return Fail("invalid literal", pos);
+    }
+    *out = std::move(value);
+    return true;
+  }
+
+  bool ParseNumber(size_t pos, Variant* out) {
+    size_t p = pos;
+    bool negative = false;
+    if (p < size_ && data_[p] == '-') {
+      negative = true;
+      ++p;
+    }
+    auto is_digit = [this](size_t i) { return i < size_ && data_[i] >= '0' && data_[i] <= '9'; };
+    if (!is_digit(p)) {
+      return Fail("unexpected character", pos);
+    }
+    bool integral = true;
+    int64_t int_value = 0;
+    size_t digits = 0;
+    if (data_[p] == '0') {
+      ++p;
+      digits = 1;
+    } else {
+      while (is_digit(p)) {
+        if (digits < 18) {
+          int_value = int_value * 10 + (data_[p] - '0');
+        }
+        ++digits;
+        ++p;
+      }
+    }
+    if (p < size_ && data_[p] == '.') {
+      ++p;
+      if (!is_digit(p)) {
+        return Fail("invalid number", pos);
+      }
+      while (is_digit(p)) {
+        ++p;
+      }
+      integral = false;
+    }
+    if (p < size_ && (data_[p] == 'e' || data_[p] == 'E')) {
+      ++p;
+      if (p < size_ && (data_[p] == '+' || data_[p] == '-')) {
+        ++p;
+      }
+      if (!is_digit(p)) {
+        return Fail("invalid number", pos);
+      }
+      while (is_digit(p)) {
+        ++p;
+      }
+      integral = false;
+    }
+    if (!IsTokenEnd(data_, size_, p)) {
+      return Fail("invalid number", pos);
+    }
+
+    // -0保留为Double，与JS中的-0一致
+    if (integral && digits <= 10 && !(negative && int_value == 0)) {
+      int64_t value = negative ? -int_value : int_value;
+      if (value >= INT_MIN && value <= INT_MAX) {
+        *out = Variant(static_cast<int>(value));
+        return true;
+      }
+      *out = Variant(static_cast<double>(value));
+      return true;
+    }
+
+    double value = 0;
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+    if (std::from_chars(data_ + pos, data_ + p, value).ec == std::errc::result_out_of_range) {
+      // 超出范围时from_chars不写入value，改用strtod得到与另一分支相同的±inf或±0
+      value = std::strtod(std::string(data_ + pos, p - pos).c_str(), nullptr);
+    }
+#else
+    value = std::strtod(std::string(data_ + pos, p - pos).c_str(), nullptr);
+#endif
+    // 上溢无法用JSON写回，按错误处理；下溢按JS的行为取±0
+    if (std::isinf(value)) {
+      return Fail("number out of range", pos);
+    }
+    // 整数值统一用Int表示，与NValueToVariant一致
+    if (value == std::floor(value) && value >= INT_MIN && value <= INT_MAX &&
+        !(value == 0 && std::signbit(value))) {
+      *out = Variant(static_cast<int>(value));
+    } else {
+      *out = Variant(value);
+    }
+    return true;
+  }
+
+private:
+  const char* data_;
+  size_t size_;
+  const std::vector<uint32_t>& index_;
+  std::string* error_;
+  size_t next_ = 0;
+};
+
+//////////////////////////////////////////////////////////////////////////////
+// 序列化
+
+void AppendEscapedChar(unsigned char c, std::string* out) {
+  switch (c) {
+  case '"':
+    out->append("\\\"");
+    break;
+  case '\\':
+    out->append("\\\\");
+    break;
+  case '\b':
+    out->append("\\b");
+    break;
+  case '\f':
+    out->append("\\f");
+    break;
+  case '\n':
+    out->append("\\n");
+    break;
+  case '\r':
+    out->append("\\r");
+    break;
+  case '\t':
+    out->append("\\t");
+    break;
+  default: {
+    static const char kHex[] = "0123456789abcdef";
+    char buffer[6] = {'\\', 'u', '0', '0', kHex[c >> 4], kHex[c & 0xF]};
+    out->append(buffer, 6);
+    break;
+  }
+  }
+}
+
+void WriteString(const std::string& text, std::string* out) {
+  out->push_back('"');
+  const char* data = text.data();
+  const size_t size = text.size();
+  size_t pos = 0;
+  size_t run_start = 0;
+#ifdef JSON_SIMD_X86
+  // 每次检查16字节，没有需要转义的字符时整段跳过
+  const __m128i quote = _mm_set1_epi8('"');
+  const __m128i backslash = _mm_set1_epi8('\\');
+  const __m128i control_max = _mm_set1_epi8(0x1F);
+  while (pos + 16 <= size) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+    __m128i control = _mm_cmpeq_epi8(_mm_max_epu8(v, control_max), control_max);
+    __m128i special = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, quote), control),
+                                   _mm_cmpeq_epi8(v, backslash));
+    int mask = _mm_movemask_epi8(special);
+    if (mask == 0) {
+      pos += 16;
+      continue;
+    }
+    size_t hit = pos + TrailingZeros(static_cast<uint64_t>(mask));
+    out->append(data + run_start, hit - run_start);
+    AppendEscapedChar(static_cast<unsigned char>(data[hit]), out);
+    pos = hit + 1;
+    run_start = pos;
+  }
+#endif
+  for (; pos < size; ++pos) {
+    unsigned char c = static_cast<unsigned char>(data[pos]);
+    if (c < 0x20 || c == '"' || c == '\\') {
+      out->append(data + run_start, pos - run_start);
+      AppendEscapedChar(c, out);
+      run_start = pos + 1;
+    }
+  }
+  out->append(data + run_start, size - run_start);
+  out->push_back('"');
+}
+
+void WriteDouble(double value, std::string* out) {
+  if (!std::isfinite(value)) {
+    out->append("null");
+    return;
+  }
+  char buffer[32];
+  // 整数值按整数输出，与JSON.stringify的格式一致（如毫秒时间戳）
+  if (value == std::floor(value) && std::fabs(value) < 1e15) {
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), static_cast<int64_t>(value));
+    out->append(buffer, result.ptr);
+    return;
+  }
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+  auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+  out->append(buffer, result.ptr);
+#else
+  int len = std::snprintf(buffer, sizeof(buffer), "%.17g", value);
+  out->append(buffer, len);
+#endif
+}
+
+}   // namespace
+
+//////////////////////////////////////////////////////////////////////////////
+// JsonStructuralScanner
+
+JsonStructuralScanner::JsonStructuralScanner()
+  : classifier_(SelectClassifier()) {}
+
+JsonStructuralScanner::JsonStructuralScanner(const char* implementation)
+  : classifier_(FindClassifier(implementation)) {
+  if (classifier_ < 0) {
+    classifier_ = SelectClassifier();
+  }
+}
+
+size_t JsonStructuralScanner::Scan(const char* data, size_t size, bool final, uint32_t base,
+                                   std::vector<uint32_t>* out) {
+  const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data);
+  size_t pos = 0;
+  for (; pos + 64 <= size; pos += 64) {
+    ScanBlock(bytes + pos, base + static_cast<uint32_t>(pos), out);
+  }
+  if (final && pos < size) {
+    // 末尾不足64字节时用空格补齐
+    uint8_t tail[64];
+    std::memset(tail, ' ', sizeof(tail));
+    std::memcpy(tail, bytes + pos, size - pos);
+    ScanBlock(tail, base + static_cast<uint32_t>(pos), out);
+    pos = size;
+  }
+  return pos;
+}
+
+void JsonStructuralScanner::ScanBlock(const uint8_t* block, uint32_t base,
+                                      std::vector<uint32_t>* out) {
+  BlockMasks masks;
+  AvailableClassifiers()[classifier_].fn(block, &masks);
+
+  // 找出奇数长度反斜杠序列之后的字符，它们是被转义的
+  const uint64_t even_bits = 0x5555555555555555ULL;
+  const uint64_t odd_bits = ~even_bits;
+  uint64_t bs = masks.backslash;
+  uint64_t start_edges = bs & ~(bs << 1);
+  uint64_t even_start_mask = even_bits ^ prev_ends_odd_backslash_;
+  uint64_t even_starts = start_edges & even_start_mask;
+  uint64_t odd_starts = start_edges & ~even_start_mask;
+  uint64_t even_carries = bs + even_starts;
+  uint64_t odd_carries = bs + odd_starts;
+  uint64_t ends_odd_backslash = odd_carries < bs ? 1 : 0;
+  odd_carries |= prev_ends_odd_backslash_;
+  prev_ends_odd_backslash_ = ends_odd_backslash;
+  uint64_t even_carry_ends = even_carries & ~bs;
+  uint64_t odd_carry_ends = odd_carries & ~bs;
+  uint64_t escaped = (even_carry_ends & odd_bits) | (odd_carry_ends & even_bits);
+
+  // 字符串区间：包含开引号，不包含闭引号
+  uint64_t quotes = masks.quote & ~escaped;
+  uint64_t in_string = PrefixXor(quotes) ^ prev_in_string_;
+  prev_in_string_ = static_cast<uint64_t>(static_cast<int64_t>(in_string) >> 63);
+
+  // 结构字符 + 字符串开引号 + 标量起始位置（前一个字符是空白或结构字符）
+  uint64_t structurals = masks.op & ~in_string;
+  structurals |= quotes;
+  uint64_t pseudo_pred = structurals | masks.whitespace;
+  uint64_t shifted_pseudo_pred = (pseudo_pred << 1) | prev_ends_pseudo_pred_;
+  prev_ends_pseudo_pred_ = pseudo_pred >> 63;
+  uint64_t pseudo_structurals = shifted_pseudo_pred & ~masks.whitespace & ~in_string;
+  structurals |= pseudo_structurals;
+  structurals &= ~(quotes & ~in_string);
+
+  while (structurals != 0) {
+    out->push_back(base + static_cast<uint32_t>(TrailingZeros(structurals)));
+    structurals &= structurals - 1;
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// 对外接口
+
+const char* JsonScannerName() {
+  return AvailableClassifiers()[SelectClassifier()].name;
+}
+
+std::vector<std::string> JsonScannerNames() {
+  std::vector<std::string> names;
+  for (const Classifier& classifier : AvailableClassifiers()) {
+    names.push_back(classifier.name);
+  }
+  return names;
+}
+
+bool ParseJson(const char* data, size_t size, Variant* out, std::string* error) {
+  if (size >= UINT32_MAX) {
+    if (error) *error = "document too large";
+    return false;
+  }
+  std::vector<uint32_t> index;
+  // 结构字符通常不超过输入的1/4
+  index.reserve(size / 4 + 16);
+  JsonStructuralScanner scanner;
+  scanner.Scan(data, size, true, 0, &index);
+  if (scanner.InString()) {
+    if (error) *error = "unterminated string";
+    return false;
+  }
+  IndexedParser parser(data, size, index, error);
+  return parser.ParseDocument(out);
+}
+
+bool ParseJson(const std::string& text, Variant* out, std::string* error) {
+  return ParseJson(text.data(), text.size(), out, error);
+}
+
+void WriteJson(const Variant& value, std::string* out) {
+  switch (value.GetType()) {
+  case VariantType::Null:
+    out->append("null");
+    break;
+  case VariantType::Bool:
+    out->append(value.AsBool() ? "true" : "false");
+    break;
+  case VariantType::Int: {
+    char buffer[16];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value.AsInt());
+    out->append(buffer, result.ptr);
+    break;
+  }
+  case VariantType::Double:
+    WriteDouble(value.AsDouble(), out);
+    break;
+  case VariantType::String:
+    WriteString(value.StringRef(), out);
+    break;
+  case VariantType::Array: {
+    out->push_back('[');
+    bool first = true;
+    for (const auto& item : value.ArrayRef()) {
+      if (!first) {
+        out->push_back(',');
+      }
+      WriteJson(item, out);
+      first = false;
+    }
+    out->push_back(']');
+    break;
+  }
+  case VariantType::Map: {
+    out->push_back('{');
+    bool first = true;
+    for (const auto& [key, item] : value.MapRef()) {
+      if (!first) {
+        out->push_back(',');
+      }
+      WriteString(key, out);
+      out->push_back(':');
+      WriteJson(item, out);
+      first = false;
+    }
+    out->push_back('}');
+    break;
+  }
+  }
+}
+
+std::string ToJson(const Variant& value) {
+  std::string out;
+  WriteJson(value, &out);
+  return out;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// JsonStreamParser
+
+JsonStreamParser::JsonStreamParser(Mode mode, ValueCallback on_value)
+  : mode_(mode)
+  , on_value_(std::move(on_value)) {}
+
+bool JsonStreamParser::Feed(const char* data, size_t size) {
+  if (!error_.empty()) {
+    return false;
+  }
+  buffer_.append(data, size);
+  return Process(false);
+}
+
+bool JsonStreamParser::Finish() {
+  if (!error_.empty()) {
+    return false;
+  }
+  if (!Process(true)) {
+    return false;
+  }
+  if (scanner_.InString()) {
+    return Fail("unterminated string", buffer_.size());
+  }
+  if (mode_ == Mode::TopLevelArray && !array_closed_) {
+    return Fail("unexpected end of input", buffer_.size());
+  }
+  if (mode_ == Mode::Sequence && (depth_ != 0 || has_value_start_)) {
+    return Fail("unexpected end of input", buffer_.size());
+  }
+  return true;
+}
+
+bool JsonStreamParser::Process(bool final) {
+  structurals_.clear();
+  if (buffer_.size() >= UINT32_MAX) {
+    return Fail("value too large for streaming buffer", scanned_);
+  }
+  scanned_ += scanner_.Scan(buffer_.data() + scanned_,
+                            buffer_.size() - scanned_,
+                            final,
+                            static_cast<uint32_t>(scanned_),
+                            &structurals_);
+  for (uint32_t pos : structurals_) {
+    if (!HandleStructural(pos)) {
+      return false;
+    }
+  }
+  Compact();
+  return true;
+}
+
+bool JsonStreamParser::HandleStructural(size_t pos) {
+  const char c = buffer_[pos];
+  const bool open = c == '{' || c == '[';
+  const bool close = c == '}' || c == ']';
+
+  if (mode_ == Mode::Sequence) {
+    if (depth_ == 0) {
+      if (!open) {
+        return Fail("object or array expected", pos);
+      }
+      has_value_start_ = true;
+      value_start_ = pos;
+    }
+    if (open) {
+      ++depth_;
+    } else if (close && --depth_ == 0) {
+      has_value_start_ = false;
+      return EmitValue(value_start_, pos + 1);
+    }
+    return true;
+  }
+
+  // TopLevelArray：深度1上的','和']'是元素边界
+  if (!array_opened_) {
+    if (c != '[') {
+      return Fail("array expected", pos);
+    }
+    array_opened_ = true;
+    depth_ = 1;
+    return true;
+  }
+  if (array_closed_) {
+    return Fail("unexpected trailing content", pos);
+  }
+  if (depth_ == 1 && !has_value_start_ && c != ',' && c != ']') {
+    if (c == '}' || c == ':') {
+      return Fail("unexpected character", pos);
+    }
+    has_value_start_ = true;
+    after_comma_ = false;
+    value_start_ = pos;
+  }
+  if (open) {
+    ++depth_;
+    return true;
+  }
+  if (close) {
+    if (--depth_ > 0) {
+      return true;
+    }
+    // 顶层数组结束
+    array_closed_ = true;
+    if (has_value_start_) {
+      has_value_start_ = false;
+      return EmitValue(value_start_, pos);
+    }
+    if (after_comma_) {
+      return Fail("trailing comma", pos);
+    }
+    return true;
+  }
+  if (c == ',' && depth_ == 1) {
+    if (!has_value_start_) {
+      return Fail("unexpected ','", pos);
+    }
+    has_value_start_ = false;
+    after_comma_ = true;
+    return EmitValue(value_start_, pos);
+  }
+  return true;
+}
+
+bool JsonStreamParser::EmitValue(size_t begin, size_t end) {
+  Variant value;
+  std::string error;
+  if (!ParseJson(buffer_.data() + begin, end - begin, &value, &error)) {
+    return Fail(error, begin);
+  }
+  on_value_(std::move(value));
+  return true;
+}
+
+void JsonStreamParser::Compact() {
+  // 已回调的部分不再需要，当前值的起点之前都可以丢弃
+  size_t keep_from = has_value_start_ ? value_start_ : scanned_;
+  if (keep_from == 0 || keep_from < buffer_.size() / 2) {
+    return;
+  }
+  buffer_.erase(0, keep_from);
+  buffer_base_ += keep_from;
+  scanned_ -= keep_from;
+  if (has_value_start_) {
+    value_start_ -= keep_from;
+  }
+}
+
+bool JsonStreamParser::Fail(const std::string& message, size_t pos) {
+  error_ = message + " (stream offset " + std::to_string(buffer_base_ + pos) + ")";
+  return false;
+}
+
+}   // namespace framework
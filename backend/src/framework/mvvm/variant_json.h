@@ -0,0 +1,107 @@
+/*
+ * @Author: Nana5aki
+ * @Date: 2026-10-18 16:10:27
+ * @LastEditors: Nana5aki
+ * @LastEditTime: 2026-10-18 16:10:27
+ * @FilePath: \life_view\backend\src\framework\mvvm\variant_json.h
+ */
+#pragma once
+
+#include "variant.h"
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace framework {
+
+// 原生JSON编解码，直接在Variant和文本之间转换，不经过JS对象。
+//
+// 解析分两步：第一步以64字节为块，用SIMD(AVX2/SSE2，其他平台为标量实现)
+// 找出所有不在字符串内的结构字符和标量起始位置；第二步按这个索引构建Variant。
+// 整数且在int范围内的数字解析为Int，其余(包括-0)为Double，与NValueToVariant一致。
+// 按RFC 8259，字符串中未转义的控制字符和不成对的\u代理项都视为错误。
+
+// 解析完整文档，失败返回false并在error中给出偏移
+bool ParseJson(const char* data, size_t size, Variant* out, std::string* error = nullptr);
+bool ParseJson(const std::string& text, Variant* out, std::string* error = nullptr);
+
+// 序列化，NaN/Infinity输出为null（与JSON.stringify一致）
+void WriteJson(const Variant& value, std::string* out);
+std::string ToJson(const Variant& value);
+
+// 当前使用的结构扫描实现: "avx2" / "sse2" / "scalar"
+const char* JsonScannerName();
+// 本机可用的全部实现，用于对比测试
+std::vector<std::string> JsonScannerNames();
+
+// 第一步的增量结构扫描器，状态跨块保持，可分多次输入
+class JsonStructuralScanner {
+public:
+  JsonStructuralScanner();
+  // 使用指定实现(JsonScannerNames()中的名称)，不可用时使用默认实现
+  explicit JsonStructuralScanner(const char* implementation);
+
+  // 扫描data中完整的64字节块，结构字符位置加上base后追加到out，返回已扫描字节数。
+  // final为true时连同末尾不足64字节的部分一起扫描。位置为32位，单次文档需小于4GB。
+  size_t Scan(const char* data, size_t size, bool final, uint32_t base,
+              std::vector<uint32_t>* out);
+
+  // 扫描结束时是否仍在字符串内
+  bool InString() const {
+    return prev_in_string_ != 0;
+  }
+
+private:
+  void ScanBlock(const uint8_t* block, uint32_t base, std::vector<uint32_t>* out);
+
+private:
+  int classifier_;
+  uint64_t prev_ends_odd_backslash_ = 0;
+  uint64_t prev_in_string_ = 0;
+  uint64_t prev_ends_pseudo_pred_ = 1;
+};
+
+// 流式解析，用于大文档：分块Feed，每得到一个完整值就回调，已回调部分的缓冲会被释放。
+//   TopLevelArray: 输入是一个大数组，逐个回调数组元素
+//   Sequence:      输入是连续的多个对象/数组（如NDJSON），逐个回调
+class JsonStreamParser {
+public:
+  enum class Mode : char { TopLevelArray = 0, Sequence };
+  using ValueCallback = std::function<void(Variant&& value)>;
+
+  JsonStreamParser(Mode mode, ValueCallback on_value);
+
+  // 返回false表示已出错，之后的输入都会被忽略
+  bool Feed(const char* data, size_t size);
+  bool Finish();
+
+  const std::string& Error() const {
+    return error_;
+  }
+
+private:
+  bool Process(bool final);
+  bool HandleStructural(size_t pos);
+  bool EmitValue(size_t begin, size_t end);
+  void Compact();
+  bool Fail(const std::string& message, size_t pos);
+
+private:
+  Mode mode_;
+  ValueCallback on_value_;
+  JsonStructuralScanner scanner_;
+  std::vector<uint32_t> structurals_;
+  std::string buffer_;
+  uint64_t buffer_base_ = 0;   // buffer_[0]在整个输入中的偏移
+  size_t scanned_ = 0;         // buffer_中已扫描的字节数
+  int depth_ = 0;
+  bool array_opened_ = false;
+  bool array_closed_ = false;
+  bool has_value_start_ = false;
+  bool after_comma_ = false;
+  size_t value_start_ = 0;
+  std::string error_;
+};
+
+}   // namespace framework
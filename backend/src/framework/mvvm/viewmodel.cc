@@ -6,30 +6,348 @@
  * @FilePath: \life_view\backend\src\framework\mvvm\viewmodel.cc
  */
 #include "viewmodel.h"
+#include "command_trace.h"
+#include "variant_codec.h"
+#include <algorithm>
+#include <iostream>
 
 namespace framework {
 
+namespace {
+
+// shared_ptr本身加make_shared的控制块(虚表指针和两个引用计数)
+constexpr size_t kPropValueOverhead = sizeof(ViewModel::PropValue) + 2 * sizeof(void*);
+
+}   // namespace
+
+uint64_t ViewModel::access_clock_ = 0;
+ViewModel::MemoryGrowthListener ViewModel::memory_growth_listener_;
+
+const Variant* ViewModel::PropSnapshot::Find(const std::string& name) const {
+  auto it = std::lower_bound(entries_.begin(), entries_.end(), name,
+                             [](const Entry& entry, const std::string& key) {
+                               return entry.name < key;
+                             });
+  if (it == entries_.end() || it->name != name) {
+    return nullptr;
+  }
+  return it->value.get();
+}
+
+ViewModel::WriteBatch::WriteBatch(ViewModel* viewmodel)
+  : viewmodel_(viewmodel) {
+  ++viewmodel_->write_depth_;
+}
+
+ViewModel::WriteBatch::~WriteBatch() {
+  if (--viewmodel_->write_depth_ == 0 && viewmodel_->snapshot_dirty_) {
+    viewmodel_->PublishSnapshot();
+  }
+}
+
+ViewModel::~ViewModel() {
+  if (CommandTrace::Enabled()) {
+    CommandTrace::Forget(this);
+  }
+  // 其他线程可能还在读最后一份快照
+  const PropSnapshot* snapshot = snapshot_.load(std::memory_order_relaxed);
+  if (snapshot) {
+    Epoch::Retire(snapshot);
+  }
+}
+
+void ViewModel::SetMemoryGrowthListener(MemoryGrowthListener listener) {
+  memory_growth_listener_ = std::move(listener);
+}
+
+Variant ViewModel::GetProp(const std::string& name) {
+  const Variant* value = FindProp(name);
+  return value ? *value : Variant();
+}
+
+const Variant* ViewModel::FindProp(const std::string& name) {
+  PropValue* slot = FindPropSlot(name);
+  return slot ? slot->get() : nullptr;
+}
+
+ViewModel::PropValue ViewModel::FindPropShared(const std::string& name) {
+  PropValue* slot = FindPropSlot(name);
+  return slot ? *slot : PropValue();
+}
+
+ViewModel::PropValue* ViewModel::FindPropSlot(const std::string& name) {
+  auto it = properties_.find(name);
+  if (it == properties_.end()) {
+    return nullptr;
+  }
+  PropMemory& memory = prop_memory_[name];
+  memory.last_access = ++access_clock_;
+  if (memory.spilled) {
+    RestoreProp(name, &memory, &it->second);
+  }
+  return &it->second;
+}
+
+const std::map<std::string, ViewModel::PropValue>& ViewModel::GetProps() {
+  if (spilled_count_ > 0) {
+    for (auto& [name, value] : properties_) {
+      PropMemory& memory = prop_memory_[name];
+      if (memory.spilled) {
+        RestoreProp(name, &memory, &value);
+      }
+    }
+  }
+  return properties_;
+}
+
+ViewModel::PropValue* ViewModel::PreparePropWrite(const std::string& name, const Variant& value) {
+  PropStats& stats = prop_stats_[name];
+  ++stats.sets;
+  PropMemory& memory = prop_memory_[name];
+  memory.last_access = ++access_clock_;
+  bool is_event = event_props_.count(name) != 0;
+  auto it = properties_.find(name);
+  if (it == properties_.end()) {
+    it = properties_.emplace(name, PropValue()).first;
+  } else if (memory.spilled) {
+    // 哈希不同一定是新值，不必读回；相同时读回再逐层比较
+    if (is_event || memory.spilled_hash != value.Hash()) {
+      DiscardSpill(name, &memory);
+    } else if (RestoreProp(name, &memory, &it->second) && *it->second == value) {
+      ++stats.skips;
+      return nullptr;
+    }
+  } else if (!is_event && *it->second == value) {
+    // 已存储的值哈希总是缓存的，新值只需计算一次哈希，哈希不同即可直接判定
+    ++stats.skips;
+    return nullptr;
+  }
+  return &it->second;
+}
+
+void ViewModel::SetProp(const std::string& name, const Variant& value) {
+  value.Hash();
+  PropValue* slot = PreparePropWrite(name, value);
+  if (!slot) {
+    return;
+  }
+  // 旧值保留到通知结束
+  PropValue old_value = std::move(*slot);
+  *slot = std::make_shared<const Variant>(value);
+  UpdatePropMemory(name, **slot);
+  OnPropWritten();
+  NotifyPropChanged(name, value);
+}
+
+void ViewModel::SetProp(const std::string& name, Variant&& value) {
+  value.Hash();
+  PropValue* slot = PreparePropWrite(name, value);
+  if (!slot) {
+    return;
+  }
+  PropValue old_value = std::move(*slot);
+  *slot = std::make_shared<const Variant>(std::move(value));
+  UpdatePropMemory(name, **slot);
+  OnPropWritten();
+  NotifyPropChanged(name, **slot);
+}
+
+void ViewModel::UpdatePropMemory(const std::string& name, const Variant& value) {
+  PropMemory& memory = prop_memory_[name];
+  if (!memory_growth_listener_) {
+    if (!memory.stale) {
+      memory.stale = true;
+      ++stale_count_;
+    }
+    return;
+  }
+  size_t old_bytes = memory.bytes;
+  MeasurePropMemory(name, &memory, value);
+  if (memory.bytes > old_bytes) {
+    memory_growth_listener_();
+  }
+}
+
+void ViewModel::MeasurePropMemory(const std::string& name, PropMemory* memory,
+                                  const Variant& value) {
+  if (memory->stale) {
+    memory->stale = false;
+    --stale_count_;
+  }
+  size_t bytes = Variant::MapEntryOverhead(name) + kPropValueOverhead + value.DeepSize();
+  resident_bytes_ = resident_bytes_ - memory->bytes + bytes;
+  memory->bytes = bytes;
+}
+
+void ViewModel::RefreshPropMemory() {
+  if (stale_count_ == 0) {
+    return;
+  }
+  // 过期的属性一定常驻，换出前会先补算
+  for (auto& [name, memory] : prop_memory_) {
+    if (memory.stale) {
+      MeasurePropMemory(name, &memory, *properties_.at(name));
+    }
+  }
+}
+
+void ViewModel::OnPropWritten() {
+  if (concurrent_reads_ == 0) {
+    return;
+  }
+  snapshot_dirty_ = true;
+  if (write_depth_ == 0) {
+    PublishSnapshot();
+  }
+}
+
+void ViewModel::EnableConcurrentReads() {
+  if (concurrent_reads_++ > 0) {
+    return;
+  }
+  GetProps();
+  PublishSnapshot();
+}
+
+void ViewModel::DisableConcurrentReads() {
+  if (concurrent_reads_ == 0 || --concurrent_reads_ > 0) {
+    return;
+  }
+  snapshot_dirty_ = false;
+  // 正在读的线程在EpochGuard结束前仍可使用已读到的快照
+  const PropSnapshot* old = snapshot_.exchange(nullptr, std::memory_order_acq_rel);
+  if (old) {
+    Epoch::Retire(old);
+  }
+  // 快照持有属性值，没有读者时推进两次epoch即可释放，之后换出才能真正释放内存
+  Epoch::Reclaim();
+  Epoch::Reclaim();
+}
+
+void ViewModel::PublishSnapshot() {
+  // 只拷贝属性名和指针，值与当前属性共享
+  auto* snapshot = new PropSnapshot();
+  snapshot->version_ = ++snapshot_version_;
+  snapshot->entries_.reserve(properties_.size());
+  for (const auto& [name, value] : properties_) {
+    snapshot->entries_.push_back({name, value});
+  }
+  const PropSnapshot* old = snapshot_.exchange(snapshot, std::memory_order_acq_rel);
+  snapshot_dirty_ = false;
+  if (old) {
+    Epoch::Retire(old);
+  }
+}
+
+ViewModel::MemoryUsage ViewModel::GetMemoryUsage() {
+  RefreshPropMemory();
+  MemoryUsage usage;
+  usage.prop_count = properties_.size();
+  usage.resident_bytes = resident_bytes_;
+  usage.spilled_count = spilled_count_;
+  usage.spilled_bytes = spilled_bytes_;
+  return usage;
+}
+
+const std::map<std::string, ViewModel::PropMemory>& ViewModel::GetPropMemory() {
+  RefreshPropMemory();
+  return prop_memory_;
+}
+
+bool ViewModel::SpillProp(const std::string& name) {
+  auto it = properties_.find(name);
+  auto memory_it = prop_memory_.find(name);
+  if (it == properties_.end() || memory_it == prop_memory_.end() || memory_it->second.spilled ||
+      concurrent_reads_ > 0) {
+    return false;
+  }
+  PropMemory& memory = memory_it->second;
+  if (memory.stale) {
+    MeasurePropMemory(name, &memory, *it->second);
+  }
+
+  std::string bytes;
+  EncodeVariant(*it->second, &bytes);
+  if (!SpillStore::GetInstance()->Write(bytes, &memory.spill)) {
+    return false;
+  }
+  memory.spilled = true;
+  memory.spilled_hash = it->second->Hash();
+  // 换出后只剩节点和一个空指针
+  it->second.reset();
+  size_t placeholder = Variant::MapEntryOverhead(name) + sizeof(PropValue);
+  resident_bytes_ = resident_bytes_ - memory.bytes + placeholder;
+  spilled_bytes_ += memory.bytes;
+  ++spilled_count_;
+  return true;
+}
+
+bool ViewModel::RestoreProp(const std::string& name, PropMemory* memory, PropValue* slot) {
+  std::string bytes;
+  size_t offset = 0;
+  Variant value;
+  bool ok = SpillStore::GetInstance()->Read(memory->spill, &bytes) &&
+            DecodeVariant(reinterpret_cast<const uint8_t*>(bytes.data()), bytes.size(), &offset,
+                          &value);
+  if (!ok) {
+    // 读不回来时属性保持为Null，至少不会反复失败
+    std::cerr << "Failed to restore spilled property: " << view_id_ << "." << name << std::endl;
+  }
+  DiscardSpill(name, memory);
+  value.Hash();
+  *slot = std::make_shared<const Variant>(std::move(value));
+  UpdatePropMemory(name, **slot);
+  return ok;
+}
+
+void ViewModel::DiscardSpill(const std::string& name, PropMemory* memory) {
+  SpillStore::GetInstance()->Release(memory->spill);
+  memory->spilled = false;
+  spilled_bytes_ -= memory->bytes;
+  --spilled_count_;
+  // 当前常驻的是占位值，接下来的写入会按新值更新
+  memory->bytes = Variant::MapEntryOverhead(name) + sizeof(PropValue);
+}
+
 void ViewModel::RegisterCommand(const std::string& command_name,
-                                std::function<void(const Variant*)> command) {
+                                std::function<bool(const Variant*)> command) {
   commands_[command_name] = command;
 }
 
+void ViewModel::RegisterEventProp(const std::string& prop_name) {
+  event_props_.insert(prop_name);
+}
+
 // Execute Action
-void ViewModel::Command(const std::string& command_name, const Variant* params) {
+bool ViewModel::Command(const std::string& command_name, const Variant* params) {
   auto it = commands_.find(command_name);
-  if (it != commands_.end()) {
-    it->second(params);
+  if (it == commands_.end()) {
+    return false;
   }
+  WriteBatch batch(this);
+  if (CommandTrace::Enabled()) {
+    uint64_t start = CommandTrace::Now();
+    bool ok = it->second(params);
+    CommandTrace::RecordCommand(this, command_name, params, start);
+    return ok;
+  }
+  return it->second(params);
 }
 
 // Notify property change to listeners
 void ViewModel::NotifyPropChanged(const std::string& prop_name, const Variant& new_value) {
+  if (CommandTrace::Enabled()) {
+    CommandTrace::RecordPropChanged(this, prop_name, new_value);
+  }
   auto it = property_listeners_.find(prop_name);
   if (it != property_listeners_.end()) {
     for (const auto& listener : it->second) {
       listener.listener_(prop_name, new_value);
     }
   }
+  for (const auto& listener : any_property_listeners_) {
+    listener(prop_name, new_value);
+  }
 }
 
 // Add property listener
@@ -40,4 +358,8 @@ void ViewModel::BindProperty(const std::string& prop_name, PropChangeListener li
   property_listeners_[prop_name].push_back(pl);
 }
 
+void ViewModel::BindAnyProperty(PropChangeListener listener) {
+  any_property_listeners_.push_back(listener);
+}
+
 }   // namespace framework
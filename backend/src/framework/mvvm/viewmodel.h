@@ -7,12 +7,15 @@
  */
 #pragma once
 
+#include "framework/core/epoch.h"
+#include "framework/core/spill_store.h"
 #include "model.h"
 #include "variant.h"
+#include <atomic>
 #include <functional>
 #include <map>
 #include <memory>
-#include <napi.h>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -28,37 +31,196 @@ class ViewModel {
   };
 
 public:
+  // 每个属性的SetProp统计，skips为值未变化而跳过通知的次数
+  struct PropStats {
+    uint64_t sets = 0;
+    uint64_t skips = 0;
+  };
+
+  // 属性内存统计(字节)，每个属性计入map节点、键和值的DeepSize
+  struct MemoryUsage {
+    size_t prop_count = 0;
+    size_t resident_bytes = 0;
+    size_t spilled_count = 0;
+    // 换出的属性在内存中时的占用
+    size_t spilled_bytes = 0;
+  };
+
+  struct PropMemory {
+    size_t bytes = 0;
+    // 最近一次读写的全局时钟，越小越冷
+    uint64_t last_access = 0;
+    bool spilled = false;
+    // 换出时值的哈希，写入新值时不必读回即可判断是否变化
+    uint64_t spilled_hash = 0;
+    // 写入后bytes尚未按新值重新计算，没有内存预算时推迟到查询时
+    bool stale = false;
+    SpillStore::Handle spill;
+  };
+
+  using MemoryGrowthListener = std::function<void()>;
+
+  // 属性值写入后不再修改，写入新值时整体替换，已发布的快照可以继续持有旧值
+  using PropValue = std::shared_ptr<const Variant>;
+
+  // 发布给其他线程读取的不可变属性快照，按属性名排序
+  class PropSnapshot {
+  public:
+    struct Entry {
+      std::string name;
+      PropValue value;
+    };
+
+    // 不存在时返回nullptr
+    const Variant* Find(const std::string& name) const;
+
+    const std::vector<Entry>& Entries() const {
+      return entries_;
+    }
+
+    // 每次发布加1
+    uint64_t Version() const {
+      return version_;
+    }
+
+  private:
+    friend class ViewModel;
+    std::vector<Entry> entries_;
+    uint64_t version_ = 0;
+  };
+
+  // 范围内的属性写入合并为一次快照发布，其他线程看不到中间状态。命令执行期间自动合并
+  class WriteBatch {
+  public:
+    explicit WriteBatch(ViewModel* viewmodel);
+    ~WriteBatch();
+
+    WriteBatch(const WriteBatch&) = delete;
+    WriteBatch& operator=(const WriteBatch&) = delete;
+
+  private:
+    ViewModel* viewmodel_;
+  };
+
   ViewModel(const std::string view_id)
     : view_id_(view_id) {};
 
-  virtual ~ViewModel() = default;
+  virtual ~ViewModel();
 
-  void SetProp(const std::string& name, const Variant& value) {
-    properties_[name] = value;
-    NotifyPropChanged(name, value);
+  // 新值与当前值结构相等时不覆盖也不通知，事件属性除外
+  void SetProp(const std::string& name, const Variant& value);
+  void SetProp(const std::string& name, Variant&& value);
+
+  // 换出的属性在这里透明地读回
+  Variant GetProp(const std::string& name);
+  // 不拷贝的读取，不存在时返回nullptr；指针在该属性下次写入或换出前有效
+  const Variant* FindProp(const std::string& name);
+  // 同FindProp，返回共享的值，属性被替换后仍可继续持有；指针相同即值未被替换
+  PropValue FindPropShared(const std::string& name);
+
+  // 返回命令处理函数的结果，命令未注册时返回false
+  bool Command(const std::string& command_name, const Variant* params);
+  bool HasCommand(const std::string& command_name) const {
+    return commands_.count(command_name) != 0;
   }
 
-  Variant GetProp(const std::string& name) const {
-    auto it = properties_.find(name);
-    return it != properties_.end() ? it->second : Variant();
+  // 通知期间被替换的旧值仍然存活，监听者可以通过之前保存的weak_ptr取到它与新值比较
+  void BindProperty(const std::string& prop_name, PropChangeListener listener);
+  // 监听所有属性的变化
+  void BindAnyProperty(PropChangeListener listener);
+
+  // 先读回所有换出的属性
+  const std::map<std::string, PropValue>& GetProps();
+
+  // 开启后属性变化时发布快照供其他线程读取。只能在主线程调用；
+  // 开启后不再换出属性，快照仍持有旧值，换出也释放不了内存。
+  // 与DisableConcurrentReads成对调用，全部关闭后撤下快照，恢复换出
+  void EnableConcurrentReads();
+  void DisableConcurrentReads();
+
+  // 任意线程调用，必须在EpochGuard范围内，快照及其中的值在Guard结束前有效。
+  // 读取不加锁也不拷贝；未开启时返回nullptr
+  const PropSnapshot* ReadSnapshot() const {
+    return snapshot_.load(std::memory_order_acquire);
   }
 
-  void Command(const std::string& command_name, const Variant* params);
+  bool ConcurrentReadsEnabled() const {
+    return concurrent_reads_ > 0;
+  }
 
-  void BindProperty(const std::string& prop_name, PropChangeListener listener);
+  const std::map<std::string, PropStats>& GetPropStats() const {
+    return prop_stats_;
+  }
+
+  const std::string& GetViewId() const {
+    return view_id_;
+  }
+
+  // 查询前先补算推迟的属性占用
+  MemoryUsage GetMemoryUsage();
+  const std::map<std::string, PropMemory>& GetPropMemory();
+
+  // 有单独的属性监听(BindProperty)时视为界面正在使用，不换出。
+  // BindAnyProperty是传输层的桥接，只在变化时拿到值，不影响换出
+  bool IsPropSubscribed(const std::string& name) const {
+    return property_listeners_.count(name) != 0;
+  }
+
+  // 把属性值编码写入SpillStore并释放内存，下次访问时读回
+  bool SpillProp(const std::string& name);
+
+  // 任意ViewModel的常驻内存增长时调用，由MVVMManager用于检查内存预算
+  static void SetMemoryGrowthListener(MemoryGrowthListener listener);
 
 protected:
+  // 处理函数返回命令是否成功，例如参数无效时返回false；异步命令在开始后即返回
   void RegisterCommand(const std::string& command_name,
-                       std::function<void(const Variant*)> command);
+                       std::function<bool(const Variant*)> command);
+  // 事件属性(如命令结果、进度)每次SetProp都通知，连续两次相同的结果也不会被合并
+  void RegisterEventProp(const std::string& prop_name);
 
 private:
   void NotifyPropChanged(const std::string& prop_name, const Variant& new_value);
+  // 不存在时返回nullptr，换出的属性先读回
+  PropValue* FindPropSlot(const std::string& name);
+  // 值未变化时返回nullptr，否则返回用于存放新值的位置
+  PropValue* PreparePropWrite(const std::string& name, const Variant& value);
+  // 写入新值后调用，批量写入期间推迟到批次结束
+  void OnPropWritten();
+  void PublishSnapshot();
+  // 写入后重新计算属性占用。没有内存增长监听(未设内存预算)时只标记过期，
+  // 避免每次写入都遍历整个值
+  void UpdatePropMemory(const std::string& name, const Variant& value);
+  void MeasurePropMemory(const std::string& name, PropMemory* memory, const Variant& value);
+  void RefreshPropMemory();
+  bool RestoreProp(const std::string& name, PropMemory* memory, PropValue* slot);
+  void DiscardSpill(const std::string& name, PropMemory* memory);
 
 private:
   std::string view_id_;
-  std::map<std::string, std::function<void(const Variant*)>> commands_;
-  std::map<std::string, Variant> properties_;
+  std::map<std::string, std::function<bool(const Variant*)>> commands_;
+  std::set<std::string> event_props_;
+  // 换出的属性值为空指针
+  std::map<std::string, PropValue> properties_;
   std::map<std::string, std::vector<PropertyListener>> property_listeners_;
+  std::vector<PropChangeListener> any_property_listeners_;
+  std::map<std::string, PropStats> prop_stats_;
+  std::map<std::string, PropMemory> prop_memory_;
+  size_t resident_bytes_ = 0;
+  size_t spilled_bytes_ = 0;
+  size_t spilled_count_ = 0;
+  size_t stale_count_ = 0;
+
+  // 以下只在主线程访问，snapshot_除外
+  // EnableConcurrentReads的次数
+  int concurrent_reads_ = 0;
+  int write_depth_ = 0;
+  bool snapshot_dirty_ = false;
+  uint64_t snapshot_version_ = 0;
+  std::atomic<const PropSnapshot*> snapshot_{nullptr};
+
+  static uint64_t access_clock_;
+  static MemoryGrowthListener memory_growth_listener_;
 };
 
 }   // namespace framework
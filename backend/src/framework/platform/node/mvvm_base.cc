@@ -5,8 +5,13 @@
  * @LastEditTime: 2025-06-07 16:53:49
  * @FilePath: \life_view\backend\src\framework\platform\node\mvvm_base.cc
  */
+#include "framework/core/main_thread.h"
+#include "framework/core/spill_store.h"
 #include "framework/mvvm/mvvm_manager.h"
+#include "framework/platform/node/node_util.h"
 #include "framework/platform/node/viewmodel_wrapper.h"
+#include "viewmodel/view_model_registry.h"
+#include <cstdlib>
 #include <iostream>
 #include <napi.h>
 #include <sstream>
@@ -61,13 +66,118 @@ Napi::Value CreateViewModel(const Napi::CallbackInfo& info) {
   return wrapper;
 }
 
+// 全局内存统计：{ budget, resident_bytes, spilled_bytes, spilled_count, spill_file_bytes,
+//   view_models: [MemoryUsageToNValue] }
+Napi::Value GetMemoryUsage(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  MVVMManager* manager = MVVMManager::getInstance();
+
+  size_t resident_bytes = 0;
+  size_t spilled_bytes = 0;
+  size_t spilled_count = 0;
+  auto viewmodels = manager->getViewModels();
+  Napi::Array view_models = Napi::Array::New(env, viewmodels.size());
+  for (size_t i = 0; i < viewmodels.size(); ++i) {
+    auto usage = viewmodels[i]->GetMemoryUsage();
+    resident_bytes += usage.resident_bytes;
+    spilled_bytes += usage.spilled_bytes;
+    spilled_count += usage.spilled_count;
+    view_models.Set(i, framework::MemoryUsageToNValue(*viewmodels[i], env));
+  }
+
+  Napi::Object result = Napi::Object::New(env);
+  result.Set("budget", Napi::Number::New(env, static_cast<double>(manager->getMemoryBudget())));
+  result.Set("resident_bytes", Napi::Number::New(env, static_cast<double>(resident_bytes)));
+  result.Set("spilled_bytes", Napi::Number::New(env, static_cast<double>(spilled_bytes)));
+  result.Set("spilled_count", Napi::Number::New(env, static_cast<double>(spilled_count)));
+  result.Set("spill_file_bytes",
+             Napi::Number::New(
+               env, static_cast<double>(framework::SpillStore::GetInstance()->FileBytes())));
+  result.Set("view_models", view_models);
+  return result;
+}
+
+// setMemoryBudget(bytes)，0表示不限制
+Napi::Value SetMemoryBudget(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1 || !info[0].IsNumber() || info[0].As<Napi::Number>().DoubleValue() < 0) {
+    Napi::TypeError::New(env, "budget bytes expected").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+  MVVMManager::getInstance()->setMemoryBudget(
+    static_cast<size_t>(info[0].As<Napi::Number>().DoubleValue()));
+  return env.Undefined();
+}
+
+// startTrace(path, { values?: boolean })，values为true时同时录制属性值
+Napi::Value StartTrace(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1 || !info[0].IsString()) {
+    Napi::TypeError::New(env, "trace path expected").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+  bool record_values = false;
+  if (info.Length() > 1 && info[1].IsObject()) {
+    Napi::Value values = info[1].As<Napi::Object>().Get("values");
+    record_values = values.IsBoolean() && values.As<Napi::Boolean>().Value();
+  }
+  std::string error;
+  if (!MVVMManager::getInstance()->startTrace(
+        info[0].As<Napi::String>().Utf8Value(), record_values, &error)) {
+    Napi::Error::New(env, error).ThrowAsJavaScriptException();
+  }
+  return env.Undefined();
+}
+
+Napi::Value StopTrace(const Napi::CallbackInfo& info) {
+  MVVMManager::getInstance()->stopTrace();
+  return info.Env().Undefined();
+}
+
+// LIFE_VIEW_MVVM_TRACE=文件路径 从加载模块开始录制，
+// LIFE_VIEW_MVVM_TRACE_VALUES=1 同时录制属性值
+void StartTraceFromEnv() {
+  const char* path = std::getenv("LIFE_VIEW_MVVM_TRACE");
+  if (!path || !*path) {
+    return;
+  }
+  const char* values = std::getenv("LIFE_VIEW_MVVM_TRACE_VALUES");
+  std::string error;
+  if (!MVVMManager::getInstance()->startTrace(path, values && *values == '1', &error)) {
+    std::cerr << error << std::endl;
+  }
+}
+
+// 后台线程通过MainThread::Post投递的任务，借助ThreadSafeFunction唤醒JS线程执行
+static Napi::ThreadSafeFunction main_thread_waker;
+
+void InitMainThread(Napi::Env env) {
+  main_thread_waker = Napi::ThreadSafeFunction::New(
+    env, Napi::Function::New(env, [](const Napi::CallbackInfo&) {}), "life_view_main_thread", 0, 1);
+  // 不阻止进程退出
+  main_thread_waker.Unref(env);
+  framework::MainThread::SetWaker([]() {
+    main_thread_waker.NonBlockingCall(
+      [](Napi::Env, Napi::Function) { framework::MainThread::RunPending(); });
+  });
+}
+
 // Module initialization
 Napi::Object Init(Napi::Env env, Napi::Object exports) {
+  InitMainThread(env);
+  LifeV::RegisterViewModels();
+  StartTraceFromEnv();
 
   // Initialize ViewModel wrapper class
   framework::ViewModelWrapper::Init(env, exports);
   // Export MVVM functions
   exports.Set("createViewModel", Napi::Function::New(env, CreateViewModel));
+  exports.Set("getMemoryUsage", Napi::Function::New(env, GetMemoryUsage));
+  exports.Set("setMemoryBudget", Napi::Function::New(env, SetMemoryBudget));
+  exports.Set("startTrace", Napi::Function::New(env, StartTrace));
+  exports.Set("stopTrace", Napi::Function::New(env, StopTrace));
 
   return exports;
 }
@@ -6,10 +6,15 @@
  * @FilePath: \life_view\backend\src\framework\platform\node\node_util.cc
  */
 #include "node_util.h"
+#include <climits>
+#include <cmath>
+#include <unordered_map>
 
 namespace framework {
 
-Napi::Value VariantToNValue(const Variant& prop, Napi::Env env) {
+namespace {
+
+Napi::Value ToNValue(const Variant& prop, Napi::Env env, bool freeze) {
   switch (prop.GetType()) {
   case VariantType::Null:
     return env.Null();
@@ -20,20 +25,26 @@ Napi::Value VariantToNValue(const Variant& prop, Napi::Env env) {
   case VariantType::Double:
     return Napi::Number::New(env, prop.AsDouble());
   case VariantType::String:
-    return Napi::String::New(env, prop.AsString());
+    return Napi::String::New(env, prop.StringRef());
   case VariantType::Array: {
-    const auto& arr = prop.AsArray();
+    const auto& arr = prop.ArrayRef();
     Napi::Array napiArray = Napi::Array::New(env, arr.size());
     for (size_t i = 0; i < arr.size(); ++i) {
-      napiArray[i] = VariantToNValue(arr[i], env);
+      napiArray[i] = ToNValue(arr[i], env, freeze);
+    }
+    if (freeze) {
+      napiArray.Freeze();
     }
     return napiArray;
   }
   case VariantType::Map: {
-    const auto& map = prop.AsMap();
+    const auto& map = prop.MapRef();
     Napi::Object napiObject = Napi::Object::New(env);
     for (const auto& [key, value] : map) {
-      napiObject.Set(key, VariantToNValue(value, env));
+      napiObject.Set(key, ToNValue(value, env, freeze));
+    }
+    if (freeze) {
+      napiObject.Freeze();
     }
     return napiObject;
   }
@@ -42,6 +53,85 @@ Napi::Value VariantToNValue(const Variant& prop, Napi::Env env) {
   }
 }
 
+}   // namespace
+
+Napi::Value VariantToNValue(const Variant& prop, Napi::Env env) {
+  return ToNValue(prop, env, false);
+}
+
+Napi::Value VariantToFrozenNValue(const Variant& prop, Napi::Env env) {
+  return ToNValue(prop, env, true);
+}
+
+namespace {
+
+Napi::Value PatchArray(const VariantArray& old_array, const VariantArray& new_array,
+                       Napi::Array cached, Napi::Env env) {
+  Napi::Array result = Napi::Array::New(env, new_array.size());
+  // 旧元素按哈希建立索引，插入或删除后移位的元素仍可复用；只在位置对不上时才建立
+  std::unordered_multimap<uint64_t, uint32_t> old_index;
+  bool indexed = false;
+  for (uint32_t i = 0; i < new_array.size(); ++i) {
+    const Variant& item = new_array[i];
+    if (i < old_array.size() && old_array[i] == item) {
+      result.Set(i, cached.Get(i));
+      continue;
+    }
+    if (!indexed) {
+      old_index.reserve(old_array.size());
+      for (uint32_t j = 0; j < old_array.size(); ++j) {
+        old_index.emplace(old_array[j].Hash(), j);
+      }
+      indexed = true;
+    }
+    bool reused = false;
+    auto range = old_index.equal_range(item.Hash());
+    for (auto it = range.first; it != range.second; ++it) {
+      if (old_array[it->second] == item) {
+        result.Set(i, cached.Get(it->second));
+        reused = true;
+        break;
+      }
+    }
+    if (!reused) {
+      // 同一位置的元素只改了部分字段时，其中未变的部分仍可复用
+      result.Set(i, i < old_array.size() ? PatchNValue(old_array[i], item, cached.Get(i), env)
+                                         : VariantToFrozenNValue(item, env));
+    }
+  }
+  result.Freeze();
+  return result;
+}
+
+Napi::Value PatchMap(const VariantMap& old_map, const VariantMap& new_map, Napi::Object cached,
+                     Napi::Env env) {
+  Napi::Object result = Napi::Object::New(env);
+  for (const auto& [key, value] : new_map) {
+    auto it = old_map.find(key);
+    result.Set(key, it != old_map.end() ? PatchNValue(it->second, value, cached.Get(key), env)
+                                        : VariantToFrozenNValue(value, env));
+  }
+  result.Freeze();
+  return result;
+}
+
+}   // namespace
+
+Napi::Value PatchNValue(const Variant& old_value, const Variant& new_value, Napi::Value cached,
+                        Napi::Env env) {
+  // 存储的值哈希都已缓存，不相等时通常O(1)判定
+  if (old_value == new_value) {
+    return cached;
+  }
+  if (old_value.IsArray() && new_value.IsArray() && cached.IsArray()) {
+    return PatchArray(old_value.ArrayRef(), new_value.ArrayRef(), cached.As<Napi::Array>(), env);
+  }
+  if (old_value.IsMap() && new_value.IsMap() && cached.IsObject()) {
+    return PatchMap(old_value.MapRef(), new_value.MapRef(), cached.As<Napi::Object>(), env);
+  }
+  return VariantToFrozenNValue(new_value, env);
+}
+
 Variant NValueToVariant(const Napi::Value& value) {
   if (value.IsNull() || value.IsUndefined()) {
     return Variant(VariantType::Null);
@@ -49,8 +139,9 @@ Variant NValueToVariant(const Napi::Value& value) {
     return Variant(value.As<Napi::Boolean>().Value());
   } else if (value.IsNumber()) {
     double num = value.As<Napi::Number>().DoubleValue();
-    // 检查是否为整数
-    if (num == static_cast<int>(num) && num >= INT_MIN && num <= INT_MAX) {
+    // 检查是否为整数，先判断范围再转换；-0保留为Double
+    if (num >= INT_MIN && num <= INT_MAX && num == static_cast<int>(num) &&
+        !(num == 0 && std::signbit(num))) {
       return Variant(static_cast<int>(num));
     } else {
       return Variant(num);
@@ -83,4 +174,24 @@ Variant NValueToVariant(const Napi::Value& value) {
   }
 }
 
-}   // namespace framework
+Napi::Object MemoryUsageToNValue(ViewModel& viewmodel, Napi::Env env) {
+  ViewModel::MemoryUsage usage = viewmodel.GetMemoryUsage();
+  Napi::Object result = Napi::Object::New(env);
+  result.Set("view_id", Napi::String::New(env, viewmodel.GetViewId()));
+  result.Set("prop_count", Napi::Number::New(env, static_cast<double>(usage.prop_count)));
+  result.Set("resident_bytes", Napi::Number::New(env, static_cast<double>(usage.resident_bytes)));
+  result.Set("spilled_count", Napi::Number::New(env, static_cast<double>(usage.spilled_count)));
+  result.Set("spilled_bytes", Napi::Number::New(env, static_cast<double>(usage.spilled_bytes)));
+
+  Napi::Object props = Napi::Object::New(env);
+  for (const auto& [name, memory] : viewmodel.GetPropMemory()) {
+    Napi::Object item = Napi::Object::New(env);
+    item.Set("bytes", Napi::Number::New(env, static_cast<double>(memory.bytes)));
+    item.Set("spilled", Napi::Boolean::New(env, memory.spilled));
+    props.Set(name, item);
+  }
+  result.Set("props", props);
+  return result;
+}
+
+}   // namespace framework
\ No newline at end of file
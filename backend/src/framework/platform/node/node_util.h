@@ -6,7 +6,10 @@
  * @FilePath: \life_view\backend\src\framework\platform\node\node_util.h
  */
 
-#include "framework/mvvm/variant.h";
+#pragma once
+
+#include "framework/mvvm/variant.h"
+#include "framework/mvvm/viewmodel.h"
 #include <napi.h>
 
 namespace framework {
@@ -14,7 +17,20 @@ namespace framework {
 // Variant转换为Napi::Value
 Napi::Value VariantToNValue(const Variant& prop, Napi::Env env);
 
+// 同VariantToNValue，对象和数组逐层冻结，用于多次返回、在调用方之间共享的值
+Napi::Value VariantToFrozenNValue(const Variant& prop, Napi::Env env);
+
+// 由old_value转换得到的cached得到new_value的JS值：相等的子树直接复用cached中的对象，
+// 只有变化的路径上创建新对象。cached应是VariantToFrozenNValue或本函数的结果，
+// 复用的子树无法被调用方修改，新建的对象和数组同样冻结
+Napi::Value PatchNValue(const Variant& old_value, const Variant& new_value, Napi::Value cached,
+                        Napi::Env env);
+
 // Napi::Value转换为Variant
 Variant NValueToVariant(const Napi::Value& value);
 
+// { view_id, prop_count, resident_bytes, spilled_count, spilled_bytes,
+//   props: { name: { bytes, spilled } } }
+Napi::Object MemoryUsageToNValue(ViewModel& viewmodel, Napi::Env env);
+
 }   // namespace framework
\ No newline at end of file
@@ -1,4 +1,8 @@
 #include "viewmodel_wrapper.h"
+#include "framework/core/epoch.h"
+#include "framework/core/main_thread.h"
+#include "framework/core/thread_pool.h"
+#include "framework/mvvm/variant_codec.h"
 #include "node_util.h"
 #include <climits>
 #include <cmath>
@@ -8,6 +12,22 @@ namespace framework {
 
 Napi::FunctionReference ViewModelWrapper::constructor;
 
+namespace {
+
+// 属性集合编码为一个Map，与DecodeVariant的格式一致
+void BeginEncodedProps(size_t count, std::string* out) {
+  out->push_back(static_cast<char>(VariantTag::Map));
+  WriteVarint(count, out);
+}
+
+void AppendEncodedProp(const std::string& name, const Variant& value, std::string* out) {
+  WriteVarint(name.size(), out);
+  out->append(name);
+  EncodeVariant(value, out);
+}
+
+}   // namespace
+
 Napi::Object ViewModelWrapper::Init(Napi::Env env, Napi::Object exports) {
   Napi::Function func =
     DefineClass(env,
@@ -16,6 +36,15 @@ Napi::Object ViewModelWrapper::Init(Napi::Env env, Napi::Object exports) {
                   InstanceMethod("GetProp", &ViewModelWrapper::GetProp),
                   InstanceMethod("BindProperty", &ViewModelWrapper::BindProperty),
                   InstanceMethod("ExcuteCommand", &ViewModelWrapper::ExcuteCommand),
+                  InstanceMethod("GetPropStats", &ViewModelWrapper::GetPropStats),
+                  InstanceMethod("GetMemoryUsage", &ViewModelWrapper::GetMemoryUsage),
+                  InstanceMethod("GetProps", &ViewModelWrapper::GetProps),
+                  InstanceMethod("ExcuteCommands", &ViewModelWrapper::ExcuteCommands),
+                  InstanceMethod("GetPropsEncoded", &ViewModelWrapper::GetPropsEncoded),
+                  InstanceMethod("GetPropsEncodedAsync", &ViewModelWrapper::GetPropsEncodedAsync),
+                  InstanceMethod("BindAnyPropertyEncoded",
+                                 &ViewModelWrapper::BindAnyPropertyEncoded),
+                  InstanceMethod("ExcuteCommandEncoded", &ViewModelWrapper::ExcuteCommandEncoded),
                 });
 
   constructor = Napi::Persistent(func);
@@ -29,6 +58,35 @@ ViewModelWrapper::ViewModelWrapper(const Napi::CallbackInfo& info)
 
 void ViewModelWrapper::SetViewModel(std::shared_ptr<ViewModel> viewmodel) {
   viewmodel_ = viewmodel;
+  mirror_.clear();
+}
+
+Napi::Value ViewModelWrapper::MirrorProp(const std::string& prop_name, Napi::Env env) {
+  ViewModel::PropValue value = viewmodel_->FindPropShared(prop_name);
+  if (!value || (!value->IsArray() && !value->IsMap())) {
+    mirror_.erase(prop_name);
+    return value ? VariantToNValue(*value, env) : env.Null();
+  }
+
+  auto it = mirror_.find(prop_name);
+  if (it == mirror_.end()) {
+    Napi::Value result = VariantToFrozenNValue(*value, env);
+    mirror_[prop_name] = {value, Napi::Persistent(result.As<Napi::Object>())};
+    return result;
+  }
+  MirrorEntry& entry = it->second;
+  if (!entry.source.owner_before(value) && !value.owner_before(entry.source)) {
+    return entry.value.Value();
+  }
+  // 在BindProperty回调中旧值还在(ViewModel::SetProp通知期间保留)，只重建变化的子树；
+  // 之后才读取时旧值已释放，整体重新转换
+  ViewModel::PropValue old_value = entry.source.lock();
+  Napi::Value result = old_value
+                         ? PatchNValue(*old_value, *value, entry.value.Value(), env)
+                         : VariantToFrozenNValue(*value, env);
+  entry.source = value;
+  entry.value = Napi::Persistent(result.As<Napi::Object>());
+  return result;
 }
 
 Napi::Value ViewModelWrapper::GetProp(const Napi::CallbackInfo& info) {
@@ -44,8 +102,7 @@ Napi::Value ViewModelWrapper::GetProp(const Napi::CallbackInfo& info) {
     return env.Undefined();
   }
 
-  std::string prop_name = info[0].As<Napi::String>().Utf8Value();
-  return VariantToNValue(viewmodel_->GetProp(prop_name), env);
+  return MirrorProp(info[0].As<Napi::String>().Utf8Value(), env);
 }
 
 Napi::Value ViewModelWrapper::BindProperty(const Napi::CallbackInfo& info) {
@@ -67,13 +124,13 @@ Napi::Value ViewModelWrapper::BindProperty(const Napi::CallbackInfo& info) {
 
   property_changed_callbacks_[prop_name] = Napi::Persistent(callback);
   viewmodel_->BindProperty(prop_name,
-                           [this, prop_name](const std::string& prop, const Variant& value) {
+                           [this, prop_name](const std::string& prop, const Variant&) {
                              auto it = property_changed_callbacks_.find(prop_name);
                              if (it != property_changed_callbacks_.end() && !it->second.IsEmpty()) {
                                Napi::Env env = it->second.Env();
                                Napi::Object change_info = Napi::Object::New(env);
                                change_info.Set("prop_name", Napi::String::New(env, prop));
-                               change_info.Set("value", VariantToNValue(value, env));
+                               change_info.Set("value", MirrorProp(prop, env));
                                it->second.Call({change_info});
                              }
                            });
@@ -108,4 +165,261 @@ Napi::Value ViewModelWrapper::ExcuteCommand(const Napi::CallbackInfo& info) {
   return env.Undefined();
 }
 
+Napi::Value ViewModelWrapper::GetPropStats(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (!viewmodel_) {
+    Napi::Error::New(env, "ViewModel not initialized").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  // { prop_name: { sets, skips } }
+  Napi::Object result = Napi::Object::New(env);
+  for (const auto& [prop_name, stats] : viewmodel_->GetPropStats()) {
+    Napi::Object item = Napi::Object::New(env);
+    item.Set("sets", Napi::Number::New(env, static_cast<double>(stats.sets)));
+    item.Set("skips", Napi::Number::New(env, static_cast<double>(stats.skips)));
+    result.Set(prop_name, item);
+  }
+  return result;
+}
+
+Napi::Value ViewModelWrapper::GetMemoryUsage(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (!viewmodel_) {
+    Napi::Error::New(env, "ViewModel not initialized").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+  return MemoryUsageToNValue(*viewmodel_, env);
+}
+
+// (prop_names?: string[]) => { prop_name: value }
+// 不传时返回所有属性；不存在的属性为null，与GetProp一致
+Napi::Value ViewModelWrapper::GetProps(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (!viewmodel_) {
+    Napi::Error::New(env, "ViewModel not initialized").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  Napi::Object result = Napi::Object::New(env);
+  if (info.Length() < 1 || info[0].IsUndefined()) {
+    for (const auto& prop : viewmodel_->GetProps()) {
+      result.Set(prop.first, MirrorProp(prop.first, env));
+    }
+    return result;
+  }
+
+  if (!info[0].IsArray()) {
+    Napi::TypeError::New(env, "propName array expected").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+  Napi::Array names = info[0].As<Napi::Array>();
+  for (uint32_t i = 0; i < names.Length(); ++i) {
+    Napi::Value name = names.Get(i);
+    if (!name.IsString()) {
+      Napi::TypeError::New(env, "propName array expected").ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+    // 直接用传入的JS字符串作键，省去再创建一次
+    result.Set(name, MirrorProp(name.As<Napi::String>().Utf8Value(), env));
+  }
+  return result;
+}
+
+// ([{ name, param? }], { stop_on_error? }?) => [{ ok, error? }]
+// 按顺序执行，每个命令一个结果，ok为命令处理函数的返回值(见ViewModel::RegisterCommand)。
+// stop_on_error时第一个失败之后的命令不执行，结果为skipped
+Napi::Value ViewModelWrapper::ExcuteCommands(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (!viewmodel_) {
+    Napi::Error::New(env, "ViewModel not initialized").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  if (info.Length() < 1 || !info[0].IsArray()) {
+    Napi::TypeError::New(env, "command array expected").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+  bool stop_on_error = false;
+  if (info.Length() > 1 && info[1].IsObject()) {
+    Napi::Value stop = info[1].As<Napi::Object>().Get("stop_on_error");
+    stop_on_error = stop.IsBoolean() && stop.As<Napi::Boolean>().Value();
+  }
+
+  Napi::Array commands = info[0].As<Napi::Array>();
+  uint32_t count = commands.Length();
+  Napi::Array results = Napi::Array::New(env, count);
+  bool stopped = false;
+  Variant param_variant;
+  for (uint32_t i = 0; i < count; ++i) {
+    std::string error;
+    Napi::Value entry = commands.Get(i);
+    Napi::Value name = entry.IsObject() ? entry.As<Napi::Object>().Get("name") : env.Undefined();
+    if (stopped) {
+      error = "skipped";
+    } else if (!name.IsString()) {
+      error = "command name expected";
+    } else {
+      std::string command_name = name.As<Napi::String>().Utf8Value();
+      Napi::Value param = entry.As<Napi::Object>().Get("param");
+      bool ok = false;
+      if (!viewmodel_->HasCommand(command_name)) {
+        error = "unknown command: " + command_name;
+      } else if (param.IsUndefined()) {
+        ok = viewmodel_->Command(command_name, nullptr);
+      } else {
+        param_variant = NValueToVariant(param);
+        ok = viewmodel_->Command(command_name, &param_variant);
+      }
+      if (error.empty() && !ok) {
+        // 具体原因由命令在控制台或结果属性中报告
+        error = "command failed: " + command_name;
+      }
+    }
+
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("ok", Napi::Boolean::New(env, error.empty()));
+    if (!error.empty()) {
+      result.Set("error", Napi::String::New(env, error));
+      stopped = stop_on_error;
+    }
+    results.Set(i, result);
+  }
+  return results;
+}
+
+// 返回所有属性编码后的Map
+Napi::Value ViewModelWrapper::GetPropsEncoded(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (!viewmodel_) {
+    Napi::Error::New(env, "ViewModel not initialized").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  const auto& props = viewmodel_->GetProps();
+  std::string out;
+  BeginEncodedProps(props.size(), &out);
+  for (const auto& [prop_name, value] : props) {
+    AppendEncodedProp(prop_name, *value, &out);
+  }
+  return Napi::Buffer<uint8_t>::Copy(
+    env, reinterpret_cast<const uint8_t*>(out.data()), out.size());
+}
+
+// callback(Buffer)，同GetPropsEncoded，但在线程池中读取属性快照并编码，不阻塞JS线程。
+// 回调前发生的属性变化可能已经通过BindAnyPropertyEncoded送出，结果可能比这些变化旧
+Napi::Value ViewModelWrapper::GetPropsEncodedAsync(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (!viewmodel_) {
+    Napi::Error::New(env, "ViewModel not initialized").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  if (info.Length() < 1 || !info[0].IsFunction()) {
+    Napi::TypeError::New(env, "callback function expected").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  // 编码期间发布快照，回调时关闭。引用只能在JS线程释放，由回调任务持有最后一份
+  viewmodel_->EnableConcurrentReads();
+  auto callback =
+    std::make_shared<Napi::FunctionReference>(Napi::Persistent(info[0].As<Napi::Function>()));
+  std::shared_ptr<ViewModel> viewmodel = viewmodel_;
+  ThreadPool::GetInstance()->Submit([viewmodel, callback]() mutable {
+    auto out = std::make_shared<std::string>();
+    {
+      EpochGuard guard;
+      const ViewModel::PropSnapshot* snapshot = viewmodel->ReadSnapshot();
+      BeginEncodedProps(snapshot->Entries().size(), out.get());
+      for (const auto& entry : snapshot->Entries()) {
+        AppendEncodedProp(entry.name, *entry.value, out.get());
+      }
+    }
+    MainThread::Post(
+      [viewmodel = std::move(viewmodel), callback = std::move(callback), out]() {
+        viewmodel->DisableConcurrentReads();
+        Napi::Env env = callback->Env();
+        callback->Call(
+          {Napi::Buffer<uint8_t>::Copy(
+            env, reinterpret_cast<const uint8_t*>(out->data()), out->size())});
+      });
+  });
+  return env.Undefined();
+}
+
+// callback(prop_name, Buffer)，Buffer为新值的编码
+Napi::Value ViewModelWrapper::BindAnyPropertyEncoded(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (!viewmodel_) {
+    Napi::Error::New(env, "ViewModel not initialized").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  if (info.Length() < 1 || !info[0].IsFunction()) {
+    Napi::TypeError::New(env, "callback function expected").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  bool first_bind = any_property_changed_callback_.IsEmpty();
+  any_property_changed_callback_ = Napi::Persistent(info[0].As<Napi::Function>());
+  if (first_bind) {
+    viewmodel_->BindAnyProperty([this](const std::string& prop, const Variant& value) {
+      if (any_property_changed_callback_.IsEmpty()) {
+        return;
+      }
+      Napi::Env env = any_property_changed_callback_.Env();
+      std::string encoded;
+      EncodeVariant(value, &encoded);
+      any_property_changed_callback_.Call(
+        {Napi::String::New(env, prop),
+         Napi::Buffer<uint8_t>::Copy(
+           env, reinterpret_cast<const uint8_t*>(encoded.data()), encoded.size())});
+    });
+  }
+
+  return env.Undefined();
+}
+
+// (command_name, Uint8Array?) => bool，参数为编码后的Variant，返回命令是否成功，未注册时为false
+Napi::Value ViewModelWrapper::ExcuteCommandEncoded(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (!viewmodel_) {
+    Napi::Error::New(env, "ViewModel not initialized").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  if (info.Length() < 1 || !info[0].IsString()) {
+    Napi::TypeError::New(env, "command name expected").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+  std::string command_name = info[0].As<Napi::String>().Utf8Value();
+
+  const Variant* params = nullptr;
+  Variant param_variant;
+
+  if (info.Length() > 1 && !info[1].IsUndefined()) {
+    if (!info[1].IsTypedArray()) {
+      Napi::TypeError::New(env, "encoded params expected").ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+    Napi::Uint8Array bytes = info[1].As<Napi::Uint8Array>();
+    size_t offset = 0;
+    if (!DecodeVariant(bytes.Data(), bytes.ElementLength(), &offset, &param_variant) ||
+        offset != bytes.ElementLength()) {
+      Napi::Error::New(env, "invalid encoded params").ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+    params = &param_variant;
+  }
+  return Napi::Boolean::New(env, viewmodel_->Command(command_name, params));
+}
+
 }   // namespace framework
\ No newline at end of file
@@ -29,9 +29,35 @@ private:
   Napi::Value GetProp(const Napi::CallbackInfo& info);
   Napi::Value BindProperty(const Napi::CallbackInfo& info);
   Napi::Value ExcuteCommand(const Napi::CallbackInfo& info);
+  Napi::Value GetPropStats(const Napi::CallbackInfo& info);
+  Napi::Value GetMemoryUsage(const Napi::CallbackInfo& info);
+
+  // 批量接口：界面挂载时一次取回所需属性，组合操作一次执行多个命令
+  Napi::Value GetProps(const Napi::CallbackInfo& info);
+  Napi::Value ExcuteCommands(const Napi::CallbackInfo& info);
+
+  // 二进制编码(variant_codec.h)的接口，供worker模式的传输层使用，避免构造JS对象
+  Napi::Value GetPropsEncoded(const Napi::CallbackInfo& info);
+  Napi::Value GetPropsEncodedAsync(const Napi::CallbackInfo& info);
+  Napi::Value BindAnyPropertyEncoded(const Napi::CallbackInfo& info);
+  Napi::Value ExcuteCommandEncoded(const Napi::CallbackInfo& info);
+
+  // 属性的JS值，Array和Map在值被替换前重复读取返回同一个对象，替换后只重建变化的子树。
+  // 共享的对象和数组都已冻结，调用方修改不会影响之后的读取。其他类型直接转换，JS按值比较。
+  // 这只在加载模块的上下文(预加载脚本)内成立，contextBridge会拷贝，渲染进程的复用在useMVVM中
+  Napi::Value MirrorProp(const std::string& prop_name, Napi::Env env);
+
+  struct MirrorEntry {
+    // 转换时的值，只用于判断是否被替换，不延长其生命周期，换出或替换后照常释放。
+    // weak_ptr保留控制块，新值不会复用同一个控制块，按owner比较不会误判
+    std::weak_ptr<const Variant> source;
+    Napi::ObjectReference value;
+  };
 
   std::shared_ptr<ViewModel> viewmodel_;
+  std::map<std::string, MirrorEntry> mirror_;
   std::map<std::string, Napi::FunctionReference> property_changed_callbacks_;
+  Napi::FunctionReference any_property_changed_callback_;
 };
 
 }   // namespace framework
\ No newline at end of file
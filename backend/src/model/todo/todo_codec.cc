@@ -0,0 +1,1127 @@
+/*
+ * @Author: Nana5aki
+ * @Date: 2026-10-18 11:05:37
+ * @LastEditors: Nana5aki
+ * @LastEditTime: 2026-10-18 11:05:37
+ * @FilePath: \life_view\backend\src\model\todo\todo_codec.cc
+ */
+#include "todo_codec.h"
+#include "framework/mvvm/variant_json.h"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string_view>
+
+namespace LifeV {
+
+using framework::Variant;
+using framework::VariantArray;
+using framework::VariantMap;
+using framework::VariantType;
+
+namespace {
+
+constexpr int64_t kMsPerDay = 86400000;
+// 与JS Date相同的时间范围(±1e8天)，超出的时间戳不导入也不导出
+constexpr double kMaxTimeMs = 8.64e15;
+
+bool IsTodoTime(double ms) {
+  return std::abs(ms) <= kMaxTimeMs;
+}
+
+// 超出int范围时取边界，直接转换是未定义行为
+int ClampToInt(double value) {
+  if (std::isnan(value)) {
+    return 0;
+  }
+  return static_cast<int>(std::clamp(value, static_cast<double>(INT_MIN),
+                                     static_cast<double>(INT_MAX)));
+}
+
+// 解析过程中的中间结构，最后一次性转成VariantMap
+struct TodoFields {
+  std::string id;
+  std::string title;
+  std::string notes;
+  std::string status = "todo";
+  int priority = 0;
+  bool has_due = false;
+  double due = 0;
+  bool has_completed = false;
+  double completed_at = 0;
+  VariantArray tags;
+  std::string rrule;
+
+  bool Empty() const {
+    return id.empty() && title.empty() && notes.empty();
+  }
+
+  void Reset() {
+    *this = TodoFields();
+  }
+
+  Variant ToVariant() {
+    // 按键的字典序追加并带上hint，避免std::map逐个比较查找插入位置
+    VariantMap todo;
+    auto end = todo.end();
+    todo.emplace_hint(end, "completed_at", has_completed ? Variant(completed_at) : Variant());
+    todo.emplace_hint(end, "due", has_due ? Variant(due) : Variant());
+    todo.emplace_hint(end, "id", Variant(std::move(id)));
+    todo.emplace_hint(end, "notes", Variant(std::move(notes)));
+    todo.emplace_hint(end, "priority", Variant(priority));
+    todo.emplace_hint(end, "rrule", rrule.empty() ? Variant() : Variant(std::move(rrule)));
+    todo.emplace_hint(end, "status", Variant(std::move(status)));
+    todo.emplace_hint(end, "tags", Variant(std::move(tags)));
+    todo.emplace_hint(end, "title", Variant(std::move(title)));
+    return Variant(std::move(todo));
+  }
+};
+
+char ToLowerAscii(char c) {
+  return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+std::string ToLower(std::string_view text) {
+  std::string result(text);
+  for (auto& c : result) {
+    c = ToLowerAscii(c);
+  }
+  return result;
+}
+
+std::string_view Trim(std::string_view text) {
+  while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) {
+    text.remove_prefix(1);
+  }
+  while (!text.empty() && (text.back() == ' ' || text.back() == '\t')) {
+    text.remove_suffix(1);
+  }
+  return text;
+}
+
+bool EqualsIgnoreCase(std::string_view a, std::string_view b) {
+  if (a.size() != b.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < a.size(); ++i) {
+    if (ToLowerAscii(a[i]) != ToLowerAscii(b[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// 各种工具导出的状态值统一成 todo/doing/done/cancelled
+std::string NormalizeStatus(std::string_view raw) {
+  // 本应用自己导出的文件走快速路径
+  if (raw == "todo" || raw == "doing" || raw == "done" || raw == "cancelled") {
+    return std::string(raw);
+  }
+  std::string value = ToLower(Trim(raw));
+  if (value == "done" || value == "completed" || value == "complete" || value == "finished" ||
+      value == "true" || value == "yes" || value == "x" || value == "1") {
+    return "done";
+  }
+  if (value == "doing" || value == "in progress" || value == "in-process" ||
+      value == "in_progress" || value == "in-progress" || value == "started") {
+    return "doing";
+  }
+  if (value == "cancelled" || value == "canceled") {
+    return "cancelled";
+  }
+  return "todo";
+}
+
+void AppendTags(std::string_view raw, char separator_a, char separator_b, VariantArray* tags) {
+  size_t start = 0;
+  for (size_t i = 0; i <= raw.size(); ++i) {
+    if (i == raw.size() || raw[i] == separator_a || raw[i] == separator_b) {
+      std::string_view tag = Trim(raw.substr(start, i - start));
+      if (!tag.empty()) {
+        tags->emplace_back(std::string(tag));
+      }
+      start = i + 1;
+    }
+  }
+}
+
+int ParseInt(std::string_view text) {
+  text = Trim(text);
+  int sign = 1;
+  size_t i = 0;
+  if (i < text.size() && (text[i] == '-' || text[i] == '+')) {
+    sign = text[i] == '-' ? -1 : 1;
+    ++i;
+  }
+  // 超长的数字串取边界值，不会溢出
+  int64_t value = 0;
+  for (; i < text.size() && text[i] >= '0' && text[i] <= '9'; ++i) {
+    value = std::min<int64_t>(value * 10 + (text[i] - '0'), INT_MAX);
+  }
+  return static_cast<int>(sign * value);
+}
+
+// 读取固定位数的数字
+bool ReadDigits(const char* text, size_t len, size_t* pos, size_t count, int* value) {
+  if (*pos + count > len) {
+    return false;
+  }
+  int result = 0;
+  for (size_t i = 0; i < count; ++i) {
+    char c = text[*pos + i];
+    if (c < '0' || c > '9') {
+      return false;
+    }
+    result = result * 10 + (c - '0');
+  }
+  *pos += count;
+  *value = result;
+  return true;
+}
+
+void AppendTwoDigits(int value, std::string* out) {
+  out->push_back(static_cast<char>('0' + value / 10));
+  out->push_back(static_cast<char>('0' + value % 10));
+}
+
+// iCalendar格式 YYYYMMDDTHHMMSSZ，超出范围时返回空串
+std::string FormatICalDateTime(double ms) {
+  if (!IsTodoTime(ms)) {
+    return std::string();
+  }
+  int64_t total_ms = static_cast<int64_t>(std::floor(ms));
+  int64_t days = total_ms >= 0 ? total_ms / kMsPerDay : (total_ms - kMsPerDay + 1) / kMsPerDay;
+  int64_t day_ms = total_ms - days * kMsPerDay;
+  int64_t year;
+  unsigned month, day;
+  CivilFromDays(days, &year, &month, &day);
+
+  std::string result = std::to_string(year);
+  AppendTwoDigits(static_cast<int>(month), &result);
+  AppendTwoDigits(static_cast<int>(day), &result);
+  result.push_back('T');
+  AppendTwoDigits(static_cast<int>(day_ms / 3600000), &result);
+  AppendTwoDigits(static_cast<int>(day_ms / 60000 % 60), &result);
+  AppendTwoDigits(static_cast<int>(day_ms / 1000 % 60), &result);
+  result.push_back('Z');
+  return result;
+}
+
+const std::string& StringField(const Variant& todo, const char* key) {
+  static const std::string empty;
+  const Variant* value = todo.Find(key);
+  return (value && value->IsString()) ? value->StringRef() : empty;
+}
+
+bool NumberField(const Variant& todo, const char* key, double* result) {
+  const Variant* value = todo.Find(key);
+  if (!value) {
+    return false;
+  }
+  if (value->IsDouble()) {
+    *result = value->AsDouble();
+    return true;
+  }
+  if (value->IsInt()) {
+    *result = value->AsInt();
+    return true;
+  }
+  return false;
+}
+
+// 超出范围的时间视为没有
+bool TimeField(const Variant& todo, const char* key, double* ms) {
+  return NumberField(todo, key, ms) && IsTodoTime(*ms);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// CSV
+
+CsvHeader::Field CsvFieldFromName(std::string_view raw) {
+  std::string name = ToLower(Trim(raw));
+  using Field = CsvHeader::Field;
+  if (name == "id" || name == "uid") return Field::Id;
+  if (name == "title" || name == "name" || name == "summary" || name == "content" ||
+      name == "task")
+    return Field::Title;
+  if (name == "notes" || name == "note" || name == "description") return Field::Notes;
+  if (name == "status" || name == "state") return Field::Status;
+  if (name == "priority") return Field::Priority;
+  if (name == "due" || name == "due date" || name == "due_date" || name == "deadline")
+    return Field::Due;
+  if (name == "tags" || name == "tag" || name == "labels" || name == "categories")
+    return Field::Tags;
+  if (name == "completed_at" || name == "completed" || name == "completed date" ||
+      name == "done")
+    return Field::CompletedAt;
+  if (name == "rrule" || name == "recurrence" || name == "repeat") return Field::Rrule;
+  return Field::Ignore;
+}
+
+void ApplyCsvField(CsvHeader::Field field, std::string& value, TodoFields* todo) {
+  using Field = CsvHeader::Field;
+  if (value.empty()) {
+    return;
+  }
+  switch (field) {
+  case Field::Id:
+    todo->id = std::move(value);
+    break;
+  case Field::Title:
+    todo->title = std::move(value);
+    break;
+  case Field::Notes:
+    todo->notes = std::move(value);
+    break;
+  case Field::Status:
+    todo->status = NormalizeStatus(value);
+    break;
+  case Field::Priority:
+    todo->priority = ParseInt(value);
+    break;
+  case Field::Due:
+    todo->has_due = ParseTodoTime(value.data(), value.size(), &todo->due);
+    break;
+  case Field::Tags:
+    AppendTags(value, ',', ';', &todo->tags);
+    break;
+  case Field::CompletedAt:
+    // 有的工具这一列是完成时间，有的是布尔值
+    if (ParseTodoTime(value.data(), value.size(), &todo->completed_at)) {
+      todo->has_completed = true;
+      todo->status = "done";
+    } else if (NormalizeStatus(value) == "done") {
+      todo->status = "done";
+    }
+    break;
+  case Field::Rrule:
+    todo->rrule = std::move(value);
+    break;
+  default:
+    break;
+  }
+}
+
+// 读取一个字段，返回后pos指向分隔符/换行/结尾
+void ReadCsvField(const char* data, size_t size, size_t* pos, std::string* field) {
+  field->clear();
+  size_t i = *pos;
+  if (i < size && data[i] == '"') {
+    ++i;
+    while (i < size) {
+      const char* quote = static_cast<const char*>(std::memchr(data + i, '"', size - i));
+      if (!quote) {
+        field->append(data + i, size - i);
+        i = size;
+        break;
+      }
+      size_t q = static_cast<size_t>(quote - data);
+      field->append(data + i, q - i);
+      if (q + 1 < size && data[q + 1] == '"') {
+        field->push_back('"');
+        i = q + 2;
+      } else {
+        i = q + 1;
+        break;
+      }
+    }
+  }
+  size_t start = i;
+  while (i < size && data[i] != ',' && data[i] != '\n' && data[i] != '\r') {
+    ++i;
+  }
+  field->append(data + start, i - start);
+  *pos = i;
+}
+
+// 读取一行记录，调用on_field(column, field)，返回记录是否有内容
+template <typename OnField>
+bool ReadCsvRecord(const char* data, size_t size, size_t* pos, std::string* field,
+                   OnField on_field) {
+  size_t column = 0;
+  bool has_content = false;
+  for (;;) {
+    ReadCsvField(data, size, pos, field);
+    if (!field->empty()) {
+      has_content = true;
+    }
+    on_field(column++, *field);
+    if (*pos >= size) {
+      break;
+    }
+    char c = data[*pos];
+    if (c == ',') {
+      ++*pos;
+      continue;
+    }
+    if (c == '\r') {
+      ++*pos;
+    }
+    if (*pos < size && data[*pos] == '\n') {
+      ++*pos;
+    }
+    break;
+  }
+  return has_content;
+}
+
+// 与ReadCsvField一致的扫描状态：引号只在字段开头有特殊含义，
+// 字段中间的引号(如 Buy 2" pipe)是普通字符
+enum class CsvScan : char { FieldStart = 0, Unquoted, Quoted };
+
+// 从pos扫描到end，返回停止位置(引号转义可能越过end一个字节)；
+// stop_at_newline时在引号外的第一个换行之后停止
+size_t ScanCsv(const char* data, size_t size, size_t pos, size_t end, bool stop_at_newline,
+               CsvScan* state) {
+  while (pos < end) {
+    if (*state == CsvScan::Quoted) {
+      const char* quote = static_cast<const char*>(std::memchr(data + pos, '"', end - pos));
+      if (!quote) {
+        return end;
+      }
+      pos = static_cast<size_t>(quote - data) + 1;
+      if (pos < size && data[pos] == '"') {
+        ++pos;
+      } else {
+        // 结束引号之后直到分隔符都按普通字符读取
+        *state = CsvScan::Unquoted;
+      }
+      continue;
+    }
+    char c = data[pos++];
+    if (c == '"' && *state == CsvScan::FieldStart) {
+      *state = CsvScan::Quoted;
+    } else if (c == ',' || c == '\r') {
+      *state = CsvScan::FieldStart;
+    } else if (c == '\n') {
+      *state = CsvScan::FieldStart;
+      if (stop_at_newline) {
+        return pos;
+      }
+    } else {
+      *state = CsvScan::Unquoted;
+    }
+  }
+  return pos;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// iCalendar
+
+// 读取一个逻辑行（处理折行），返回false表示已到结尾
+bool NextICalLine(const char* data, size_t size, size_t* pos, std::string* line) {
+  if (*pos >= size) {
+    return false;
+  }
+  line->clear();
+  for (;;) {
+    const char* nl = static_cast<const char*>(std::memchr(data + *pos, '\n', size - *pos));
+    size_t end = nl ? static_cast<size_t>(nl - data) : size;
+    size_t content_end = (end > *pos && data[end - 1] == '\r') ? end - 1 : end;
+    line->append(data + *pos, content_end - *pos);
+    *pos = nl ? end + 1 : size;
+    // 下一行以空格或tab开头表示折行续接
+    if (*pos < size && (data[*pos] == ' ' || data[*pos] == '\t')) {
+      ++*pos;
+      continue;
+    }
+    return true;
+  }
+}
+
+std::string UnescapeICalText(std::string_view text) {
+  std::string result;
+  result.reserve(text.size());
+  for (size_t i = 0; i < text.size(); ++i) {
+    char c = text[i];
+    if (c == '\\' && i + 1 < text.size()) {
+      char next = text[++i];
+      result.push_back(next == 'n' || next == 'N' ? '\n' : next);
+    } else {
+      result.push_back(c);
+    }
+  }
+  return result;
+}
+
+void AppendICalCategories(std::string_view text, VariantArray* tags) {
+  std::string tag;
+  for (size_t i = 0; i <= text.size(); ++i) {
+    if (i == text.size() || text[i] == ',') {
+      std::string_view trimmed = Trim(tag);
+      if (!trimmed.empty()) {
+        tags->emplace_back(std::string(trimmed));
+      }
+      tag.clear();
+    } else if (text[i] == '\\' && i + 1 < text.size()) {
+      tag.push_back(text[++i]);
+    } else {
+      tag.push_back(text[i]);
+    }
+  }
+}
+
+std::string NormalizeICalStatus(std::string_view value) {
+  if (EqualsIgnoreCase(value, "COMPLETED")) return "done";
+  if (EqualsIgnoreCase(value, "IN-PROCESS")) return "doing";
+  if (EqualsIgnoreCase(value, "CANCELLED")) return "cancelled";
+  return "todo";
+}
+
+const char* ICalStatus(const std::string& status) {
+  if (status == "done") return "COMPLETED";
+  if (status == "doing") return "IN-PROCESS";
+  if (status == "cancelled") return "CANCELLED";
+  return "NEEDS-ACTION";
+}
+
+void ApplyICalProperty(std::string_view name, std::string_view value, TodoFields* todo) {
+  if (EqualsIgnoreCase(name, "UID")) {
+    todo->id = UnescapeICalText(value);
+  } else if (EqualsIgnoreCase(name, "SUMMARY")) {
+    todo->title = UnescapeICalText(value);
+  } else if (EqualsIgnoreCase(name, "DESCRIPTION")) {
+    todo->notes = UnescapeICalText(value);
+  } else if (EqualsIgnoreCase(name, "STATUS")) {
+    todo->status = NormalizeICalStatus(Trim(value));
+  } else if (EqualsIgnoreCase(name, "PRIORITY")) {
+    todo->priority = ParseInt(value);
+  } else if (EqualsIgnoreCase(name, "DUE")) {
+    todo->has_due = ParseTodoTime(value.data(), value.size(), &todo->due);
+  } else if (EqualsIgnoreCase(name, "CATEGORIES")) {
+    AppendICalCategories(value, &todo->tags);
+  } else if (EqualsIgnoreCase(name, "COMPLETED")) {
+    todo->has_completed = ParseTodoTime(value.data(), value.size(), &todo->completed_at);
+  } else if (EqualsIgnoreCase(name, "RRULE")) {
+    todo->rrule = std::string(Trim(value));
+  }
+}
+
+void AppendICalEscaped(const std::string& text, std::string* out) {
+  for (char c : text) {
+    switch (c) {
+    case '\\':
+      out->append("\\\\");
+      break;
+    case ';':
+      out->append("\\;");
+      break;
+    case ',':
+      out->append("\\,");
+      break;
+    case '\n':
+      out->append("\\n");
+      break;
+    case '\r':
+      break;
+    default:
+      out->push_back(c);
+      break;
+    }
+  }
+}
+
+// 按RFC 5545每行不超过75字节折行，不拆开UTF-8多字节字符
+void AppendICalLine(const std::string& line, std::string* out) {
+  constexpr size_t kMaxLine = 75;
+  size_t pos = 0;
+  size_t limit = kMaxLine;
+  while (line.size() - pos > limit) {
+    size_t cut = pos + limit;
+    while (cut > pos && (static_cast<unsigned char>(line[cut]) & 0xC0) == 0x80) {
+      --cut;
+    }
+    out->append(line, pos, cut - pos);
+    out->append("\r\n ");
+    pos = cut;
+    limit = kMaxLine - 1;
+  }
+  out->append(line, pos, std::string::npos);
+  out->append("\r\n");
+}
+
+void AppendCsvField(const std::string& value, std::string* out) {
+  if (value.find_first_of(",\"\r\n") == std::string::npos) {
+    out->append(value);
+    return;
+  }
+  out->push_back('"');
+  for (char c : value) {
+    if (c == '"') {
+      out->push_back('"');
+    }
+    out->push_back(c);
+  }
+  out->push_back('"');
+}
+
+std::string JoinTags(const Variant& todo) {
+  std::string result;
+  const Variant* tags = todo.Find("tags");
+  if (!tags || !tags->IsArray()) {
+    return result;
+  }
+  for (const auto& tag : tags->ArrayRef()) {
+    if (!tag.IsString()) {
+      continue;
+    }
+    if (!result.empty()) {
+      result.push_back(',');
+    }
+    result.append(tag.StringRef());
+  }
+  return result;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// JSON
+
+bool JsonTime(const Variant* value, double* ms) {
+  if (!value) {
+    return false;
+  }
+  if (value->IsDouble()) {
+    *ms = value->AsDouble();
+    return IsTodoTime(*ms);
+  }
+  if (value->IsInt()) {
+    *ms = value->AsInt();
+    return true;
+  }
+  if (value->IsString()) {
+    const std::string& text = value->StringRef();
+    return ParseTodoTime(text.data(), text.size(), ms);
+  }
+  return false;
+}
+
+std::string JsonText(const Variant* value) {
+  if (!value) {
+    return std::string();
+  }
+  if (value->IsString()) {
+    return value->StringRef();
+  }
+  if (value->IsInt()) {
+    return std::to_string(value->AsInt());
+  }
+  if (value->IsDouble()) {
+    return ToJson(*value);
+  }
+  return std::string();
+}
+
+// 把任意来源的todo对象规整成统一字段，缺失的字段补默认值
+void AppendJsonTodo(const Variant& value, VariantArray* out) {
+  if (!value.IsMap()) {
+    return;
+  }
+  TodoFields todo;
+  todo.id = JsonText(value.Find("id"));
+  todo.title = JsonText(value.Find("title"));
+  todo.notes = JsonText(value.Find("notes"));
+  if (todo.Empty()) {
+    return;
+  }
+  const Variant* status = value.Find("status");
+  if (status && status->IsString()) {
+    todo.status = NormalizeStatus(status->StringRef());
+  } else if (status && status->IsBool() && status->AsBool()) {
+    todo.status = "done";
+  }
+  const Variant* priority = value.Find("priority");
+  if (priority && priority->IsInt()) {
+    todo.priority = priority->AsInt();
+  } else if (priority && priority->IsDouble()) {
+    todo.priority = ClampToInt(priority->AsDouble());
+  }
+  todo.has_due = JsonTime(value.Find("due"), &todo.due);
+  todo.has_completed = JsonTime(value.Find("completed_at"), &todo.completed_at);
+  todo.rrule = JsonText(value.Find("rrule"));
+  const Variant* tags = value.Find("tags");
+  if (tags && tags->IsArray()) {
+    for (const auto& tag : tags->ArrayRef()) {
+      if (tag.IsString() && !tag.StringRef().empty()) {
+        todo.tags.push_back(tag);
+      }
+    }
+  } else if (tags && tags->IsString()) {
+    AppendTags(tags->StringRef(), ',', ';', &todo.tags);
+  }
+  out->push_back(todo.ToVariant());
+}
+
+}   // namespace
+
+bool ParseTodoFileFormat(const std::string& name, TodoFileFormat* format) {
+  std::string lower = ToLower(name);
+  if (lower == "csv") {
+    *format = TodoFileFormat::Csv;
+    return true;
+  }
+  if (lower == "ics" || lower == "ical" || lower == "icalendar") {
+    *format = TodoFileFormat::ICalendar;
+    return true;
+  }
+  if (lower == "json") {
+    *format = TodoFileFormat::Json;
+    return true;
+  }
+  return false;
+}
+
+int64_t DaysFromCivil(int64_t y, unsigned m, unsigned d) {
+  y -= m <= 2;
+  const int64_t era = (y >= 0 ? y : y - 399) / 400;
+  const unsigned yoe = static_cast<unsigned>(y - era * 400);
+  const unsigned doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+  const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  return era * 146097 + static_cast<int64_t>(doe) - 719468;
+}
+
+void CivilFromDays(int64_t z, int64_t* year, unsigned* month, unsigned* day) {
+  z += 719468;
+  const int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+  const unsigned doe = static_cast<unsigned>(z - era * 146097);
+  const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+  const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+  const unsigned mp = (5 * doy + 2) / 153;
+  *day = doy - (153 * mp + 2) / 5 + 1;
+  *month = mp < 10 ? mp + 3 : mp - 9;
+  *year = static_cast<int64_t>(yoe) + era * 400 + (*month <= 2);
+}
+
+bool ParseTodoTime(const char* text, size_t len, double* ms) {
+  std::string_view view = Trim(std::string_view(text, len));
+  text = view.data();
+  len = view.size();
+  if (len == 0) {
+    return false;
+  }
+
+  // 纯数字且不是YYYYMMDD时按毫秒时间戳处理
+  bool all_digits = true;
+  for (size_t i = 0; i < len; ++i) {
+    if (text[i] < '0' || text[i] > '9') {
+      all_digits = false;
+      break;
+    }
+  }
+  if (all_digits && len != 8) {
+    *ms = std::strtod(std::string(text, len).c_str(), nullptr);
+    return IsTodoTime(*ms);
+  }
+
+  size_t pos = 0;
+  int year, month, day;
+  if (!ReadDigits(text, len, &pos, 4, &year)) return false;
+  bool extended = pos < len && text[pos] == '-';
+  if (extended) ++pos;
+  if (!ReadDigits(text, len, &pos, 2, &month)) return false;
+  if (extended && (pos >= len || text[pos++] != '-')) return false;
+  if (!ReadDigits(text, len, &pos, 2, &day)) return false;
+  if (month < 1 || month > 12 || day < 1 || day > 31) return false;
+
+  int hour = 0, minute = 0, second = 0, millis = 0;
+  int64_t offset_minutes = 0;
+  if (pos < len && (text[pos] == 'T' || text[pos] == 't' || text[pos] == ' ')) {
+    ++pos;
+    if (!ReadDigits(text, len, &pos, 2, &hour)) return false;
+    if (extended && pos < len && text[pos] == ':') ++pos;
+    if (!ReadDigits(text, len, &pos, 2, &minute)) return false;
+    bool has_seconds = extended ? (pos < len && text[pos] == ':')
+                                : (pos < len && text[pos] >= '0' && text[pos] <= '9');
+    if (has_seconds) {
+      if (extended) ++pos;
+      if (!ReadDigits(text, len, &pos, 2, &second)) return false;
+    }
+    if (pos < len && text[pos] == '.') {
+      ++pos;
+      int scale = 100;
+      for (; pos < len && text[pos] >= '0' && text[pos] <= '9'; ++pos) {
+        millis += (text[pos] - '0') * scale;
+        scale /= 10;
+      }
+    }
+    if (pos < len && (text[pos] == 'Z' || text[pos] == 'z')) {
+      ++pos;
+    } else if (pos < len && (text[pos] == '+' || text[pos] == '-')) {
+      int sign = text[pos] == '-' ? -1 : 1;
+      ++pos;
+      int offset_hour = 0, offset_minute = 0;
+      if (!ReadDigits(text, len, &pos, 2, &offset_hour)) return false;
+      if (pos < len && text[pos] == ':') ++pos;
+      ReadDigits(text, len, &pos, 2, &offset_minute);
+      offset_minutes = sign * (offset_hour * 60 + offset_minute);
+    }
+  }
+  if (pos != len) {
+    return false;
+  }
+
+  int64_t days = DaysFromCivil(year, static_cast<unsigned>(month), static_cast<unsigned>(day));
+  int64_t total = days * kMsPerDay + hour * 3600000LL + minute * 60000LL + second * 1000LL +
+                  millis - offset_minutes * 60000LL;
+  *ms = static_cast<double>(total);
+  return true;
+}
+
+std::string FormatIso8601(double ms) {
+  if (!IsTodoTime(ms)) {
+    return std::string();
+  }
+  int64_t total_ms = static_cast<int64_t>(std::floor(ms));
+  int64_t days = total_ms >= 0 ? total_ms / kMsPerDay : (total_ms - kMsPerDay + 1) / kMsPerDay;
+  int64_t day_ms = total_ms - days * kMsPerDay;
+  int64_t year;
+  unsigned month, day;
+  CivilFromDays(days, &year, &month, &day);
+
+  std::string result = std::to_string(year);
+  result.push_back('-');
+  AppendTwoDigits(static_cast<int>(month), &result);
+  result.push_back('-');
+  AppendTwoDigits(static_cast<int>(day), &result);
+  result.push_back('T');
+  AppendTwoDigits(static_cast<int>(day_ms / 3600000), &result);
+  result.push_back(':');
+  AppendTwoDigits(static_cast<int>(day_ms / 60000 % 60), &result);
+  result.push_back(':');
+  AppendTwoDigits(static_cast<int>(day_ms / 1000 % 60), &result);
+  int millis = static_cast<int>(day_ms % 1000);
+  if (millis != 0) {
+    char buffer[8];
+    std::snprintf(buffer, sizeof(buffer), ".%03d", millis);
+    result.append(buffer);
+  }
+  result.push_back('Z');
+  return result;
+}
+
+VariantMap MakeEmptyTodo() {
+  TodoFields fields;
+  return fields.ToVariant().MapRef();
+}
+
+size_t ParseCsvHeader(const char* data, size_t size, CsvHeader* header) {
+  header->columns.clear();
+  size_t pos = 0;
+  // 跳过UTF-8 BOM
+  if (size >= 3 && static_cast<unsigned char>(data[0]) == 0xEF &&
+      static_cast<unsigned char>(data[1]) == 0xBB && static_cast<unsigned char>(data[2]) == 0xBF) {
+    pos = 3;
+  }
+  std::string field;
+  ReadCsvRecord(data, size, &pos, &field, [header](size_t, const std::string& name) {
+    header->columns.push_back(CsvFieldFromName(name));
+  });
+  return pos;
+}
+
+std::vector<TextChunk> SplitCsv(const char* data, size_t size, size_t offset,
+                                size_t target_bytes) {
+  std::vector<TextChunk> chunks;
+  size_t chunk_begin = offset;
+  size_t pos = offset;
+  CsvScan state = CsvScan::FieldStart;
+  while (chunk_begin < size) {
+    size_t target = chunk_begin + target_bytes;
+    if (target >= size) {
+      chunks.push_back({chunk_begin, size});
+      break;
+    }
+    // 到达目标位置前只需跟踪字段状态，之后在第一个不在引号内的换行处切分
+    if (pos < target) {
+      pos = ScanCsv(data, size, pos, target, false, &state);
+    }
+    size_t cut = ScanCsv(data, size, pos, size, true, &state);
+    pos = cut;
+    chunks.push_back({chunk_begin, cut});
+    chunk_begin = cut;
+  }
+  return chunks;
+}
+
+void ParseCsvChunk(const char* data, size_t size, const CsvHeader& header, VariantArray* out) {
+  size_t pos = 0;
+  std::string field;
+  TodoFields todo;
+  while (pos < size) {
+    todo.Reset();
+    bool has_content =
+      ReadCsvRecord(data, size, &pos, &field, [&header, &todo](size_t column, std::string& value) {
+        if (column < header.columns.size()) {
+          ApplyCsvField(header.columns[column], value, &todo);
+        }
+      });
+    if (has_content && !todo.Empty()) {
+      out->push_back(todo.ToVariant());
+    }
+  }
+}
+
+std::vector<TextChunk> SplitICalendar(const char* data, size_t size, size_t target_bytes) {
+  static constexpr std::string_view kBegin = "\nBEGIN:VTODO";
+  std::string_view text(data, size);
+  std::vector<TextChunk> chunks;
+  size_t chunk_begin = 0;
+  while (chunk_begin < size) {
+    size_t target = chunk_begin + target_bytes;
+    if (target >= size) {
+      chunks.push_back({chunk_begin, size});
+      break;
+    }
+    size_t found = text.find(kBegin, target);
+    size_t cut = found == std::string_view::npos ? size : found + 1;
+    chunks.push_back({chunk_begin, cut});
+    chunk_begin = cut;
+  }
+  return chunks;
+}
+
+void ParseICalendarChunk(const char* data, size_t size, VariantArray* out) {
+  size_t pos = 0;
+  std::string line;
+  TodoFields todo;
+  bool in_todo = false;
+  // VTODO内嵌的VALARM等子组件的属性需要忽略
+  int nested_depth = 0;
+  while (NextICalLine(data, size, &pos, &line)) {
+    std::string_view view(line);
+    // 名称结束于第一个';'或':'，参数值可能带引号
+    size_t name_end = view.find_first_of(";:");
+    if (name_end == std::string_view::npos) {
+      continue;
+    }
+    size_t colon = name_end;
+    bool quoted = false;
+    for (; colon < view.size(); ++colon) {
+      if (view[colon] == '"') {
+        quoted = !quoted;
+      } else if (view[colon] == ':' && !quoted) {
+        break;
+      }
+    }
+    if (colon >= view.size()) {
+      continue;
+    }
+    std::string_view name = view.substr(0, name_end);
+    std::string_view value = view.substr(colon + 1);
+
+    if (EqualsIgnoreCase(name, "BEGIN")) {
+      if (EqualsIgnoreCase(Trim(value), "VTODO")) {
+        todo.Reset();
+        in_todo = true;
+        nested_depth = 0;
+      } else if (in_todo) {
+        ++nested_depth;
+      }
+      continue;
+    }
+    if (EqualsIgnoreCase(name, "END")) {
+      if (in_todo && nested_depth > 0) {
+        --nested_depth;
+      } else if (in_todo && EqualsIgnoreCase(Trim(value), "VTODO")) {
+        out->push_back(todo.ToVariant());
+        in_todo = false;
+      }
+      continue;
+    }
+    if (in_todo && nested_depth == 0) {
+      ApplyICalProperty(name, value, &todo);
+    }
+  }
+}
+
+bool SplitJsonArray(const char* data, size_t size, size_t target_bytes,
+                    std::vector<TextChunk>* chunks, std::string* error) {
+  // 分段做结构扫描，只跟踪深度，不保留整份索引
+  constexpr size_t kScanWindow = 1024 * 1024;
+  framework::JsonStructuralScanner scanner;
+  std::vector<uint32_t> structurals;
+  int depth = 0;
+  bool opened = false;
+  bool closed = false;
+  size_t chunk_begin = 0;
+  size_t pos = 0;
+  while (pos < size && !closed) {
+    size_t window = std::min(kScanWindow, size - pos);
+    bool final = pos + window == size;
+    structurals.clear();
+    size_t scanned = scanner.Scan(data + pos, window, final, 0, &structurals);
+    for (uint32_t offset : structurals) {
+      size_t at = pos + offset;
+      char c = data[at];
+      if (!opened) {
+        if (c != '[') {
+          if (error) *error = "todo array expected";
+          return false;
+        }
+        opened = true;
+        depth = 1;
+        chunk_begin = at + 1;
+        continue;
+      }
+      if (c == '{' || c == '[') {
+        ++depth;
+      } else if (c == '}' || c == ']') {
+        if (--depth == 0) {
+          chunks->push_back({chunk_begin, at});
+          closed = true;
+          break;
+        }
+      } else if (c == ',' && depth == 1 && at - chunk_begin >= target_bytes) {
+        chunks->push_back({chunk_begin, at});
+        chunk_begin = at + 1;
+      }
+    }
+    pos += scanned;
+  }
+  if (!closed) {
+    if (error) *error = opened ? "unterminated todo array" : "todo array expected";
+    return false;
+  }
+  return true;
+}
+
+bool ParseJsonChunk(const char* data, size_t size, VariantArray* out, std::string* error) {
+  framework::JsonStreamParser parser(
+    framework::JsonStreamParser::Mode::TopLevelArray,
+    [out](Variant&& value) { AppendJsonTodo(value, out); });
+  parser.Feed("[", 1);
+  parser.Feed(data, size);
+  parser.Feed("]", 1);
+  if (!parser.Finish()) {
+    if (error) *error = parser.Error();
+    return false;
+  }
+  return true;
+}
+
+void WriteCsvHeader(std::string* out) {
+  out->append("id,title,notes,status,priority,due,tags,completed_at,rrule\r\n");
+}
+
+void WriteCsvRows(const VariantArray& todos, size_t begin, size_t end, std::string* out) {
+  for (size_t i = begin; i < end; ++i) {
+    const Variant& todo = todos[i];
+    if (!todo.IsMap()) {
+      continue;
+    }
+    AppendCsvField(StringField(todo, "id"), out);
+    out->push_back(',');
+    AppendCsvField(StringField(todo, "title"), out);
+    out->push_back(',');
+    AppendCsvField(StringField(todo, "notes"), out);
+    out->push_back(',');
+    AppendCsvField(StringField(todo, "status"), out);
+    out->push_back(',');
+    double number;
+    if (NumberField(todo, "priority", &number)) {
+      out->append(std::to_string(ClampToInt(number)));
+    }
+    out->push_back(',');
+    if (TimeField(todo, "due", &number)) {
+      out->append(FormatIso8601(number));
+    }
+    out->push_back(',');
+    AppendCsvField(JoinTags(todo), out);
+    out->push_back(',');
+    if (TimeField(todo, "completed_at", &number)) {
+      out->append(FormatIso8601(number));
+    }
+    out->push_back(',');
+    AppendCsvField(StringField(todo, "rrule"), out);
+    out->append("\r\n");
+  }
+}
+
+void WriteICalendarHeader(std::string* out) {
+  out->append("BEGIN:VCALENDAR\r\nVERSION:2.0\r\nPRODID:-//life_view//todo//EN\r\n");
+}
+
+void WriteICalendarTodos(const VariantArray& todos, size_t begin, size_t end, double stamp_ms,
+                         std::string* out) {
+  const std::string stamp = FormatICalDateTime(stamp_ms);
+  std::string line;
+  for (size_t i = begin; i < end; ++i) {
+    const Variant& todo = todos[i];
+    if (!todo.IsMap()) {
+      continue;
+    }
+    out->append("BEGIN:VTODO\r\n");
+
+    line = "UID:";
+    AppendICalEscaped(StringField(todo, "id"), &line);
+    AppendICalLine(line, out);
+    out->append("DTSTAMP:").append(stamp).append("\r\n");
+
+    line = "SUMMARY:";
+    AppendICalEscaped(StringField(todo, "title"), &line);
+    AppendICalLine(line, out);
+
+    const std::string& notes = StringField(todo, "notes");
+    if (!notes.empty()) {
+      line = "DESCRIPTION:";
+      AppendICalEscaped(notes, &line);
+      AppendICalLine(line, out);
+    }
+
+    out->append("STATUS:").append(ICalStatus(StringField(todo, "status"))).append("\r\n");
+
+    double number;
+    if (NumberField(todo, "priority", &number) && number > 0) {
+      out->append("PRIORITY:").append(std::to_string(ClampToInt(number))).append("\r\n");
+    }
+    if (TimeField(todo, "due", &number)) {
+      out->append("DUE:").append(FormatICalDateTime(number)).append("\r\n");
+    }
+    const std::string& rrule = StringField(todo, "rrule");
+    if (!rrule.empty()) {
+      AppendICalLine("RRULE:" + rrule, out);
+    }
+
+    const Variant* tags = todo.Find("tags");
+    if (tags && tags->IsArray() && tags->ArraySize() > 0) {
+      line = "CATEGORIES:";
+      bool first = true;
+      for (const auto& tag : tags->ArrayRef()) {
+        if (!tag.IsString()) {
+          continue;
+        }
+        if (!first) {
+          line.push_back(',');
+        }
+        AppendICalEscaped(tag.StringRef(), &line);
+        first = false;
+      }
+      AppendICalLine(line, out);
+    }
+
+    if (TimeField(todo, "completed_at", &number)) {
+      out->append("COMPLETED:").append(FormatICalDateTime(number)).append("\r\n");
+    }
+    out->append("END:VTODO\r\n");
+  }
+}
+
+void WriteICalendarFooter(std::string* out) {
+  out->append("END:VCALENDAR\r\n");
+}
+
+void WriteJsonTodos(const VariantArray& todos, size_t begin, size_t end, bool leading_comma,
+                    std::string* out) {
+  for (size_t i = begin; i < end; ++i) {
+    if (leading_comma) {
+      out->append(",\n");
+    }
+    framework::WriteJson(todos[i], out);
+    leading_comma = true;
+  }
+}
+
+}   // namespace LifeV
@@ -0,0 +1,93 @@
+/*
+ * @Author: Nana5aki
+ * @Date: 2026-10-18 11:05:37
+ * @LastEditors: Nana5aki
+ * @LastEditTime: 2026-10-18 11:05:37
+ * @FilePath: \life_view\backend\src\model\todo\todo_codec.h
+ */
+#pragma once
+
+#include "framework/mvvm/variant.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace LifeV {
+
+enum class TodoFileFormat : char { Csv = 0, ICalendar, Json };
+
+// "csv" / "ics" / "ical" / "json"，不区分大小写
+bool ParseTodoFileFormat(const std::string& name, TodoFileFormat* format);
+
+// 文本块[begin, end)，块边界总在完整记录之间
+struct TextChunk {
+  size_t begin;
+  size_t end;
+};
+
+// CSV列 -> todo字段的映射，由表头解析得到
+struct CsvHeader {
+  enum class Field : char {
+    Ignore = 0,
+    Id,
+    Title,
+    Notes,
+    Status,
+    Priority,
+    Due,
+    Tags,
+    CompletedAt,
+    Rrule,
+  };
+  std::vector<Field> columns;
+};
+
+// 解析首行表头，返回表头之后的偏移
+size_t ParseCsvHeader(const char* data, size_t size, CsvHeader* header);
+
+// 从offset开始按目标大小切分CSV，不会切断引号内的换行
+std::vector<TextChunk> SplitCsv(const char* data, size_t size, size_t offset, size_t target_bytes);
+
+// 解析一个CSV块，结果追加到out
+void ParseCsvChunk(const char* data, size_t size, const CsvHeader& header,
+                   framework::VariantArray* out);
+
+// 按BEGIN:VTODO切分iCalendar
+std::vector<TextChunk> SplitICalendar(const char* data, size_t size, size_t target_bytes);
+
+// 解析一个iCalendar块中的所有VTODO，结果追加到out
+void ParseICalendarChunk(const char* data, size_t size, framework::VariantArray* out);
+
+// JSON格式为todo对象组成的顶层数组。按深度1上的','切分，每块只包含完整元素
+bool SplitJsonArray(const char* data, size_t size, size_t target_bytes,
+                    std::vector<TextChunk>* chunks, std::string* error);
+
+// 解析一个JSON块（逗号分隔的若干元素，不含外层[]），结果追加到out
+bool ParseJsonChunk(const char* data, size_t size, framework::VariantArray* out,
+                    std::string* error);
+
+// 序列化
+void WriteCsvHeader(std::string* out);
+void WriteCsvRows(const framework::VariantArray& todos, size_t begin, size_t end,
+                  std::string* out);
+void WriteICalendarHeader(std::string* out);
+void WriteICalendarTodos(const framework::VariantArray& todos, size_t begin, size_t end,
+                         double stamp_ms, std::string* out);
+void WriteICalendarFooter(std::string* out);
+// leading_comma表示这一段之前已经写过元素
+void WriteJsonTodos(const framework::VariantArray& todos, size_t begin, size_t end,
+                    bool leading_comma, std::string* out);
+
+// 时间工具，时间戳均为UTC毫秒
+// 支持 YYYY-MM-DD、YYYY-MM-DDTHH:MM[:SS][Z]、YYYYMMDD[THHMMSS[Z]] 和纯数字毫秒时间戳。
+// 时间戳范围与JS Date相同(±8.64e15)，超出时解析失败，格式化返回空串
+bool ParseTodoTime(const char* text, size_t len, double* ms);
+std::string FormatIso8601(double ms);
+// 公历日期与1970-01-01起的天数互相转换
+int64_t DaysFromCivil(int64_t y, unsigned m, unsigned d);
+void CivilFromDays(int64_t z, int64_t* year, unsigned* month, unsigned* day);
+
+// 构造一条带默认值的todo
+framework::VariantMap MakeEmptyTodo();
+
+}   // namespace LifeV
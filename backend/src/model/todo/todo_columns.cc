@@ -0,0 +1,331 @@
+/*
+ * @Author: Nana5aki
+ * @Date: 2026-10-18 23:34:51
+ * @LastEditors: Nana5aki
+ * @LastEditTime: 2026-10-18 23:34:51
+ * @FilePath: \life_view\backend\src\model\todo\todo_columns.cc
+ */
+#include "todo_columns.h"
+#include "framework/core/column_kernels.h"
+#include <algorithm>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#  include <intrin.h>
+#endif
+
+namespace LifeV {
+
+using framework::BitmapAnd;
+using framework::BitmapCount;
+using framework::BitmapOr;
+using framework::BitmapWords;
+using framework::RangeMaskInt64;
+using framework::Variant;
+using framework::VariantArray;
+
+namespace {
+
+constexpr int64_t kMsPerDay = 86400000;
+
+int TrailingZeros(uint64_t bits) {
+#if defined(_MSC_VER) && !defined(__clang__)
+  unsigned long index;
+  _BitScanForward64(&index, bits);
+  return static_cast<int>(index);
+#else
+  return __builtin_ctzll(bits);
+#endif
+}
+
+// 对每个置1的位调用fn(行号)
+template <typename Fn>
+void ForEachRow(const std::vector<uint64_t>& mask, Fn fn) {
+  for (size_t word = 0; word < mask.size(); ++word) {
+    uint64_t bits = mask[word];
+    while (bits) {
+      fn(word * 64 + TrailingZeros(bits));
+      bits &= bits - 1;
+    }
+  }
+}
+
+// 超出int64范围(含NaN和无穷)时返回false，直接转换是未定义行为
+bool DoubleToTime(double ms, int64_t* out) {
+  // 2^63
+  constexpr double kLimit = 9223372036854775808.0;
+  if (!(ms >= -kLimit && ms < kLimit)) {
+    return false;
+  }
+  *out = static_cast<int64_t>(ms);
+  return true;
+}
+
+int64_t TimeValue(const Variant& todo, const char* key) {
+  const Variant* value = todo.Find(key);
+  int64_t ms;
+  if (value && value->IsDouble() && DoubleToTime(value->AsDouble(), &ms)) {
+    return ms;
+  }
+  if (value && value->IsInt()) {
+    return value->AsInt();
+  }
+  return TodoColumns::kNoTime;
+}
+
+bool ReadStrings(const Variant& value, const char* key, std::vector<std::string>* out,
+                 std::string* error) {
+  if (value.IsString()) {
+    out->push_back(value.StringRef());
+    return true;
+  }
+  if (value.IsArray()) {
+    for (const auto& item : value.ArrayRef()) {
+      if (!item.IsString()) {
+        *error = std::string(key) + " expects strings";
+        return false;
+      }
+      out->push_back(item.StringRef());
+    }
+    return true;
+  }
+  *error = std::string(key) + " expects a string or an array of strings";
+  return false;
+}
+
+bool ReadTime(const Variant& params, const char* key, bool* enabled, int64_t* out,
+              std::string* error) {
+  const Variant* value = params.Find(key);
+  if (!value || value->IsNull()) {
+    return true;
+  }
+  if (value->IsInt()) {
+    *out = value->AsInt();
+  } else if (!value->IsDouble() || !DoubleToTime(value->AsDouble(), out)) {
+    *error = std::string(key) + " expects a timestamp in milliseconds";
+    return false;
+  }
+  *enabled = true;
+  return true;
+}
+
+// 位图和时间范围求与；没有时间的行(kNoTime)总是被排除
+void AndTimeRange(const std::vector<int64_t>& column, const TodoFilter::TimeRange& range,
+                  std::vector<uint64_t>* mask, std::vector<uint64_t>* scratch) {
+  if (!range.enabled) {
+    return;
+  }
+  scratch->resize(mask->size());
+  int64_t from = std::max(range.from, TodoColumns::kNoTime + 1);
+  RangeMaskInt64(column.data(), column.size(), from, range.to, scratch->data());
+  BitmapAnd(mask->data(), scratch->data(), mask->size());
+}
+
+}   // namespace
+
+int64_t TodoDayIndex(int64_t ms) {
+  int64_t day = ms / kMsPerDay;
+  return (ms % kMsPerDay != 0 && ms < 0) ? day - 1 : day;
+}
+
+bool ParseTodoFilter(const Variant& params, TodoFilter* filter, std::string* error) {
+  *filter = TodoFilter();
+  if (params.IsNull()) {
+    return true;
+  }
+  if (!params.IsMap()) {
+    *error = "filter expects an object";
+    return false;
+  }
+  const Variant* status = params.Find("status");
+  if (status && !status->IsNull() && !ReadStrings(*status, "status", &filter->statuses, error)) {
+    return false;
+  }
+  const Variant* tags = params.Find("tags");
+  if (tags && !tags->IsNull() && !ReadStrings(*tags, "tags", &filter->tags, error)) {
+    return false;
+  }
+  return ReadTime(params, "due_from", &filter->due.enabled, &filter->due.from, error) &&
+         ReadTime(params, "due_to", &filter->due.enabled, &filter->due.to, error) &&
+         ReadTime(params, "completed_from", &filter->completed.enabled, &filter->completed.from,
+                  error) &&
+         ReadTime(params, "completed_to", &filter->completed.enabled, &filter->completed.to, error);
+}
+
+bool ParseTodoGroupKey(const std::string& name, TodoGroupKey* key) {
+  if (name == "status") {
+    *key = TodoGroupKey::Status;
+  } else if (name == "tag") {
+    *key = TodoGroupKey::Tag;
+  } else if (name == "due_day") {
+    *key = TodoGroupKey::DueDay;
+  } else if (name == "completed_day") {
+    *key = TodoGroupKey::CompletedDay;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+void TodoColumns::Append(const VariantArray& todos) {
+  size_t words = BitmapWords(rows_.size() + todos.size());
+  for (auto& bits : status_bits_) {
+    bits.resize(words, 0);
+  }
+  rows_.reserve(rows_.size() + todos.size());
+  due_.reserve(rows_.size() + todos.size());
+  completed_.reserve(rows_.size() + todos.size());
+
+  static const std::string empty;
+  for (const auto& todo : todos) {
+    size_t row = rows_.size();
+    rows_.push_back(&todo);
+    if (!todo.IsMap()) {
+      AddStatus(empty, row, words);
+      due_.push_back(kNoTime);
+      completed_.push_back(kNoTime);
+      continue;
+    }
+    const Variant* status = todo.Find("status");
+    AddStatus(status && status->IsString() ? status->StringRef() : empty, row, words);
+    due_.push_back(TimeValue(todo, "due"));
+    completed_.push_back(TimeValue(todo, "completed_at"));
+    const Variant* tags = todo.Find("tags");
+    if (tags && tags->IsArray()) {
+      for (const auto& tag : tags->ArrayRef()) {
+        if (tag.IsString()) {
+          AddTag(tag.StringRef(), static_cast<uint32_t>(row));
+        }
+      }
+    }
+  }
+}
+
+void TodoColumns::AddStatus(const std::string& status, size_t row, size_t words) {
+  // 状态只有几种，线性查找比哈希快
+  size_t code = 0;
+  while (code < status_names_.size() && status_names_[code] != status) {
+    ++code;
+  }
+  if (code == status_names_.size()) {
+    status_names_.push_back(status);
+    status_bits_.emplace_back(words, 0);
+  }
+  status_bits_[code][row / 64] |= 1ULL << (row % 64);
+}
+
+void TodoColumns::AddTag(const std::string& tag, uint32_t row) {
+  auto it = tag_codes_.find(tag);
+  if (it == tag_codes_.end()) {
+    it = tag_codes_.emplace(tag, static_cast<uint32_t>(tag_names_.size())).first;
+    tag_names_.push_back(tag);
+    tag_rows_.emplace_back();
+  }
+  std::vector<uint32_t>& rows = tag_rows_[it->second];
+  // 同一todo重复的标签只记一次
+  if (rows.empty() || rows.back() != row) {
+    rows.push_back(row);
+  }
+}
+
+void TodoColumns::Clear() {
+  *this = TodoColumns();
+}
+
+void TodoColumns::Filter(const TodoFilter& filter, std::vector<uint64_t>* mask) const {
+  size_t words = BitmapWords(rows_.size());
+  mask->assign(words, ~0ULL);
+  if (rows_.size() % 64 != 0) {
+    mask->back() = (1ULL << (rows_.size() % 64)) - 1;
+  }
+
+  std::vector<uint64_t> scratch;
+  if (!filter.statuses.empty()) {
+    scratch.assign(words, 0);
+    for (const auto& status : filter.statuses) {
+      auto it = std::find(status_names_.begin(), status_names_.end(), status);
+      if (it != status_names_.end()) {
+        BitmapOr(scratch.data(), status_bits_[it - status_names_.begin()].data(), words);
+      }
+    }
+    BitmapAnd(mask->data(), scratch.data(), words);
+  }
+  if (!filter.tags.empty()) {
+    scratch.assign(words, 0);
+    for (const auto& tag : filter.tags) {
+      auto it = tag_codes_.find(tag);
+      if (it == tag_codes_.end()) {
+        continue;
+      }
+      for (uint32_t row : tag_rows_[it->second]) {
+        scratch[row / 64] |= 1ULL << (row % 64);
+      }
+    }
+    BitmapAnd(mask->data(), scratch.data(), words);
+  }
+  AndTimeRange(due_, filter.due, mask, &scratch);
+  AndTimeRange(completed_, filter.completed, mask, &scratch);
+}
+
+size_t TodoColumns::Count(const TodoFilter& filter) const {
+  std::vector<uint64_t> mask;
+  Filter(filter, &mask);
+  return BitmapCount(mask.data(), mask.size());
+}
+
+size_t TodoColumns::CollectRows(const std::vector<uint64_t>& mask, size_t offset, size_t limit,
+                                std::vector<const Variant*>* rows) const {
+  size_t skipped = 0;
+  for (size_t word = 0; word < mask.size() && rows->size() < limit; ++word) {
+    uint64_t bits = mask[word];
+    while (bits && rows->size() < limit) {
+      if (skipped < offset) {
+        ++skipped;
+      } else {
+        rows->push_back(rows_[word * 64 + TrailingZeros(bits)]);
+      }
+      bits &= bits - 1;
+    }
+  }
+  return BitmapCount(mask.data(), mask.size());
+}
+
+void TodoColumns::CountByStatus(const std::vector<uint64_t>& mask,
+                                std::vector<std::pair<std::string, size_t>>* groups) const {
+  std::vector<uint64_t> scratch;
+  for (size_t code = 0; code < status_names_.size(); ++code) {
+    scratch = status_bits_[code];
+    BitmapAnd(scratch.data(), mask.data(), scratch.size());
+    size_t count = BitmapCount(scratch.data(), scratch.size());
+    if (count) {
+      groups->emplace_back(status_names_[code], count);
+    }
+  }
+}
+
+void TodoColumns::CountByTag(const std::vector<uint64_t>& mask,
+                             std::vector<std::pair<std::string, size_t>>* groups) const {
+  for (size_t code = 0; code < tag_names_.size(); ++code) {
+    size_t count = 0;
+    for (uint32_t row : tag_rows_[code]) {
+      count += (mask[row / 64] >> (row % 64)) & 1;
+    }
+    if (count) {
+      groups->emplace_back(tag_names_[code], count);
+    }
+  }
+}
+
+void TodoColumns::CountByDay(TodoGroupKey key, const std::vector<uint64_t>& mask,
+                             int64_t from_day, size_t days, std::vector<size_t>* counts) const {
+  counts->assign(days, 0);
+  const std::vector<int64_t>& column = key == TodoGroupKey::CompletedDay ? completed_ : due_;
+  // 先用范围核函数去掉区间外的行，剩下的行再逐个算日期
+  int64_t from = from_day * kMsPerDay;
+  std::vector<uint64_t> selected(mask.size());
+  RangeMaskInt64(column.data(), column.size(), from,
+                 from + static_cast<int64_t>(days) * kMsPerDay, selected.data());
+  BitmapAnd(selected.data(), mask.data(), selected.size());
+  ForEachRow(selected, [&](size_t row) { ++(*counts)[(column[row] - from) / kMsPerDay]; });
+}
+
+}   // namespace LifeV
@@ -0,0 +1,99 @@
+/*
+ * @Author: Nana5aki
+ * @Date: 2026-10-18 23:34:51
+ * @LastEditors: Nana5aki
+ * @LastEditTime: 2026-10-18 23:34:51
+ * @FilePath: \life_view\backend\src\model\todo\todo_columns.h
+ */
+#pragma once
+
+#include "framework/mvvm/variant.h"
+#include <climits>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace LifeV {
+
+// 过滤条件，未设置的条件不过滤，各条件之间为与
+struct TodoFilter {
+  struct TimeRange {
+    bool enabled = false;
+    // [from, to)，毫秒时间戳；启用时没有该时间的todo不匹配
+    int64_t from = INT64_MIN;
+    int64_t to = INT64_MAX;
+  };
+
+  // 状态为其中任一
+  std::vector<std::string> statuses;
+  // 含其中任一标签
+  std::vector<std::string> tags;
+  TimeRange due;
+  TimeRange completed;
+};
+
+// 从命令参数解析: { status?: string|string[], tags?: string|string[],
+//                   due_from?, due_to?, completed_from?, completed_to? }
+bool ParseTodoFilter(const framework::Variant& params, TodoFilter* filter, std::string* error);
+
+enum class TodoGroupKey : char { Status = 0, Tag, DueDay, CompletedDay };
+
+// "status" / "tag" / "due_day" / "completed_day"
+bool ParseTodoGroupKey(const std::string& name, TodoGroupKey* key);
+
+// 毫秒时间戳所在的UTC日，1970-01-01为0
+int64_t TodoDayIndex(int64_t ms);
+
+// todo集合的列式副本，供统计查询使用，随TodoModel的段追加。
+//   status        字典编码，每个状态一张行位图
+//   due/completed int64毫秒时间戳列，没有时为kNoTime
+//   tags          字典编码，每个标签一个按行号递增的行列表
+// 查询先用SIMD核函数得到行位图，再按位图计数或分组
+class TodoColumns {
+public:
+  static constexpr int64_t kNoTime = INT64_MIN;
+
+  // 只能在主线程调用；rows中的元素地址需要在Clear前保持不变
+  void Append(const framework::VariantArray& todos);
+  void Clear();
+
+  size_t Rows() const {
+    return rows_.size();
+  }
+
+  // 满足filter的行位图，BitmapWords(Rows())个字
+  void Filter(const TodoFilter& filter, std::vector<uint64_t>* mask) const;
+  size_t Count(const TodoFilter& filter) const;
+
+  // 按行号顺序取mask中跳过offset行之后的至多limit行，返回mask中的总行数
+  size_t CollectRows(const std::vector<uint64_t>& mask, size_t offset, size_t limit,
+                     std::vector<const framework::Variant*>* rows) const;
+
+  // 按状态或标签分组计数，只统计mask中的行，跳过计数为0的分组
+  void CountByStatus(const std::vector<uint64_t>& mask,
+                     std::vector<std::pair<std::string, size_t>>* groups) const;
+  void CountByTag(const std::vector<uint64_t>& mask,
+                  std::vector<std::pair<std::string, size_t>>* groups) const;
+  // 按UTC日期分组：counts[i]为第from_day + i天(TodoDayIndex)的行数
+  void CountByDay(TodoGroupKey key, const std::vector<uint64_t>& mask, int64_t from_day,
+                  size_t days, std::vector<size_t>* counts) const;
+
+private:
+  // words为追加后位图的字数
+  void AddStatus(const std::string& status, size_t row, size_t words);
+  void AddTag(const std::string& tag, uint32_t row);
+
+private:
+  std::vector<const framework::Variant*> rows_;
+  std::vector<std::string> status_names_;
+  std::vector<std::vector<uint64_t>> status_bits_;
+  std::vector<int64_t> due_;
+  std::vector<int64_t> completed_;
+  std::unordered_map<std::string, uint32_t> tag_codes_;
+  std::vector<std::string> tag_names_;
+  std::vector<std::vector<uint32_t>> tag_rows_;
+};
+
+}   // namespace LifeV
@@ -0,0 +1,28 @@
+/*
+ * @Author: Nana5aki
+ * @Date: 2026-10-18 10:48:22
+ * @LastEditors: Nana5aki
+ * @LastEditTime: 2026-10-18 10:48:22
+ * @FilePath: \life_view\backend\src\model\todo\todo_model.cc
+ */
+#include "todo_model.h"
+
+namespace LifeV {
+
+TodoSegment TodoModel::AppendSegment(framework::VariantArray&& todos) {
+  if (todos.empty()) {
+    return nullptr;
+  }
+  size_ += todos.size();
+  segments_.push_back(std::make_shared<const framework::VariantArray>(std::move(todos)));
+  columns_.Append(*segments_.back());
+  return segments_.back();
+}
+
+void TodoModel::Clear() {
+  segments_.clear();
+  columns_.Clear();
+  size_ = 0;
+}
+
+}   // namespace LifeV
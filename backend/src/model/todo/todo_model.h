@@ -0,0 +1,55 @@
+/*
+ * @Author: Nana5aki
+ * @Date: 2026-10-18 10:48:22
+ * @LastEditors: Nana5aki
+ * @LastEditTime: 2026-10-18 10:48:22
+ * @FilePath: \life_view\backend\src\model\todo\todo_model.h
+ */
+#pragma once
+
+#include "framework/mvvm/model.h"
+#include "framework/mvvm/variant.h"
+#include "todo_columns.h"
+#include <memory>
+#include <vector>
+
+namespace LifeV {
+
+// 单条todo为VariantMap:
+//   id(string) title(string) notes(string) status(string: todo/doing/done/cancelled)
+//   priority(int) due(double, 毫秒时间戳, 无则Null) tags(array<string>)
+//   completed_at(double, 毫秒时间戳, 无则Null)
+//   rrule(string, RFC 5545 RRULE的值如"FREQ=WEEKLY;BYDAY=MO", 以due为起点, 无则Null)
+using TodoSegment = std::shared_ptr<const framework::VariantArray>;
+
+// todo集合按段存储：批量导入按块顺序追加一个段，导出时拷贝段指针即可得到快照。
+// 同时维护一份列式副本用于统计查询
+class TodoModel : public framework::Model {
+public:
+  TodoModel() = default;
+
+  // 只能在主线程调用。返回新追加的段，todos为空时返回nullptr
+  TodoSegment AppendSegment(framework::VariantArray&& todos);
+  void Clear();
+
+  size_t Size() const {
+    return size_;
+  }
+
+  // 返回当前所有段的快照，可在后台线程读取
+  std::vector<TodoSegment> Snapshot() const {
+    return segments_;
+  }
+
+  // 只能在主线程读取
+  const TodoColumns& Columns() const {
+    return columns_;
+  }
+
+private:
+  std::vector<TodoSegment> segments_;
+  TodoColumns columns_;
+  size_t size_ = 0;
+};
+
+}   // namespace LifeV
@@ -0,0 +1,447 @@
+/*
+ * @Author: Nana5aki
+ * @Date: 2026-10-18 22:20:43
+ * @LastEditors: Nana5aki
+ * @LastEditTime: 2026-10-18 22:20:43
+ * @FilePath: \life_view\backend\src\model\todo\todo_recurrence.cc
+ */
+#include "todo_recurrence.h"
+#include "todo_codec.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <string_view>
+
+namespace LifeV {
+
+namespace {
+
+constexpr int64_t kMsPerDay = 86400000;
+// 连续这么多个周期没有任何发生时放弃，例如 FREQ=YEARLY;BYMONTH=2;BYMONTHDAY=30
+constexpr int kMaxEmptyPeriods = 4000;
+constexpr int64_t kMaxYear = 9999;
+constexpr double kMaxTimeMs = 8.64e15;
+
+int64_t FloorDiv(int64_t a, int64_t b) {
+  int64_t q = a / b;
+  return (a % b != 0 && (a < 0) != (b < 0)) ? q - 1 : q;
+}
+
+int Mod7(int64_t value) {
+  return static_cast<int>(((value % 7) + 7) % 7);
+}
+
+// 1970-01-01是周四
+int WeekdayOfDay(int64_t day) {
+  return Mod7(day + 3);
+}
+
+int64_t DaysInMonth(int64_t year, unsigned month) {
+  int64_t next = month == 12 ? DaysFromCivil(year + 1, 1, 1) : DaysFromCivil(year, month + 1, 1);
+  return next - DaysFromCivil(year, month, 1);
+}
+
+bool EqualsIgnoreCase(std::string_view a, std::string_view b) {
+  if (a.size() != b.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < a.size(); ++i) {
+    char c = a[i];
+    if (c >= 'a' && c <= 'z') {
+      c = static_cast<char>(c - 'a' + 'A');
+    }
+    if (c != b[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool ParseNumber(std::string_view text, int* value) {
+  if (text.empty() || text.size() > 9) {
+    return false;
+  }
+  size_t pos = 0;
+  int sign = 1;
+  if (text[0] == '+' || text[0] == '-') {
+    sign = text[0] == '-' ? -1 : 1;
+    ++pos;
+  }
+  if (pos == text.size()) {
+    return false;
+  }
+  int result = 0;
+  for (; pos < text.size(); ++pos) {
+    if (text[pos] < '0' || text[pos] > '9') {
+      return false;
+    }
+    result = result * 10 + (text[pos] - '0');
+  }
+  *value = sign * result;
+  return true;
+}
+
+bool ParseWeekday(std::string_view text, int* weekday) {
+  static const char* const kNames[] = {"MO", "TU", "WE", "TH", "FR", "SA", "SU"};
+  for (int i = 0; i < 7; ++i) {
+    if (EqualsIgnoreCase(text, kNames[i])) {
+      *weekday = i;
+      return true;
+    }
+  }
+  return false;
+}
+
+// 逗号分隔的列表，每项交给parse_item
+template <typename ParseItem>
+bool ParseList(std::string_view text, ParseItem parse_item) {
+  while (true) {
+    size_t comma = text.find(',');
+    if (!parse_item(text.substr(0, comma))) {
+      return false;
+    }
+    if (comma == std::string_view::npos) {
+      return true;
+    }
+    text.remove_prefix(comma + 1);
+  }
+}
+
+bool ParsePart(std::string_view name, std::string_view value, Recurrence* rule) {
+  using Frequency = Recurrence::Frequency;
+  if (EqualsIgnoreCase(name, "FREQ")) {
+    if (EqualsIgnoreCase(value, "DAILY")) {
+      rule->frequency = Frequency::Daily;
+    } else if (EqualsIgnoreCase(value, "WEEKLY")) {
+      rule->frequency = Frequency::Weekly;
+    } else if (EqualsIgnoreCase(value, "MONTHLY")) {
+      rule->frequency = Frequency::Monthly;
+    } else if (EqualsIgnoreCase(value, "YEARLY")) {
+      rule->frequency = Frequency::Yearly;
+    } else {
+      return false;
+    }
+    return true;
+  }
+  if (EqualsIgnoreCase(name, "INTERVAL")) {
+    return ParseNumber(value, &rule->interval) && rule->interval >= 1;
+  }
+  if (EqualsIgnoreCase(name, "COUNT")) {
+    return ParseNumber(value, &rule->count) && rule->count >= 1;
+  }
+  if (EqualsIgnoreCase(name, "UNTIL")) {
+    rule->has_until = ParseTodoTime(value.data(), value.size(), &rule->until);
+    return rule->has_until;
+  }
+  if (EqualsIgnoreCase(name, "WKST")) {
+    return ParseWeekday(value, &rule->week_start);
+  }
+  if (EqualsIgnoreCase(name, "BYDAY")) {
+    return ParseList(value, [rule](std::string_view item) {
+      Recurrence::WeekDay day;
+      if (item.size() < 2 || !ParseWeekday(item.substr(item.size() - 2), &day.weekday)) {
+        return false;
+      }
+      std::string_view ordinal = item.substr(0, item.size() - 2);
+      if (!ordinal.empty() &&
+          (!ParseNumber(ordinal, &day.ordinal) || day.ordinal == 0 || std::abs(day.ordinal) > 53)) {
+        return false;
+      }
+      rule->by_day.push_back(day);
+      return true;
+    });
+  }
+  if (EqualsIgnoreCase(name, "BYMONTHDAY")) {
+    return ParseList(value, [rule](std::string_view item) {
+      int day;
+      if (!ParseNumber(item, &day) || day == 0 || std::abs(day) > 31) {
+        return false;
+      }
+      rule->by_month_day.push_back(day);
+      return true;
+    });
+  }
+  if (EqualsIgnoreCase(name, "BYMONTH")) {
+    return ParseList(value, [rule](std::string_view item) {
+      int month;
+      if (!ParseNumber(item, &month) || month < 1 || month > 12) {
+        return false;
+      }
+      rule->by_month.push_back(month);
+      return true;
+    });
+  }
+  // BYSETPOS、BYHOUR、BYWEEKNO等暂不支持
+  return false;
+}
+
+bool MonthAllowed(const Recurrence& rule, unsigned month) {
+  return rule.by_month.empty() ||
+         std::find(rule.by_month.begin(), rule.by_month.end(), static_cast<int>(month)) !=
+           rule.by_month.end();
+}
+
+// [first, first + length)范围内BYDAY匹配的天，序号相对这个范围
+void AppendWeekdays(const Recurrence& rule, int64_t first, int64_t length,
+                    std::vector<int64_t>* days) {
+  int64_t last = first + length - 1;
+  for (const auto& item : rule.by_day) {
+    if (item.ordinal == 0) {
+      for (int64_t day = first + Mod7(item.weekday - WeekdayOfDay(first)); day <= last; day += 7) {
+        days->push_back(day);
+      }
+    } else if (item.ordinal > 0) {
+      int64_t day = first + Mod7(item.weekday - WeekdayOfDay(first)) + 7 * (item.ordinal - 1);
+      if (day <= last) {
+        days->push_back(day);
+      }
+    } else {
+      int64_t day = last - Mod7(WeekdayOfDay(last) - item.weekday) + 7 * (item.ordinal + 1);
+      if (day >= first) {
+        days->push_back(day);
+      }
+    }
+  }
+}
+
+// 某个月中的发生日，BYMONTHDAY和BYDAY同时存在时取交集
+void AppendMonthDays(const Recurrence& rule, int64_t year, unsigned month, unsigned start_day,
+                     std::vector<int64_t>* days) {
+  int64_t first = DaysFromCivil(year, month, 1);
+  int64_t length = DaysInMonth(year, month);
+  if (rule.by_month_day.empty() && rule.by_day.empty()) {
+    // 没有这一天的月份跳过，例如每月31日
+    if (start_day <= length) {
+      days->push_back(first + start_day - 1);
+    }
+    return;
+  }
+
+  std::vector<int64_t> month_days;
+  for (int day : rule.by_month_day) {
+    int64_t index = day > 0 ? day : length + day + 1;
+    if (index >= 1 && index <= length) {
+      month_days.push_back(first + index - 1);
+    }
+  }
+  if (rule.by_day.empty()) {
+    days->insert(days->end(), month_days.begin(), month_days.end());
+    return;
+  }
+  std::vector<int64_t> weekdays;
+  AppendWeekdays(rule, first, length, &weekdays);
+  for (int64_t day : weekdays) {
+    if (rule.by_month_day.empty() ||
+        std::find(month_days.begin(), month_days.end(), day) != month_days.end()) {
+      days->push_back(day);
+    }
+  }
+}
+
+// 第period个周期内的发生日(升序，未按起始时间过滤)
+void PeriodDays(const Recurrence& rule, int64_t start_day, int64_t period,
+                std::vector<int64_t>* days) {
+  using Frequency = Recurrence::Frequency;
+  int64_t start_year;
+  unsigned start_month, start_mday;
+  CivilFromDays(start_day, &start_year, &start_month, &start_mday);
+
+  days->clear();
+  switch (rule.frequency) {
+  case Frequency::Daily: {
+    int64_t day = start_day + period * rule.interval;
+    int64_t year;
+    unsigned month, mday;
+    CivilFromDays(day, &year, &month, &mday);
+    if (!MonthAllowed(rule, month)) {
+      break;
+    }
+    if (!rule.by_month_day.empty() || !rule.by_day.empty()) {
+      // 日频率下BY规则只做过滤
+      std::vector<int64_t> month_days;
+      AppendMonthDays(rule, year, month, mday, &month_days);
+      if (std::find(month_days.begin(), month_days.end(), day) == month_days.end()) {
+        break;
+      }
+    }
+    days->push_back(day);
+    break;
+  }
+  case Frequency::Weekly: {
+    int64_t week = start_day - Mod7(WeekdayOfDay(start_day) - rule.week_start) +
+                   period * rule.interval * 7;
+    if (rule.by_day.empty()) {
+      days->push_back(week + Mod7(WeekdayOfDay(start_day) - rule.week_start));
+    } else {
+      for (const auto& item : rule.by_day) {
+        days->push_back(week + Mod7(item.weekday - rule.week_start));
+      }
+    }
+    days->erase(std::remove_if(days->begin(),
+                               days->end(),
+                               [&rule](int64_t day) {
+                                 int64_t year;
+                                 unsigned month, mday;
+                                 CivilFromDays(day, &year, &month, &mday);
+                                 return !MonthAllowed(rule, month);
+                               }),
+                days->end());
+    break;
+  }
+  case Frequency::Monthly: {
+    int64_t months = start_year * 12 + (start_month - 1) + period * rule.interval;
+    int64_t year = FloorDiv(months, 12);
+    unsigned month = static_cast<unsigned>(months - year * 12 + 1);
+    if (MonthAllowed(rule, month)) {
+      AppendMonthDays(rule, year, month, start_mday, days);
+    }
+    break;
+  }
+  case Frequency::Yearly: {
+    int64_t year = start_year + period * rule.interval;
+    if (!rule.by_month.empty()) {
+      for (int month : rule.by_month) {
+        AppendMonthDays(rule, year, static_cast<unsigned>(month), start_mday, days);
+      }
+    } else if (!rule.by_month_day.empty()) {
+      for (unsigned month = 1; month <= 12; ++month) {
+        AppendMonthDays(rule, year, month, start_mday, days);
+      }
+    } else if (!rule.by_day.empty()) {
+      // 没有BYMONTH时BYDAY的序号相对整年
+      int64_t first = DaysFromCivil(year, 1, 1);
+      AppendWeekdays(rule, first, DaysFromCivil(year + 1, 1, 1) - first, days);
+    } else {
+      AppendMonthDays(rule, year, start_month, start_mday, days);
+    }
+    break;
+  }
+  }
+  std::sort(days->begin(), days->end());
+  days->erase(std::unique(days->begin(), days->end()), days->end());
+}
+
+// 不限次数时可以直接从after_ms所在的周期开始展开
+int64_t FirstPeriodAfter(const Recurrence& rule, int64_t start_day, int64_t after_day) {
+  using Frequency = Recurrence::Frequency;
+  if (rule.count > 0 || after_day <= start_day) {
+    return 0;
+  }
+  int64_t start_year, after_year;
+  unsigned start_month, after_month, mday;
+  CivilFromDays(start_day, &start_year, &start_month, &mday);
+  CivilFromDays(after_day, &after_year, &after_month, &mday);
+  switch (rule.frequency) {
+  case Frequency::Daily:
+    return FloorDiv(after_day - start_day, rule.interval);
+  case Frequency::Weekly: {
+    int64_t week = start_day - Mod7(WeekdayOfDay(start_day) - rule.week_start);
+    return FloorDiv(after_day - week, 7 * static_cast<int64_t>(rule.interval));
+  }
+  case Frequency::Monthly:
+    return FloorDiv((after_year - start_year) * 12 + after_month - start_month, rule.interval);
+  case Frequency::Yearly:
+    return FloorDiv(after_year - start_year, rule.interval);
+  }
+  return 0;
+}
+
+}   // namespace
+
+bool ParseRecurrence(const std::string& text, Recurrence* rule) {
+  std::string_view view(text);
+  if (view.size() >= 6 && EqualsIgnoreCase(view.substr(0, 6), "RRULE:")) {
+    view.remove_prefix(6);
+  }
+  *rule = Recurrence();
+  bool has_frequency = false;
+  while (!view.empty()) {
+    size_t end = view.find(';');
+    std::string_view part = view.substr(0, end);
+    view = end == std::string_view::npos ? std::string_view() : view.substr(end + 1);
+    if (part.empty()) {
+      continue;
+    }
+    size_t equal = part.find('=');
+    if (equal == std::string_view::npos) {
+      return false;
+    }
+    std::string_view name = part.substr(0, equal);
+    if (!ParsePart(name, part.substr(equal + 1), rule)) {
+      return false;
+    }
+    has_frequency = has_frequency || EqualsIgnoreCase(name, "FREQ");
+  }
+  return has_frequency;
+}
+
+bool NextOccurrence(const Recurrence& rule, double start_ms, double after_ms, double* next_ms,
+                    RecurrenceCursor* cursor) {
+  // 也排除了NaN和Infinity
+  if (!(std::abs(start_ms) <= kMaxTimeMs) || !(std::abs(after_ms) <= kMaxTimeMs)) {
+    return false;
+  }
+  if (rule.has_until && start_ms > rule.until) {
+    return false;
+  }
+  // 起始时间本身总是第一次发生
+  if (start_ms > after_ms) {
+    *next_ms = start_ms;
+    if (cursor) {
+      *cursor = RecurrenceCursor{0, 1, start_ms};
+    }
+    return true;
+  }
+
+  int64_t start = static_cast<int64_t>(std::floor(start_ms));
+  int64_t start_day = FloorDiv(start, kMsPerDay);
+  int64_t time_of_day = start - start_day * kMsPerDay;
+  int64_t after_day = FloorDiv(static_cast<int64_t>(std::floor(after_ms)), kMsPerDay);
+
+  // 已数过的发生(不晚于skip_until的)不再计数
+  int produced = 1;
+  double skip_until = start_ms;
+  int64_t first_period = FirstPeriodAfter(rule, start_day, after_day);
+  if (rule.count > 0 && cursor && cursor->produced > 0 && cursor->last_ms <= after_ms) {
+    first_period = cursor->period;
+    produced = cursor->produced;
+    skip_until = cursor->last_ms;
+  }
+  int empty_periods = 0;
+  std::vector<int64_t> days;
+  for (int64_t period = first_period;; ++period) {
+    PeriodDays(rule, start_day, period, &days);
+    if (days.empty()) {
+      if (++empty_periods > kMaxEmptyPeriods) {
+        return false;
+      }
+      continue;
+    }
+    empty_periods = 0;
+    for (int64_t day : days) {
+      int64_t time = day * kMsPerDay + time_of_day;
+      if (time <= skip_until) {
+        continue;
+      }
+      int64_t year;
+      unsigned month, mday;
+      CivilFromDays(day, &year, &month, &mday);
+      if (year > kMaxYear || (rule.has_until && time > rule.until)) {
+        return false;
+      }
+      if (rule.count > 0 && ++produced > rule.count) {
+        return false;
+      }
+      if (time > after_ms) {
+        *next_ms = static_cast<double>(time);
+        if (cursor) {
+          *cursor = RecurrenceCursor{period, produced, *next_ms};
+        }
+        return true;
+      }
+    }
+  }
+}
+
+}   // namespace LifeV
@@ -0,0 +1,61 @@
+/*
+ * @Author: Nana5aki
+ * @Date: 2026-10-18 22:20:43
+ * @LastEditors: Nana5aki
+ * @LastEditTime: 2026-10-18 22:20:43
+ * @FilePath: \life_view\backend\src\model\todo\todo_recurrence.h
+ */
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace LifeV {
+
+// RFC 5545 RRULE的子集，按UTC展开（与todo的时间戳一致），时分秒取自起始时间。
+// 支持 FREQ=DAILY/WEEKLY/MONTHLY/YEARLY、INTERVAL、COUNT、UNTIL、WKST、
+// BYDAY(MONTHLY/YEARLY可带序号如1MO、-1FR)、BYMONTHDAY(可为负)、BYMONTH
+struct Recurrence {
+  enum class Frequency : char { Daily = 0, Weekly, Monthly, Yearly };
+
+  struct WeekDay {
+    // 0表示周期内所有这一天，否则为第几个(负数从末尾数)
+    int ordinal = 0;
+    // 0=周一 ... 6=周日
+    int weekday = 0;
+  };
+
+  Frequency frequency = Frequency::Daily;
+  int interval = 1;
+  // 0表示不限次数
+  int count = 0;
+  bool has_until = false;
+  double until = 0;
+  int week_start = 0;
+  std::vector<WeekDay> by_day;
+  std::vector<int> by_month_day;
+  std::vector<int> by_month;
+};
+
+// 上一次NextOccurrence返回的发生位置。有COUNT时必须从起始时间数起，
+// 带上它可以从上一次发生处继续展开，逐次调用的总开销与发生次数成正比
+struct RecurrenceCursor {
+  // 上一次发生所在的周期
+  int64_t period = 0;
+  // 到上一次发生为止的次数(包括起始时间)，0表示还没有位置
+  int produced = 0;
+  double last_ms = 0;
+};
+
+// 接受带或不带"RRULE:"前缀的值。有不支持的规则部分时返回false
+bool ParseRecurrence(const std::string& text, Recurrence* rule);
+
+// start_ms为第一次发生的时间(也计入COUNT)，返回严格晚于after_ms的下一次发生时间。
+// 没有下一次、或时间超出±8.64e15(JS Date的范围)时返回false。
+// cursor为同一规则和起始时间上一次调用的结果，且after_ms不早于上一次发生时从那里继续；
+// 成功时更新为这次的发生位置
+bool NextOccurrence(const Recurrence& rule, double start_ms, double after_ms, double* next_ms,
+                    RecurrenceCursor* cursor = nullptr);
+
+}   // namespace LifeV
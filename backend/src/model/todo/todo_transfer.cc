@@ -0,0 +1,216 @@
+/*
+ * @Author: Nana5aki
+ * @Date: 2026-10-18 13:20:48
+ * @LastEditors: Nana5aki
+ * @LastEditTime: 2026-10-18 13:20:48
+ * @FilePath: \life_view\backend\src\model\todo\todo_transfer.cc
+ */
+#include "todo_transfer.h"
+#include "framework/core/mapped_file.h"
+#include "framework/core/thread_pool.h"
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <future>
+
+namespace LifeV {
+
+namespace {
+
+constexpr size_t kMinChunkBytes = 256 * 1024;
+constexpr size_t kMaxChunkBytes = 8 * 1024 * 1024;
+constexpr size_t kExportRowsPerTask = 16 * 1024;
+
+// 同时在途的块数，限制解析结果/序列化缓冲的内存占用
+size_t InFlightLimit(framework::ThreadPool* pool) {
+  return pool->ThreadCount() * 2;
+}
+
+size_t ChunkBytesFor(size_t size, framework::ThreadPool* pool) {
+  size_t target = size / (pool->ThreadCount() * 8);
+  return std::min(kMaxChunkBytes, std::max(kMinChunkBytes, target));
+}
+
+double NowMs() {
+  using namespace std::chrono;
+  return static_cast<double>(
+    duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count());
+}
+
+}   // namespace
+
+bool ImportTodoFile(const std::string& path, TodoFileFormat format,
+                    const TodoImportChunkCallback& on_chunk, std::string* error) {
+  framework::MappedFile file;
+  if (!file.Open(path, error)) {
+    return false;
+  }
+  const char* data = file.Data();
+  const size_t size = file.Size();
+  const double total = static_cast<double>(size);
+  if (size == 0) {
+    return true;
+  }
+
+  framework::ThreadPool* pool = framework::ThreadPool::GetInstance();
+  const size_t chunk_bytes = ChunkBytesFor(size, pool);
+
+  std::vector<TextChunk> chunks;
+  CsvHeader header;
+  if (format == TodoFileFormat::Csv) {
+    size_t body = ParseCsvHeader(data, size, &header);
+    chunks = SplitCsv(data, size, body, chunk_bytes);
+  } else if (format == TodoFileFormat::ICalendar) {
+    chunks = SplitICalendar(data, size, chunk_bytes);
+  } else if (!SplitJsonArray(data, size, chunk_bytes, &chunks, error)) {
+    return false;
+  }
+
+  struct ChunkResult {
+    framework::VariantArray todos;
+    std::string error;
+  };
+  auto parse = [data, format, &header](TextChunk chunk) {
+    ChunkResult result;
+    const char* begin = data + chunk.begin;
+    size_t length = chunk.end - chunk.begin;
+    if (format == TodoFileFormat::Csv) {
+      ParseCsvChunk(begin, length, header, &result.todos);
+    } else if (format == TodoFileFormat::ICalendar) {
+      ParseICalendarChunk(begin, length, &result.todos);
+    } else if (!ParseJsonChunk(begin, length, &result.todos, &result.error) &&
+               result.error.empty()) {
+      result.error = "invalid json";
+    }
+    return result;
+  };
+
+  // 滑动窗口：保持最多InFlightLimit个块在解析，按提交顺序取结果。
+  // 出错后不再提交新块，但仍要等在途任务结束，它们引用着映射的文件内容
+  std::deque<std::pair<TextChunk, std::future<ChunkResult>>> in_flight;
+  size_t next = 0;
+  const size_t limit = InFlightLimit(pool);
+  bool failed = false;
+  while ((!failed && next < chunks.size()) || !in_flight.empty()) {
+    while (!failed && next < chunks.size() && in_flight.size() < limit) {
+      TextChunk chunk = chunks[next++];
+      in_flight.emplace_back(chunk, pool->Submit([parse, chunk]() { return parse(chunk); }));
+    }
+    auto& front = in_flight.front();
+    ChunkResult result = front.second.get();
+    if (!failed && !result.error.empty()) {
+      failed = true;
+      if (error) *error = result.error;
+    }
+    if (!failed) {
+      on_chunk(std::move(result.todos), static_cast<double>(front.first.end), total);
+    }
+    in_flight.pop_front();
+  }
+  return !failed;
+}
+
+bool ExportTodoFile(const std::string& path, TodoFileFormat format,
+                    const std::vector<TodoSegment>& segments,
+                    const TodoExportProgressCallback& on_progress, std::string* error) {
+  namespace fs = std::filesystem;
+  const fs::path target = fs::u8path(path);
+  fs::path temp = target;
+  temp += ".part";
+
+  std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+  if (!out) {
+    if (error) *error = "cannot write file: " + path;
+    return false;
+  }
+
+  struct Range {
+    const framework::VariantArray* todos;
+    size_t begin;
+    size_t end;
+    bool first;
+  };
+  std::vector<Range> ranges;
+  size_t rows_total = 0;
+  for (const auto& segment : segments) {
+    for (size_t begin = 0; begin < segment->size(); begin += kExportRowsPerTask) {
+      ranges.push_back({segment.get(),
+                        begin,
+                        std::min(segment->size(), begin + kExportRowsPerTask),
+                        ranges.empty()});
+    }
+    rows_total += segment->size();
+  }
+
+  std::string head;
+  if (format == TodoFileFormat::Csv) {
+    WriteCsvHeader(&head);
+  } else if (format == TodoFileFormat::ICalendar) {
+    WriteICalendarHeader(&head);
+  } else {
+    head = "[\n";
+  }
+  out.write(head.data(), static_cast<std::streamsize>(head.size()));
+
+  const double stamp = NowMs();
+  auto serialize = [format, stamp](Range range) {
+    std::string text;
+    if (format == TodoFileFormat::Csv) {
+      WriteCsvRows(*range.todos, range.begin, range.end, &text);
+    } else if (format == TodoFileFormat::ICalendar) {
+      WriteICalendarTodos(*range.todos, range.begin, range.end, stamp, &text);
+    } else {
+      WriteJsonTodos(*range.todos, range.begin, range.end, !range.first, &text);
+    }
+    return text;
+  };
+
+  framework::ThreadPool* pool = framework::ThreadPool::GetInstance();
+  std::deque<std::pair<size_t, std::future<std::string>>> in_flight;
+  size_t next = 0;
+  size_t rows_done = 0;
+  const size_t limit = InFlightLimit(pool);
+  while (next < ranges.size() || !in_flight.empty()) {
+    while (next < ranges.size() && in_flight.size() < limit) {
+      Range range = ranges[next++];
+      in_flight.emplace_back(range.end - range.begin,
+                             pool->Submit([serialize, range]() { return serialize(range); }));
+    }
+    auto& front = in_flight.front();
+    std::string text = front.second.get();
+    out.write(text.data(), static_cast<std::streamsize>(text.size()));
+    rows_done += front.first;
+    in_flight.pop_front();
+    if (on_progress) {
+      on_progress(rows_done, rows_total);
+    }
+  }
+
+  std::string tail;
+  if (format == TodoFileFormat::ICalendar) {
+    WriteICalendarFooter(&tail);
+  } else if (format == TodoFileFormat::Json) {
+    tail = "\n]\n";
+  }
+  out.write(tail.data(), static_cast<std::streamsize>(tail.size()));
+  out.close();
+  if (!out) {
+    if (error) *error = "write failed: " + path;
+    std::error_code ignored;
+    fs::remove(temp, ignored);
+    return false;
+  }
+
+  std::error_code ec;
+  fs::rename(temp, target, ec);
+  if (ec) {
+    if (error) *error = "cannot replace file: " + path + " (" + ec.message() + ")";
+    fs::remove(temp, ec);
+    return false;
+  }
+  return true;
+}
+
+}   // namespace LifeV
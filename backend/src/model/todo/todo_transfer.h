@@ -0,0 +1,35 @@
+/*
+ * @Author: Nana5aki
+ * @Date: 2026-10-18 13:20:48
+ * @LastEditors: Nana5aki
+ * @LastEditTime: 2026-10-18 13:20:48
+ * @FilePath: \life_view\backend\src\model\todo\todo_transfer.h
+ */
+#pragma once
+
+#include "todo_codec.h"
+#include "todo_model.h"
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace LifeV {
+
+// 批量导入：mmap输入文件，按块切分后在线程池中并行解析，
+// 再按文件顺序逐块回调on_chunk（在调用线程上），用于有序合并进Model。
+// 阻塞直到全部完成，应在后台线程调用。
+using TodoImportChunkCallback =
+  std::function<void(framework::VariantArray&& todos, double bytes_done, double bytes_total)>;
+
+bool ImportTodoFile(const std::string& path, TodoFileFormat format,
+                    const TodoImportChunkCallback& on_chunk, std::string* error);
+
+// 批量导出：各段在线程池中并行序列化，按顺序流式写入文件。
+// 先写入临时文件，成功后再替换目标文件。
+using TodoExportProgressCallback = std::function<void(size_t rows_done, size_t rows_total)>;
+
+bool ExportTodoFile(const std::string& path, TodoFileFormat format,
+                    const std::vector<TodoSegment>& segments,
+                    const TodoExportProgressCallback& on_progress, std::string* error);
+
+}   // namespace LifeV
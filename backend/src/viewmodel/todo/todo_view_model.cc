@@ -0,0 +1,521 @@
+/*
+ * @Author: Nana5aki
+ * @Date: 2026-10-18 14:02:16
+ * @LastEditors: Nana5aki
+ * @LastEditTime: 2026-10-18 14:02:16
+ * @FilePath: \life_view\backend\src\viewmodel\todo\todo_view_model.cc
+ */
+#include "todo_view_model.h"
+#include "framework/core/main_thread.h"
+#include "model/todo/todo_recurrence.h"
+#include "model/todo/todo_transfer.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <thread>
+
+namespace LifeV {
+
+using framework::MainThread;
+using framework::TimerService;
+using framework::Variant;
+using framework::VariantArray;
+using framework::VariantMap;
+using framework::VariantType;
+
+namespace {
+
+double ElapsedMs(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+    .count();
+}
+
+bool FormatFromExtension(const std::string& path, TodoFileFormat* format) {
+  size_t dot = path.find_last_of('.');
+  return dot != std::string::npos && ParseTodoFileFormat(path.substr(dot + 1), format);
+}
+
+const std::string& TodoId(const Variant& todo) {
+  static const std::string empty;
+  const Variant* id = todo.Find("id");
+  return (id && id->IsString()) ? id->StringRef() : empty;
+}
+
+bool TodoOpen(const Variant& todo) {
+  const Variant* status = todo.Find("status");
+  return !status || !status->IsString() ||
+         (status->StringRef() != "done" && status->StringRef() != "cancelled");
+}
+
+bool TodoRecurrence(const Variant& todo, Recurrence* rule) {
+  const Variant* rrule = todo.Find("rrule");
+  return rrule && rrule->IsString() && ParseRecurrence(rrule->StringRef(), rule);
+}
+
+// 读取非负整数参数，缺省或无效时返回fallback
+size_t ReadCount(const Variant* params, const char* key, size_t fallback) {
+  const Variant* value = params ? params->Find(key) : nullptr;
+  if (value && value->IsInt() && value->AsInt() >= 0) {
+    return static_cast<size_t>(value->AsInt());
+  }
+  if (value && value->IsDouble() && value->AsDouble() >= 0 && value->AsDouble() < 1e15) {
+    return static_cast<size_t>(value->AsDouble());
+  }
+  return fallback;
+}
+
+}   // namespace
+
+TodoViewModel::TodoViewModel()
+  : framework::ViewModel("todo_view_model")
+  , model_(std::make_shared<TodoModel>()) {
+  SetProp("todo_count", Variant(0));
+  SetProp("reminders", Variant(VariantType::Array));
+  SetProp("pending_reminder_count", Variant(0));
+  RegisterCommand("ImportTodos", [this](const Variant* params) { return ImportTodos(params); });
+  RegisterCommand("ExportTodos", [this](const Variant* params) { return ExportTodos(params); });
+  RegisterCommand("ScheduleReminder",
+                  [this](const Variant* params) { return ScheduleReminder(params); });
+  RegisterCommand("CancelReminder",
+                  [this](const Variant* params) { return CancelReminder(params); });
+  RegisterCommand("CountTodos", [this](const Variant* params) { return CountTodos(params); });
+  RegisterCommand("FilterTodos", [this](const Variant* params) { return FilterTodos(params); });
+  RegisterCommand("GroupTodos", [this](const Variant* params) { return GroupTodos(params); });
+  // 命令结果和提醒是事件，相同的结果(如同一查询、同样的失败)也要通知
+  RegisterEventProp("transfer_progress");
+  RegisterEventProp("reminders");
+  RegisterEventProp("todo_counts");
+  RegisterEventProp("filtered_todos");
+  RegisterEventProp("todo_groups");
+}
+
+TodoViewModel::~TodoViewModel() {
+  // 定时任务持有this，析构前必须全部取消
+  CancelAllReminders();
+}
+
+bool TodoViewModel::ParseTransferParams(const char* kind, const Variant* params,
+                                        std::string* path, TodoFileFormat* format) {
+  const Variant* path_value = params ? params->Find("path") : nullptr;
+  if (!path_value || !path_value->IsString() || path_value->StringRef().empty()) {
+    SetTransferProgress(kind, "failed", 0, 0, 0, 0, "path expected");
+    return false;
+  }
+  *path = path_value->StringRef();
+
+  const Variant* format_value = params->Find("format");
+  bool format_ok = format_value && format_value->IsString()
+                     ? ParseTodoFileFormat(format_value->StringRef(), format)
+                     : FormatFromExtension(*path, format);
+  if (!format_ok) {
+    SetTransferProgress(kind, "failed", 0, 0, 0, 0, "unknown file format");
+    return false;
+  }
+  return true;
+}
+
+bool TodoViewModel::ImportTodos(const Variant* params) {
+  if (transfer_running_) {
+    SetTransferProgress("import", "rejected", 0, 0, 0, 0, "another transfer is running");
+    return false;
+  }
+  std::string path;
+  TodoFileFormat format;
+  if (!ParseTransferParams("import", params, &path, &format)) {
+    return false;
+  }
+  const Variant* replace = params->Find("replace");
+  if (replace && replace->IsBool() && replace->AsBool()) {
+    CancelAllReminders();
+    SetProp("pending_reminder_count", Variant(0));
+    model_->Clear();
+    SetProp("todo_count", Variant(0));
+  }
+
+  transfer_running_ = true;
+  SetTransferProgress("import", "running", 0, 0, 0, 0, "");
+
+  std::weak_ptr<TodoViewModel> weak_self = weak_from_this();
+  std::thread([weak_self, path, format]() {
+    auto start = std::chrono::steady_clock::now();
+    auto rows = std::make_shared<size_t>(0);
+
+    // 解析在线程池中并行进行，这里按文件顺序把每块投递回主线程合并，保证导入顺序
+    auto on_chunk = [weak_self, start, rows](framework::VariantArray&& todos, double bytes_done,
+                                             double bytes_total) {
+      auto chunk = std::make_shared<framework::VariantArray>(std::move(todos));
+      double elapsed = ElapsedMs(start);
+      MainThread::Post([weak_self, chunk, rows, bytes_done, bytes_total, elapsed]() {
+        auto self = weak_self.lock();
+        if (!self) {
+          return;
+        }
+        // 条数和进度一起发布给其他线程的读者
+        WriteBatch batch(self.get());
+        *rows += chunk->size();
+        TodoSegment segment = self->model_->AppendSegment(std::move(*chunk));
+        self->SetProp("todo_count", Variant(static_cast<int>(self->model_->Size())));
+        if (segment) {
+          self->ScheduleTodoReminders(*segment);
+        }
+        self->SetTransferProgress(
+          "import", "running", *rows, bytes_done, bytes_total, elapsed, "");
+      });
+    };
+
+    std::string error;
+    bool ok = ImportTodoFile(path, format, on_chunk, &error);
+    double elapsed = ElapsedMs(start);
+    MainThread::Post([weak_self, ok, error, rows, elapsed]() {
+      auto self = weak_self.lock();
+      if (!self) {
+        return;
+      }
+      self->transfer_running_ = false;
+      self->SetTransferProgress("import", ok ? "done" : "failed", *rows, 0, 0, elapsed, error);
+    });
+  }).detach();
+  return true;
+}
+
+bool TodoViewModel::ExportTodos(const Variant* params) {
+  if (transfer_running_) {
+    SetTransferProgress("export", "rejected", 0, 0, 0, 0, "another transfer is running");
+    return false;
+  }
+  std::string path;
+  TodoFileFormat format;
+  if (!ParseTransferParams("export", params, &path, &format)) {
+    return false;
+  }
+
+  transfer_running_ = true;
+  SetTransferProgress("export", "running", 0, 0, 0, 0, "");
+
+  // 段是不可变的，拷贝段指针即得到一致快照，导出期间主线程可以继续修改Model
+  std::vector<TodoSegment> segments = model_->Snapshot();
+  std::weak_ptr<TodoViewModel> weak_self = weak_from_this();
+  std::thread([weak_self, path, format, segments]() {
+    auto start = std::chrono::steady_clock::now();
+    auto on_progress = [weak_self, start](size_t rows_done, size_t rows_total) {
+      double elapsed = ElapsedMs(start);
+      MainThread::Post([weak_self, rows_done, rows_total, elapsed]() {
+        if (auto self = weak_self.lock()) {
+          self->SetTransferProgress("export",
+                                    "running",
+                                    rows_done,
+                                    static_cast<double>(rows_done),
+                                    static_cast<double>(rows_total),
+                                    elapsed,
+                                    "");
+        }
+      });
+    };
+
+    std::string error;
+    bool ok = ExportTodoFile(path, format, segments, on_progress, &error);
+    size_t rows = 0;
+    for (const auto& segment : segments) {
+      rows += segment->size();
+    }
+    double elapsed = ElapsedMs(start);
+    MainThread::Post([weak_self, ok, error, rows, elapsed]() {
+      auto self = weak_self.lock();
+      if (!self) {
+        return;
+      }
+      self->transfer_running_ = false;
+      self->SetTransferProgress("export",
+                                ok ? "done" : "failed",
+                                rows,
+                                static_cast<double>(rows),
+                                static_cast<double>(rows),
+                                elapsed,
+                                error);
+    });
+  }).detach();
+  return true;
+}
+
+void TodoViewModel::SetTransferProgress(const char* kind, const char* state, size_t rows,
+                                        double bytes_done, double bytes_total, double elapsed_ms,
+                                        const std::string& error) {
+  VariantMap progress;
+  progress.emplace("kind", Variant(kind));
+  progress.emplace("state", Variant(state));
+  progress.emplace("rows", Variant(static_cast<double>(rows)));
+  progress.emplace("bytes_done", Variant(bytes_done));
+  progress.emplace("bytes_total", Variant(bytes_total));
+  progress.emplace("elapsed_ms", Variant(elapsed_ms));
+  progress.emplace("error", Variant(error));
+  SetProp("transfer_progress", Variant(std::move(progress)));
+}
+
+void TodoViewModel::ScheduleTodoReminders(const VariantArray& todos) {
+  double now = TimerService::NowMs();
+  Recurrence rule;
+  double next;
+  for (const auto& todo : todos) {
+    const Variant* due = todo.IsMap() ? todo.Find("due") : nullptr;
+    if (!due || !due->IsDouble() || !TodoOpen(todo)) {
+      continue;
+    }
+    // rrule无法解析时退回到只按due提醒一次
+    if (TodoRecurrence(todo, &rule)) {
+      RecurrenceCursor cursor;
+      if (NextOccurrence(rule, due->AsDouble(), now, &next, &cursor)) {
+        ScheduleReminderAt(&todo, next, &cursor);
+      }
+    } else if (due->AsDouble() > now) {
+      ScheduleReminderAt(&todo, due->AsDouble());
+    }
+  }
+  SetProp("pending_reminder_count", Variant(static_cast<int>(reminders_.size())));
+}
+
+bool TodoViewModel::ScheduleReminderAt(const Variant* todo, double at_ms,
+                                       const RecurrenceCursor* recurrence) {
+  const std::string& id = TodoId(*todo);
+  // 没有id的todo无法取消，不提醒
+  if (id.empty()) {
+    return false;
+  }
+  auto it = reminders_.find(id);
+  if (it != reminders_.end()) {
+    TimerService::GetInstance()->Cancel(it->second.timer);
+  }
+  // 只捕获两个指针，std::function不需要额外分配
+  TimerService::TimerId timer =
+    TimerService::GetInstance()->Schedule(at_ms, [this, todo]() { OnReminder(todo); });
+  if (timer == TimerService::kInvalidTimer) {
+    // 替换时旧的提醒已取消，不能留下一个不会触发的记录
+    if (it != reminders_.end()) {
+      reminders_.erase(it);
+    }
+    return false;
+  }
+  Reminder& reminder = it != reminders_.end() ? it->second : reminders_[id];
+  reminder.timer = timer;
+  reminder.todo = todo;
+  reminder.at = at_ms;
+  reminder.recurring = recurrence != nullptr;
+  reminder.cursor = recurrence ? *recurrence : RecurrenceCursor();
+  return true;
+}
+
+bool TodoViewModel::ScheduleReminder(const Variant* params) {
+  const Variant* id = params ? params->Find("id") : nullptr;
+  const Variant* at = params ? params->Find("at") : nullptr;
+  if (!id || !id->IsString() || !at || !(at->IsDouble() || at->IsInt())) {
+    std::cerr << "ScheduleReminder expects { id, at }" << std::endl;
+    return false;
+  }
+  double at_ms = at->IsDouble() ? at->AsDouble() : at->AsInt();
+
+  const Variant* todo = nullptr;
+  auto it = reminders_.find(id->StringRef());
+  if (it != reminders_.end()) {
+    todo = it->second.todo;
+  } else {
+    // 没有现成提醒的todo按id在Model中查找
+    for (const auto& segment : model_->Snapshot()) {
+      for (const auto& item : *segment) {
+        if (item.IsMap() && TodoId(item) == id->StringRef()) {
+          todo = &item;
+        }
+      }
+    }
+  }
+  if (!todo) {
+    std::cerr << "ScheduleReminder: todo not found: " << id->StringRef() << std::endl;
+    return false;
+  }
+  bool scheduled = ScheduleReminderAt(todo, at_ms);
+  if (!scheduled) {
+    std::cerr << "ScheduleReminder: at is out of range: " << at_ms << std::endl;
+  }
+  SetProp("pending_reminder_count", Variant(static_cast<int>(reminders_.size())));
+  return scheduled;
+}
+
+bool TodoViewModel::CancelReminder(const Variant* params) {
+  const Variant* id = params ? params->Find("id") : nullptr;
+  if (!id || !id->IsString()) {
+    std::cerr << "CancelReminder expects { id }" << std::endl;
+    return false;
+  }
+  auto it = reminders_.find(id->StringRef());
+  if (it == reminders_.end()) {
+    // 没有提醒可取消也视为成功
+    return true;
+  }
+  TimerService::GetInstance()->Cancel(it->second.timer);
+  reminders_.erase(it);
+  SetProp("pending_reminder_count", Variant(static_cast<int>(reminders_.size())));
+  return true;
+}
+
+void TodoViewModel::CancelAllReminders() {
+  if (reminders_.empty()) {
+    return;
+  }
+  TimerService* timers = TimerService::GetInstance();
+  for (const auto& [id, reminder] : reminders_) {
+    timers->Cancel(reminder.timer);
+  }
+  reminders_.clear();
+}
+
+void TodoViewModel::OnReminder(const Variant* todo) {
+  auto it = reminders_.find(TodoId(*todo));
+  if (it == reminders_.end() || it->second.todo != todo) {
+    return;
+  }
+  Reminder& reminder = it->second;
+
+  VariantMap item;
+  item.emplace("id", Variant(it->first));
+  const Variant* title = todo->Find("title");
+  item.emplace("title", title && title->IsString() ? *title : Variant(""));
+  item.emplace("at", Variant(reminder.at));
+  fired_reminders_.emplace_back(std::move(item));
+  if (fired_reminders_.size() == 1) {
+    // 同一轮到期的提醒在这一轮任务执行完后一起通知
+    std::weak_ptr<TodoViewModel> weak_self = weak_from_this();
+    MainThread::Post([weak_self]() {
+      if (auto self = weak_self.lock()) {
+        self->FlushReminders();
+      }
+    });
+  }
+
+  Recurrence rule;
+  double next;
+  const Variant* due = todo->Find("due");
+  if (reminder.recurring && due && due->IsDouble() && TodoRecurrence(*todo, &rule) &&
+      NextOccurrence(rule, due->AsDouble(), reminder.at, &next, &reminder.cursor)) {
+    reminder.at = next;
+    reminder.timer =
+      TimerService::GetInstance()->Schedule(next, [this, todo]() { OnReminder(todo); });
+  } else {
+    reminder.timer = TimerService::kInvalidTimer;
+  }
+  if (reminder.timer == TimerService::kInvalidTimer) {
+    reminders_.erase(it);
+  }
+}
+
+void TodoViewModel::FlushReminders() {
+  WriteBatch write_batch(this);
+  VariantArray batch;
+  batch.swap(fired_reminders_);
+  SetProp("reminders", Variant(std::move(batch)));
+  SetProp("pending_reminder_count", Variant(static_cast<int>(reminders_.size())));
+}
+
+bool TodoViewModel::CountTodos(const Variant* params) {
+  const Variant* queries = params ? params->Find("queries") : nullptr;
+  if (!queries || !queries->IsMap()) {
+    std::cerr << "CountTodos expects { queries: { name: filter } }" << std::endl;
+    return false;
+  }
+  const TodoColumns& columns = model_->Columns();
+  VariantMap counts;
+  TodoFilter filter;
+  std::string error;
+  for (const auto& [name, query] : queries->MapRef()) {
+    if (!ParseTodoFilter(query, &filter, &error)) {
+      std::cerr << "CountTodos " << name << ": " << error << std::endl;
+      return false;
+    }
+    counts.emplace_hint(counts.end(), name, Variant(static_cast<int>(columns.Count(filter))));
+  }
+  SetProp("todo_counts", Variant(std::move(counts)));
+  return true;
+}
+
+bool TodoViewModel::FilterTodos(const Variant* params) {
+  TodoFilter filter;
+  std::string error;
+  if (params && !ParseTodoFilter(*params, &filter, &error)) {
+    std::cerr << "FilterTodos: " << error << std::endl;
+    return false;
+  }
+  std::vector<uint64_t> mask;
+  std::vector<const Variant*> rows;
+  const TodoColumns& columns = model_->Columns();
+  columns.Filter(filter, &mask);
+  size_t offset = ReadCount(params, "offset", 0);
+  size_t count = columns.CollectRows(mask, offset, ReadCount(params, "limit", 100), &rows);
+
+  VariantArray todos;
+  todos.reserve(rows.size());
+  for (const Variant* row : rows) {
+    todos.push_back(*row);
+  }
+  VariantMap result;
+  result.emplace("count", Variant(static_cast<int>(count)));
+  result.emplace("todos", Variant(std::move(todos)));
+  SetProp("filtered_todos", Variant(std::move(result)));
+  return true;
+}
+
+bool TodoViewModel::GroupTodos(const Variant* params) {
+  const Variant* by = params ? params->Find("by") : nullptr;
+  TodoGroupKey key;
+  if (!by || !by->IsString() || !ParseTodoGroupKey(by->StringRef(), &key)) {
+    std::cerr << "GroupTodos expects { by: status/tag/due_day/completed_day }" << std::endl;
+    return false;
+  }
+  TodoFilter filter;
+  std::string error;
+  if (!ParseTodoFilter(*params, &filter, &error)) {
+    std::cerr << "GroupTodos: " << error << std::endl;
+    return false;
+  }
+  const TodoColumns& columns = model_->Columns();
+  std::vector<uint64_t> mask;
+  columns.Filter(filter, &mask);
+
+  VariantMap result;
+  result.emplace("by", *by);
+  if (key == TodoGroupKey::Status || key == TodoGroupKey::Tag) {
+    std::vector<std::pair<std::string, size_t>> groups;
+    if (key == TodoGroupKey::Status) {
+      columns.CountByStatus(mask, &groups);
+    } else {
+      columns.CountByTag(mask, &groups);
+    }
+    VariantMap counts;
+    for (auto& [name, count] : groups) {
+      counts.emplace(std::move(name), Variant(static_cast<int>(count)));
+    }
+    result.emplace("groups", Variant(std::move(counts)));
+  } else {
+    constexpr int64_t kMsPerDay = 86400000;
+    size_t days = std::min<size_t>(std::max<size_t>(ReadCount(params, "days", 30), 1), 3660);
+    const Variant* from = params->Find("from");
+    double from_ms = from && (from->IsDouble() || from->IsInt())
+                       ? (from->IsDouble() ? from->AsDouble() : from->AsInt())
+                       : TimerService::NowMs() - static_cast<double>((days - 1) * kMsPerDay);
+    if (!(std::abs(from_ms) < 1e15)) {
+      std::cerr << "GroupTodos: invalid from" << std::endl;
+      return false;
+    }
+    int64_t from_day = TodoDayIndex(static_cast<int64_t>(from_ms));
+    std::vector<size_t> counts;
+    columns.CountByDay(key, mask, from_day, days, &counts);
+    VariantArray values;
+    values.reserve(counts.size());
+    for (size_t count : counts) {
+      values.emplace_back(static_cast<int>(count));
+    }
+    result.emplace("from", Variant(static_cast<double>(from_day * kMsPerDay)));
+    result.emplace("counts", Variant(std::move(values)));
+  }
+  SetProp("todo_groups", Variant(std::move(result)));
+  return true;
+}
+
+}   // namespace LifeV
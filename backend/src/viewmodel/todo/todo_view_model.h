@@ -0,0 +1,96 @@
+/*
+ * @Author: Nana5aki
+ * @Date: 2026-10-18 14:02:16
+ * @LastEditors: Nana5aki
+ * @LastEditTime: 2026-10-18 14:02:16
+ * @FilePath: \life_view\backend\src\viewmodel\todo\todo_view_model.h
+ */
+#pragma once
+
+#include "framework/core/timer_service.h"
+#include "framework/mvvm/viewmodel.h"
+#include "model/todo/todo_codec.h"
+#include "model/todo/todo_model.h"
+#include "model/todo/todo_recurrence.h"
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace LifeV {
+
+// 属性:
+//   todo_count         int
+//   transfer_progress  map { kind, state(running/done/failed/rejected), rows, bytes_done,
+//                            bytes_total, elapsed_ms, error }
+//                      rejected表示已有导入或导出在进行，本次请求被忽略，正在进行的不受影响
+//   reminders          array [{ id, title, at(毫秒时间戳) }]，最近一批到期的提醒
+//   pending_reminder_count int
+//   todo_counts        map { 查询名: 数量 }，CountTodos的结果
+//   filtered_todos     map { count, todos: [todo] }，FilterTodos的结果
+//   todo_groups        map { by, groups: { 状态或标签: 数量 } }，按日期分组时为
+//                      map { by, from(首日0点的毫秒时间戳), counts: [每天的数量] }
+//   transfer_progress、reminders和三个查询结果是事件属性，每次写入都通知，值相同也不合并
+// 命令:
+//   ImportTodos { path, format?(csv/ics/json，缺省按扩展名), replace?(bool) }
+//   ExportTodos { path, format? }
+//   ScheduleReminder { id, at }  单次提醒，例如稍后提醒；替换该todo现有的提醒
+//   CancelReminder { id }
+//   CountTodos { queries: { 查询名: 过滤条件 } }  一次计算多个统计，如逾期数、各状态数
+//   FilterTodos { ...过滤条件, offset?, limit?(默认100) }
+//   GroupTodos { by(status/tag/due_day/completed_day), ...过滤条件,
+//                from?(毫秒时间戳，默认最近days天), days?(默认30) }
+//   过滤条件见ParseTodoFilter，统计查询在Model的列式副本上执行
+//   参数无效或被拒绝时命令返回失败。导入导出在后台执行，成功只表示已开始，结果见transfer_progress
+//
+// 未完成且due在未来的todo在导入后自动按due提醒；有rrule的按规则展开，每次到期后调度下一次
+class TodoViewModel : public framework::ViewModel,
+                      public std::enable_shared_from_this<TodoViewModel> {
+public:
+  TodoViewModel();
+  ~TodoViewModel() override;
+
+private:
+  bool ImportTodos(const framework::Variant* params);
+  bool ExportTodos(const framework::Variant* params);
+
+  // 解析命令参数中的path和format，失败时更新transfer_progress
+  bool ParseTransferParams(const char* kind, const framework::Variant* params, std::string* path,
+                           TodoFileFormat* format);
+  void SetTransferProgress(const char* kind, const char* state, size_t rows, double bytes_done,
+                           double bytes_total, double elapsed_ms, const std::string& error);
+
+  bool ScheduleReminder(const framework::Variant* params);
+  bool CancelReminder(const framework::Variant* params);
+  // 按due/rrule为一段新导入的todo调度提醒
+  void ScheduleTodoReminders(const framework::VariantArray& todos);
+  // recurrence为空时是单次提醒。时间超出定时器范围时不调度，返回false
+  bool ScheduleReminderAt(const framework::Variant* todo, double at_ms,
+                          const RecurrenceCursor* recurrence = nullptr);
+  void CancelAllReminders();
+  void OnReminder(const framework::Variant* todo);
+  void FlushReminders();
+
+  bool CountTodos(const framework::Variant* params);
+  bool FilterTodos(const framework::Variant* params);
+  bool GroupTodos(const framework::Variant* params);
+
+private:
+  struct Reminder {
+    framework::TimerService::TimerId timer = framework::TimerService::TimerId();
+    // 指向model_段中的todo，段不可变；Clear前会取消所有提醒
+    const framework::Variant* todo = nullptr;
+    double at = 0;
+    // 按rrule重复，到期后从cursor处展开下一次
+    bool recurring = false;
+    RecurrenceCursor cursor;
+  };
+
+  std::shared_ptr<TodoModel> model_;
+  bool transfer_running_ = false;
+  // todo id -> 提醒
+  std::unordered_map<std::string, Reminder> reminders_;
+  // 同一轮到期的提醒合并成一次reminders属性变化
+  framework::VariantArray fired_reminders_;
+};
+
+}   // namespace LifeV
@@ -0,0 +1,19 @@
+/*
+ * @Author: Nana5aki
+ * @Date: 2026-10-18 14:40:03
+ * @LastEditors: Nana5aki
+ * @LastEditTime: 2026-10-18 14:40:03
+ * @FilePath: \life_view\backend\src\viewmodel\view_model_registry.cc
+ */
+#include "view_model_registry.h"
+#include "framework/mvvm/mvvm_manager.h"
+#include "viewmodel/todo/todo_view_model.h"
+
+namespace LifeV {
+
+void RegisterViewModels() {
+  MVVMManager::getInstance()->registerViewModelFactory(
+    "todo_view_model", []() { return std::make_shared<TodoViewModel>(); });
+}
+
+}   // namespace LifeV
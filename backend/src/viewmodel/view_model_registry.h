@@ -0,0 +1,15 @@
+/*
+ * @Author: Nana5aki
+ * @Date: 2026-10-18 14:40:03
+ * @LastEditors: Nana5aki
+ * @LastEditTime: 2026-10-18 14:40:03
+ * @FilePath: \life_view\backend\src\viewmodel\view_model_registry.h
+ */
+#pragma once
+
+namespace LifeV {
+
+// 向MVVMManager注册所有业务ViewModel的工厂函数，类型名与前端createViewModel传入的一致
+void RegisterViewModels();
+
+}   // namespace LifeV
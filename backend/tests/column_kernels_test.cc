@@ -0,0 +1,133 @@
+/*
+ * @Author: Nana5aki
+ * @Date: 2026-10-19 16:21:08
+ * @LastEditors: Nana5aki
+ * @LastEditTime: 2026-10-19 16:21:08
+ * @FilePath: \life_view\backend\tests\column_kernels_test.cc
+ */
+#include "framework/core/column_kernels.h"
+#include "test_util.h"
+#include <random>
+#include <string>
+
+using framework::AvailableColumnKernels;
+using framework::BitmapWords;
+using framework::ColumnKernels;
+
+namespace {
+
+// 边界值附近以及高32位相同、低32位不同的值，覆盖SSE2用32位比较拼出的64位比较
+int64_t RandomValue(std::mt19937_64& random, int64_t min, int64_t max) {
+  static const int64_t kEdges[] = {INT64_MIN, INT64_MIN + 1, -1, 0, 1, INT64_MAX - 1, INT64_MAX,
+                                   INT32_MIN, INT32_MAX, int64_t(1) << 32,
+                                   -(int64_t(1) << 32), int64_t(UINT32_MAX)};
+  switch (random() % 5) {
+  case 0:
+    return kEdges[random() % (sizeof(kEdges) / sizeof(kEdges[0]))];
+  case 1: {
+    // min/max ±1，溢出时按回绕处理也无妨
+    int64_t base = random() % 2 ? min : max;
+    return static_cast<int64_t>(static_cast<uint64_t>(base) + random() % 3 - 1);
+  }
+  case 2:
+    return static_cast<int64_t>((random() & 0xffffffff00000000ULL) |
+                                (random() % 2 ? 0x7fffffffULL : 0x80000000ULL));
+  case 3:
+    return static_cast<int64_t>(random() % 2000) - 1000;
+  default:
+    return static_cast<int64_t>(random());
+  }
+}
+
+void RandomRange(std::mt19937_64& random, int64_t* min, int64_t* max) {
+  switch (random() % 5) {
+  case 0:
+    *min = INT64_MIN;
+    *max = INT64_MAX;
+    break;
+  case 1:
+    *min = static_cast<int64_t>(random());
+    *max = INT64_MAX;
+    break;
+  case 2:
+    *min = INT64_MIN;
+    *max = static_cast<int64_t>(random());
+    break;
+  case 3:
+    // 空区间和反向区间
+    *min = static_cast<int64_t>(random() % 100);
+    *max = *min - static_cast<int64_t>(random() % 2);
+    break;
+  default:
+    *min = static_cast<int64_t>(random() % 2000) - 1000;
+    *max = *min + static_cast<int64_t>(random() % 1000);
+    break;
+  }
+}
+
+// 每个实现与逐行判断的结果逐字相同，包括不足64行的最后一个字
+void TestEquivalence(const ColumnKernels& kernels) {
+  std::mt19937_64 random(20261019);
+  for (int round = 0; round < 3000; ++round) {
+    size_t count = round < 300 ? static_cast<size_t>(round) : random() % 1100;
+    int64_t min, max;
+    RandomRange(random, &min, &max);
+    std::vector<int64_t> values(count);
+    for (auto& value : values) {
+      value = RandomValue(random, min, max);
+    }
+
+    size_t words = BitmapWords(count);
+    std::vector<uint64_t> expected(words, 0);
+    size_t expected_count = 0;
+    for (size_t i = 0; i < count; ++i) {
+      if (values[i] >= min && values[i] < max) {
+        expected[i / 64] |= uint64_t(1) << (i % 64);
+        ++expected_count;
+      }
+    }
+    // 输出缓冲区预先填满，确认每个字都被覆盖
+    std::vector<uint64_t> mask(words, ~uint64_t(0));
+    kernels.range_mask(values.data(), count, min, max, mask.data());
+    CHECK(mask == expected);
+    CHECK(kernels.bitmap_count(mask.data(), words) == expected_count);
+
+    std::vector<uint64_t> other(words);
+    for (auto& word : other) {
+      word = random();
+    }
+    std::vector<uint64_t> anded = mask, ored = mask;
+    kernels.bitmap_and(anded.data(), other.data(), words);
+    kernels.bitmap_or(ored.data(), other.data(), words);
+    size_t and_count = 0, or_count = 0;
+    bool and_ok = true, or_ok = true;
+    for (size_t i = 0; i < words; ++i) {
+      and_ok = and_ok && anded[i] == (mask[i] & other[i]);
+      or_ok = or_ok && ored[i] == (mask[i] | other[i]);
+      for (int bit = 0; bit < 64; ++bit) {
+        and_count += (anded[i] >> bit) & 1;
+        or_count += (ored[i] >> bit) & 1;
+      }
+    }
+    CHECK(and_ok && or_ok);
+    CHECK(kernels.bitmap_count(anded.data(), words) == and_count);
+    CHECK(kernels.bitmap_count(ored.data(), words) == or_count);
+    if (test::Failures() > 0) {
+      fprintf(stderr, "kernel %s, round %d, %zu rows, [%lld, %lld)\n", kernels.name, round, count,
+              static_cast<long long>(min), static_cast<long long>(max));
+      return;
+    }
+  }
+}
+
+}   // namespace
+
+int main() {
+  const std::vector<ColumnKernels>& kernels = AvailableColumnKernels();
+  CHECK(std::string(kernels.back().name) == "scalar");
+  for (const ColumnKernels& item : kernels) {
+    printf("column kernels: %s\n", item.name);
+    TestEquivalence(item);
+  }
+  return test::Finish("column_kernels_test");
+}
@@ -0,0 +1,98 @@
+/*
+ * @Author: Nana5aki
+ * @Date: 2026-10-19 11:42:16
+ * @LastEditors: Nana5aki
+ * @LastEditTime: 2026-10-19 11:42:16
+ * @FilePath: \life_view\backend\tests\command_trace_test.cc
+ */
+#include "framework/mvvm/command_trace.h"
+#include "framework/mvvm/mvvm_manager.h"
+#include "test_util.h"
+#include "viewmodel/view_model_registry.h"
+#include <cstdio>
+#include <map>
+#include <set>
+#include <vector>
+
+using framework::CommandTrace;
+using framework::TraceReader;
+using framework::TraceRecord;
+using framework::TraceRecordType;
+using framework::Variant;
+using framework::VariantMap;
+
+namespace {
+
+std::vector<TraceRecord> ReadTrace(const std::string& path) {
+  std::vector<TraceRecord> records;
+  TraceReader reader;
+  std::string error;
+  CHECK(reader.Open(path, &error));
+  TraceRecord record;
+  while (reader.Next(&record, &error)) {
+    records.push_back(std::move(record));
+  }
+  CHECK(error.empty());
+  return records;
+}
+
+// todo_view_model在构造函数中SetProp，这些通知和之后的命令都要记到Create分配的序号上
+void TestConstructorProps() {
+  // ctest在构建目录中运行
+  std::string path = "command_trace_test.trace";
+  std::string error;
+  CHECK(CommandTrace::Start(path, true, &error));
+
+  VariantMap params;
+  params.emplace("offset", Variant(0));
+  params.emplace("limit", Variant(10));
+  Variant filter(std::move(params));
+  {
+    auto viewmodel = MVVMManager::getInstance()->createViewModel("todo_view_model");
+    CHECK(viewmodel != nullptr);
+    CHECK(viewmodel->Command("FilterTodos", &filter));
+  }
+  // 前一个已销毁，地址很可能被复用
+  auto viewmodel = MVVMManager::getInstance()->createViewModel("todo_view_model");
+  CHECK(viewmodel->Command("FilterTodos", &filter));
+  CommandTrace::Stop();
+
+  std::vector<TraceRecord> records = ReadTrace(path);
+  std::remove(path.c_str());
+
+  std::set<uint64_t> created;
+  std::map<uint64_t, int> constructor_props;
+  std::map<uint64_t, int> commands;
+  for (const TraceRecord& record : records) {
+    switch (record.type) {
+    case TraceRecordType::Create:
+      CHECK(record.name == "todo_view_model");
+      CHECK(created.insert(record.instance).second);
+      break;
+    case TraceRecordType::Command:
+      CHECK(created.count(record.instance) == 1);
+      ++commands[record.instance];
+      break;
+    case TraceRecordType::PropChanged:
+      if (created.count(record.instance) == 0) {
+        ++constructor_props[record.instance];
+      }
+      break;
+    }
+  }
+  CHECK(created.size() == 2);
+  CHECK(commands.size() == 2);
+  for (const auto& [instance, count] : constructor_props) {
+    CHECK(created.count(instance) == 1);
+    CHECK(count == 3);
+  }
+  CHECK(constructor_props.size() == 2);
+}
+
+}   // namespace
+
+int main() {
+  LifeV::RegisterViewModels();
+  TestConstructorProps();
+  return test::Finish("command_trace_test");
+}
@@ -0,0 +1,48 @@
+/*
+ * @Author: Nana5aki
+ * @Date: 2026-10-19 10:02:16
+ * @LastEditors: Nana5aki
+ * @LastEditTime: 2026-10-19 10:02:16
+ * @FilePath: \life_view\backend\tests\test_util.h
+ */
+#pragma once
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+// 最小的测试辅助：CHECK失败时打印位置并计数，main返回失败数，由ctest判定
+namespace test {
+
+inline int& Failures() {
+  static int failures = 0;
+  return failures;
+}
+
+inline int Finish(const char* name) {
+  if (Failures() == 0) {
+    printf("%s: ok\n", name);
+  } else {
+    printf("%s: %d check(s) failed\n", name, Failures());
+  }
+  return Failures() == 0 ? 0 : 1;
+}
+
+// 读取tests/data下的文件
+inline std::string ReadData(const std::string& name) {
+  std::ifstream file(std::string(LIFE_VIEW_TEST_DATA) + "/" + name, std::ios::binary);
+  std::stringstream content;
+  content << file.rdbuf();
+  return content.str();
+}
+
+}   // namespace test
+
+#define CHECK(cond)                                                                       \
+  do {                                                                                    \
+    if (!(cond)) {                                                                        \
+      fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond);           \
+      ++test::Failures();                                                                 \
+    }                                                                                     \
+  } while (0)
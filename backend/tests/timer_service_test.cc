@@ -0,0 +1,80 @@
+/*
+ * @Author: Nana5aki
+ * @Date: 2026-10-19 15:40:12
+ * @LastEditors: Nana5aki
+ * @LastEditTime: 2026-10-19 15:40:12
+ * @FilePath: \life_view\backend\tests\timer_service_test.cc
+ */
+#include "framework/core/main_thread.h"
+#include "framework/core/timer_service.h"
+#include "test_util.h"
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <thread>
+#include <vector>
+
+using framework::MainThread;
+using framework::TimerService;
+
+namespace {
+
+// 测试线程充当主线程，执行后台线程投递的任务，直到done或超时
+template <typename Done>
+bool RunUntil(Done done, int timeout_ms = 5000) {
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+  while (!done()) {
+    if (std::chrono::steady_clock::now() > deadline) {
+      return false;
+    }
+    MainThread::RunPending();
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return true;
+}
+
+// 按到期时间顺序执行，取消的不执行，任务中可以再调度
+void TestOrderAndCancel() {
+  TimerService* timers = TimerService::GetInstance();
+  double now = TimerService::NowMs();
+  std::vector<int> order;
+  // 留出余量，负载高时1晚执行也不会与3在同一轮到期
+  timers->Schedule(now + 300, [&]() { order.push_back(3); });
+  timers->Schedule(now + 20, [&]() {
+    order.push_back(1);
+    timers->Schedule(TimerService::NowMs() + 10, [&]() { order.push_back(2); });
+  });
+  TimerService::TimerId cancelled = timers->Schedule(now + 30, [&]() { order.push_back(-1); });
+  // 已经过去的时间尽快执行
+  timers->Schedule(now - 1000, [&]() { order.push_back(0); });
+  CHECK(timers->Cancel(cancelled));
+  CHECK(!timers->Cancel(cancelled));
+
+  CHECK(RunUntil([&]() { return order.size() >= 4; }));
+  CHECK(order == std::vector<int>({0, 1, 2, 3}));
+  CHECK(timers->PendingCount() == 0);
+}
+
+// NaN、Infinity和超出JS Date范围的时间不调度；负无穷视为已经过去
+void TestOutOfRange() {
+  TimerService* timers = TimerService::GetInstance();
+  int runs = 0;
+  const double inf = std::numeric_limits<double>::infinity();
+  for (double due : {inf, 1e300, 8.64e15 + 1, std::nan("")}) {
+    CHECK(timers->Schedule(due, [&]() { ++runs; }) == TimerService::kInvalidTimer);
+  }
+  CHECK(timers->PendingCount() == 0);
+  CHECK(timers->Cancel(timers->Schedule(8.64e15, [&]() { ++runs; })));
+
+  CHECK(timers->Schedule(-inf, [&]() { ++runs; }) != TimerService::kInvalidTimer);
+  CHECK(RunUntil([&]() { return runs == 1; }));
+  CHECK(timers->PendingCount() == 0);
+}
+
+}   // namespace
+
+int main() {
+  TestOrderAndCancel();
+  TestOutOfRange();
+  return test::Finish("timer_service_test");
+}
@@ -0,0 +1,161 @@
+/*
+ * @Author: Nana5aki
+ * @Date: 2026-10-19 15:40:12
+ * @LastEditors: Nana5aki
+ * @LastEditTime: 2026-10-19 15:40:12
+ * @FilePath: \life_view\backend\tests\timer_wheel_test.cc
+ */
+#include "framework/core/timer_wheel.h"
+#include "test_util.h"
+#include <algorithm>
+#include <map>
+#include <random>
+#include <unordered_map>
+
+using framework::TimerWheel;
+
+namespace {
+
+struct Reference {
+  // 到期tick -> 键
+  std::multimap<uint64_t, int> timers;
+  struct Entry {
+    TimerWheel::TimerId id;
+    std::multimap<uint64_t, int>::iterator it;
+  };
+  std::unordered_map<int, Entry> live;
+};
+
+// 随机插入、取消和推进，与multimap实现的结果逐步比较。
+// 到期时间覆盖各层、超出2^36的范围和已经过去的时间，推进步长从1到跨越多圈
+void TestAgainstReference(uint32_t seed) {
+  std::mt19937_64 random(seed);
+  uint64_t start = random() % (uint64_t(1) << 40);
+  TimerWheel wheel(start);
+  Reference reference;
+  std::unordered_map<int, uint64_t> expiry_of;
+  std::vector<int> fired;
+  std::vector<TimerWheel::TimerId> dead_ids;
+  int next_key = 0;
+  size_t total_fired = 0;
+  uint64_t now = start;
+
+  auto random_delay = [&random]() -> uint64_t {
+    switch (random() % 6) {
+    case 0:
+      return random() % 64;
+    case 1:
+      return random() % 4096;
+    case 2:
+      return random() % (uint64_t(1) << 24);
+    case 3:
+      return random() % (uint64_t(1) << 38);
+    case 4:
+      // 与层边界对齐
+      return uint64_t(1) << (6 * (1 + random() % 5));
+    default:
+      return random() % 200;
+    }
+  };
+
+  for (int step = 0; step < 20000; ++step) {
+    uint64_t op = random() % 10;
+    if (op < 5) {
+      int key = next_key++;
+      uint64_t expiry;
+      if (random() % 10 == 0) {
+        // 已经过去的时间在下一个tick到期
+        expiry = now - std::min<uint64_t>(now, random() % 1000);
+      } else {
+        expiry = now + random_delay();
+      }
+      uint64_t effective = std::max(expiry, now + 1);
+      TimerWheel::TimerId id = wheel.Insert(expiry, [&fired, key]() { fired.push_back(key); });
+      CHECK(id != TimerWheel::kInvalidTimer);
+      expiry_of[key] = effective;
+      reference.live[key] = {id, reference.timers.emplace(effective, key)};
+    } else if (op < 7) {
+      if (!reference.live.empty()) {
+        auto it = std::next(reference.live.begin(),
+                            static_cast<long>(random() % reference.live.size()));
+        CHECK(wheel.Cancel(it->second.id));
+        CHECK(!wheel.Cancel(it->second.id));
+        dead_ids.push_back(it->second.id);
+        reference.timers.erase(it->second.it);
+        reference.live.erase(it);
+      }
+      // 已到期或已取消的id再取消返回false，节点复用后也不会误取消新定时器
+      if (!dead_ids.empty()) {
+        CHECK(!wheel.Cancel(dead_ids[random() % dead_ids.size()]));
+      }
+    } else {
+      uint64_t target = now + (random() % 4 == 0 ? random_delay() : random() % 100);
+      std::vector<TimerWheel::Task> tasks;
+      wheel.Advance(target, &tasks);
+      fired.clear();
+      for (auto& task : tasks) {
+        task();
+      }
+      now = target;
+      CHECK(wheel.Now() == now);
+
+      std::vector<int> expected;
+      auto end = reference.timers.upper_bound(now);
+      for (auto it = reference.timers.begin(); it != end; ++it) {
+        expected.push_back(it->second);
+        dead_ids.push_back(reference.live[it->second].id);
+        reference.live.erase(it->second);
+      }
+      reference.timers.erase(reference.timers.begin(), end);
+
+      // 按到期时间顺序，同一tick内的顺序不做要求
+      for (size_t i = 1; i < fired.size(); ++i) {
+        CHECK(expiry_of[fired[i - 1]] <= expiry_of[fired[i]]);
+      }
+      std::vector<int> sorted = fired;
+      std::sort(sorted.begin(), sorted.end());
+      std::sort(expected.begin(), expected.end());
+      CHECK(sorted == expected);
+      total_fired += fired.size();
+    }
+
+    CHECK(wheel.Size() == reference.timers.size());
+    if (reference.timers.empty()) {
+      CHECK(wheel.NextTick() == TimerWheel::kNever);
+    } else {
+      uint64_t next = wheel.NextTick();
+      CHECK(next > now && next <= reference.timers.begin()->first);
+    }
+    if (test::Failures() > 0) {
+      return;
+    }
+  }
+  CHECK(total_fired > 1000);
+}
+
+// 推进后插入已经过去的时间，在下一个tick到期
+void TestInsertPast() {
+  TimerWheel wheel(100);
+  int runs = 0;
+  wheel.Insert(110, [&]() { ++runs; });
+  std::vector<TimerWheel::Task> tasks;
+  wheel.Advance(200, &tasks);
+  CHECK(tasks.size() == 1);
+  tasks[0]();
+  CHECK(runs == 1);
+  wheel.Insert(150, [&]() { ++runs; });
+  CHECK(wheel.NextTick() == 201);
+  tasks.clear();
+  wheel.Advance(201, &tasks);
+  CHECK(tasks.size() == 1);
+}
+
+}   // namespace
+
+int main() {
+  for (uint32_t seed = 1; seed <= 20; ++seed) {
+    TestAgainstReference(seed);
+  }
+  TestInsertPast();
+  return test::Finish("timer_wheel_test");
+}
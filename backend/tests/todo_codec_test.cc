@@ -0,0 +1,101 @@
+/*
+ * @Author: Nana5aki
+ * @Date: 2026-10-19 10:02:16
+ * @LastEditors: Nana5aki
+ * @LastEditTime: 2026-10-19 10:02:16
+ * @FilePath: \life_view\backend\tests\todo_codec_test.cc
+ */
+#include "model/todo/todo_codec.h"
+#include "test_util.h"
+#include <climits>
+#include <limits>
+
+using framework::Variant;
+using framework::VariantArray;
+using framework::VariantMap;
+using LifeV::CsvHeader;
+using LifeV::TextChunk;
+
+namespace {
+
+VariantArray ParseSplit(const std::string& text, size_t target_bytes) {
+  CsvHeader header;
+  size_t body = LifeV::ParseCsvHeader(text.data(), text.size(), &header);
+  VariantArray todos;
+  for (const TextChunk& chunk : LifeV::SplitCsv(text.data(), text.size(), body, target_bytes)) {
+    LifeV::ParseCsvChunk(text.data() + chunk.begin, chunk.end - chunk.begin, header, &todos);
+  }
+  return todos;
+}
+
+// 字段中间的引号是普通字符，不能让切分器把之后的内容当成在引号内
+void TestSplitCsvLiteralQuote() {
+  std::string text = test::ReadData("csv_literal_quote.csv");
+  CHECK(!text.empty());
+  VariantArray whole = ParseSplit(text, text.size());
+  CHECK(whole.size() == 6);
+  if (whole.size() == 6) {
+    CHECK(whole[0].Find("title")->StringRef() == "Buy 2\" pipe");
+    CHECK(whole[1].Find("title")->StringRef() == "Multi\nline, with comma");
+    CHECK(whole[3].Find("title")->StringRef() == "He said \"hi\"");
+    CHECK(whole[4].Find("title")->StringRef() == "Quoted then literal");
+  }
+  // 任意切分大小都必须与整块解析一致
+  for (size_t target = 1; target < text.size(); ++target) {
+    VariantArray split = ParseSplit(text, target);
+    CHECK(split.size() == whole.size());
+    for (size_t i = 0; i < split.size() && i < whole.size(); ++i) {
+      CHECK(split[i] == whole[i]);
+    }
+  }
+}
+
+// 超长数字和超出范围的时间戳不能触发溢出或越界转换
+void TestNumberRange() {
+  std::string text = "id,title,priority,due\n"
+                     "a,Big,99999999999999999999999,1" + std::string(400, '0') + "\n"
+                     "b,Small,-99999999999999999999999,8640000000000001\n"
+                     "c,Edge,7,8640000000000000\n";
+  VariantArray todos = ParseSplit(text, text.size());
+  CHECK(todos.size() == 3);
+  if (todos.size() == 3) {
+    CHECK(todos[0].Find("priority")->AsInt() == INT_MAX);
+    CHECK(todos[0].Find("due")->IsNull());
+    CHECK(todos[1].Find("priority")->AsInt() == -INT_MAX);
+    CHECK(todos[1].Find("due")->IsNull());
+    CHECK(todos[2].Find("due")->AsDouble() == 8.64e15);
+  }
+
+  CHECK(LifeV::FormatIso8601(0) == "1970-01-01T00:00:00Z");
+  CHECK(LifeV::FormatIso8601(-8.64e15) == "-271821-04-20T00:00:00Z");
+  CHECK(LifeV::FormatIso8601(8.64e15 + 1).empty());
+  CHECK(LifeV::FormatIso8601(1e300).empty());
+  CHECK(LifeV::FormatIso8601(std::numeric_limits<double>::infinity()).empty());
+  CHECK(LifeV::FormatIso8601(std::numeric_limits<double>::quiet_NaN()).empty());
+
+  // 导出时超出范围的时间视为没有，优先级取int边界
+  VariantMap todo = LifeV::MakeEmptyTodo();
+  todo["id"] = Variant("x");
+  todo["title"] = Variant("Far away");
+  todo["priority"] = Variant(1e300);
+  todo["due"] = Variant(1e300);
+  todo["completed_at"] = Variant(-std::numeric_limits<double>::infinity());
+  VariantArray rows;
+  rows.emplace_back(std::move(todo));
+  std::string csv;
+  LifeV::WriteCsvRows(rows, 0, 1, &csv);
+  CHECK(csv == "x,Far away,,todo,2147483647,,,,\r\n");
+  std::string ics;
+  LifeV::WriteICalendarTodos(rows, 0, 1, 0, &ics);
+  CHECK(ics.find("PRIORITY:2147483647\r\n") != std::string::npos);
+  CHECK(ics.find("DUE:") == std::string::npos);
+  CHECK(ics.find("COMPLETED:") == std::string::npos);
+}
+
+}   // namespace
+
+int main() {
+  TestSplitCsvLiteralQuote();
+  TestNumberRange();
+  return test::Finish("todo_codec_test");
+}
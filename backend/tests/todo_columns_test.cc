@@ -0,0 +1,70 @@
+/*
+ * @Author: Nana5aki
+ * @Date: 2026-10-19 12:06:40
+ * @LastEditors: Nana5aki
+ * @LastEditTime: 2026-10-19 12:06:40
+ * @FilePath: \life_view\backend\tests\todo_columns_test.cc
+ */
+#include "model/todo/todo_columns.h"
+#include "test_util.h"
+#include <limits>
+
+using framework::Variant;
+using framework::VariantArray;
+using framework::VariantMap;
+using LifeV::ParseTodoFilter;
+using LifeV::TodoColumns;
+using LifeV::TodoFilter;
+
+namespace {
+
+Variant Params(const char* key, double value) {
+  VariantMap params;
+  params.emplace(key, Variant(value));
+  return Variant(std::move(params));
+}
+
+Variant Todo(double due) {
+  VariantMap todo;
+  todo.emplace("status", Variant("todo"));
+  todo.emplace("due", Variant(due));
+  return Variant(std::move(todo));
+}
+
+// 超出int64的时间戳转换是未定义行为，过滤参数报错，todo中的视为没有时间
+void TestTimeRange() {
+  TodoFilter filter;
+  std::string error;
+  CHECK(!ParseTodoFilter(Params("due_from", 1e300), &filter, &error));
+  CHECK(error == "due_from expects a timestamp in milliseconds");
+  CHECK(!ParseTodoFilter(Params("completed_to", -1e19), &filter, &error));
+  CHECK(!ParseTodoFilter(Params("due_to", std::numeric_limits<double>::infinity()), &filter,
+                         &error));
+  CHECK(!ParseTodoFilter(Params("due_to", 9223372036854775808.0), &filter, &error));
+
+  filter = TodoFilter();
+  CHECK(ParseTodoFilter(Params("due_from", -9223372036854775808.0), &filter, &error));
+  CHECK(filter.due.enabled && filter.due.from == INT64_MIN);
+  CHECK(ParseTodoFilter(Params("due_to", 1.5e12), &filter, &error));
+  CHECK(filter.due.to == 1500000000000);
+
+  VariantArray todos;
+  todos.push_back(Todo(1e300));
+  todos.push_back(Todo(-1e300));
+  todos.push_back(Todo(1e12));
+  TodoColumns columns;
+  columns.Append(todos);
+  filter = TodoFilter();
+  CHECK(ParseTodoFilter(Params("due_from", 0), &filter, &error));
+  CHECK(columns.Count(filter) == 1);
+  filter = TodoFilter();
+  CHECK(ParseTodoFilter(Params("due_to", 0), &filter, &error));
+  CHECK(columns.Count(filter) == 0);
+}
+
+}   // namespace
+
+int main() {
+  TestTimeRange();
+  return test::Finish("todo_columns_test");
+}
@@ -0,0 +1,126 @@
+/*
+ * @Author: Nana5aki
+ * @Date: 2026-10-19 15:40:12
+ * @LastEditors: Nana5aki
+ * @LastEditTime: 2026-10-19 15:40:12
+ * @FilePath: \life_view\backend\tests\todo_recurrence_test.cc
+ */
+#include "model/todo/todo_codec.h"
+#include "model/todo/todo_recurrence.h"
+#include "test_util.h"
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+using LifeV::FormatIso8601;
+using LifeV::NextOccurrence;
+using LifeV::ParseRecurrence;
+using LifeV::Recurrence;
+using LifeV::RecurrenceCursor;
+
+namespace {
+
+double Time(const char* text) {
+  double ms = 0;
+  CHECK(LifeV::ParseTodoTime(text, strlen(text), &ms));
+  return ms;
+}
+
+// 从start开始依次展开，最多limit次，返回ISO时间(不含起始时间)
+std::vector<std::string> Expand(const char* rrule, const char* start, size_t limit,
+                                bool use_cursor = true) {
+  Recurrence rule;
+  CHECK(ParseRecurrence(rrule, &rule));
+  double start_ms = Time(start);
+  double after = start_ms;
+  RecurrenceCursor cursor;
+  std::vector<std::string> result;
+  double next;
+  while (result.size() < limit &&
+         NextOccurrence(rule, start_ms, after, &next, use_cursor ? &cursor : nullptr)) {
+    CHECK(next > after);
+    result.push_back(FormatIso8601(next));
+    after = next;
+  }
+  return result;
+}
+
+using Dates = std::vector<std::string>;
+
+// 带序号的BYDAY：每月第一个周一、最后一个周五，每年11月第四个周四
+void TestByDayOrdinal() {
+  CHECK(Expand("FREQ=MONTHLY;BYDAY=1MO", "2026-01-05T09:00:00Z", 3) ==
+        Dates({"2026-02-02T09:00:00Z", "2026-03-02T09:00:00Z", "2026-04-06T09:00:00Z"}));
+  CHECK(Expand("FREQ=MONTHLY;BYDAY=-1FR", "2026-01-30T18:00:00Z", 3) ==
+        Dates({"2026-02-27T18:00:00Z", "2026-03-27T18:00:00Z", "2026-04-24T18:00:00Z"}));
+  CHECK(Expand("RRULE:FREQ=YEARLY;BYMONTH=11;BYDAY=4TH", "2026-11-26T00:00:00Z", 2) ==
+        Dates({"2027-11-25T00:00:00Z", "2028-11-23T00:00:00Z"}));
+  // 每月第5个周三，没有第5个的月份跳过
+  CHECK(Expand("FREQ=MONTHLY;BYDAY=5WE", "2026-04-29T12:00:00Z", 2) ==
+        Dates({"2026-07-29T12:00:00Z", "2026-09-30T12:00:00Z"}));
+}
+
+// 负的BYMONTHDAY从月末数起，跨越不同长度的月份和闰年
+void TestNegativeMonthDay() {
+  CHECK(Expand("FREQ=MONTHLY;BYMONTHDAY=-1", "2026-01-31T08:00:00Z", 3) ==
+        Dates({"2026-02-28T08:00:00Z", "2026-03-31T08:00:00Z", "2026-04-30T08:00:00Z"}));
+  CHECK(Expand("FREQ=YEARLY;BYMONTH=2;BYMONTHDAY=-1", "2027-02-28T00:00:00Z", 2) ==
+        Dates({"2028-02-29T00:00:00Z", "2029-02-28T00:00:00Z"}));
+  // 与BYDAY同时出现时取交集：月末最后7天中的周一
+  CHECK(Expand("FREQ=MONTHLY;BYMONTHDAY=-7,-6,-5,-4,-3,-2,-1;BYDAY=MO", "2026-01-26T00:00:00Z",
+               2) == Dates({"2026-02-23T00:00:00Z", "2026-03-30T00:00:00Z"}));
+}
+
+// COUNT包括起始时间；UNTIL包括正好落在上面的那一次
+void TestCountAndUntil() {
+  CHECK(Expand("FREQ=DAILY;COUNT=3", "2026-03-01T07:30:00Z", 10) ==
+        Dates({"2026-03-02T07:30:00Z", "2026-03-03T07:30:00Z"}));
+  CHECK(Expand("FREQ=WEEKLY;UNTIL=20260126T100000Z", "2026-01-05T10:00:00Z", 10) ==
+        Dates({"2026-01-12T10:00:00Z", "2026-01-19T10:00:00Z", "2026-01-26T10:00:00Z"}));
+  CHECK(Expand("FREQ=WEEKLY;BYDAY=MO,FR;COUNT=4;UNTIL=20270101T000000Z", "2026-01-05T10:00:00Z",
+               10) ==
+        Dates({"2026-01-09T10:00:00Z", "2026-01-12T10:00:00Z", "2026-01-16T10:00:00Z"}));
+
+  // 从上一次发生处继续与每次从头展开的结果相同
+  const char* rule = "FREQ=WEEKLY;INTERVAL=2;BYDAY=MO,WE,FR;COUNT=300";
+  Dates resumed = Expand(rule, "2026-01-05T10:00:00Z", 1000, true);
+  CHECK(resumed.size() == 299);
+  CHECK(resumed == Expand(rule, "2026-01-05T10:00:00Z", 1000, false));
+
+  // after早于游标位置时游标无效，从头计数
+  Recurrence count_rule;
+  CHECK(ParseRecurrence("FREQ=DAILY;COUNT=5", &count_rule));
+  double start = Time("2026-03-01T00:00:00Z");
+  RecurrenceCursor cursor;
+  double next;
+  CHECK(NextOccurrence(count_rule, start, start + 3.5 * 86400000, &next, &cursor));
+  CHECK(FormatIso8601(next) == "2026-03-05T00:00:00Z");
+  CHECK(cursor.produced == 5);
+  CHECK(NextOccurrence(count_rule, start, start, &next, &cursor));
+  CHECK(FormatIso8601(next) == "2026-03-02T00:00:00Z");
+  CHECK(!NextOccurrence(count_rule, start, start + 4 * 86400000, &next, &cursor));
+}
+
+// 超出时间范围的输入直接返回false，不做未定义的整数转换
+void TestTimeRange() {
+  Recurrence rule;
+  CHECK(ParseRecurrence("FREQ=DAILY", &rule));
+  double next;
+  const double inf = std::numeric_limits<double>::infinity();
+  CHECK(!NextOccurrence(rule, 1e300, 0, &next));
+  CHECK(!NextOccurrence(rule, 0, 1e300, &next));
+  CHECK(!NextOccurrence(rule, -inf, 0, &next));
+  CHECK(!NextOccurrence(rule, 0, std::nan(""), &next));
+  CHECK(NextOccurrence(rule, 0, 0, &next) && next == 86400000);
+}
+
+}   // namespace
+
+int main() {
+  TestByDayOrdinal();
+  TestNegativeMonthDay();
+  TestCountAndUntil();
+  TestTimeRange();
+  return test::Finish("todo_recurrence_test");
+}
@@ -0,0 +1,113 @@
+/*
+ * @Author: Nana5aki
+ * @Date: 2026-10-19 10:31:52
+ * @LastEditors: Nana5aki
+ * @LastEditTime: 2026-10-19 10:31:52
+ * @FilePath: \life_view\backend\tests\variant_json_test.cc
+ */
+#include "framework/mvvm/variant_json.h"
+#include "test_util.h"
+#include <cmath>
+#include <random>
+
+using framework::JsonScannerNames;
+using framework::JsonStructuralScanner;
+using framework::ParseJson;
+using framework::Variant;
+
+namespace {
+
+// 超出double范围的数不能静默变成0
+void TestNumberRange() {
+  Variant value;
+  std::string error;
+  CHECK(!ParseJson("1e400", &value, &error));
+  CHECK(error.find("out of range") != std::string::npos);
+  CHECK(!ParseJson("[-1e400]", &value, &error));
+  CHECK(!ParseJson("{\"due\": 2.5e999}", &value, &error));
+
+  CHECK(ParseJson("1e-400", &value, &error));
+  CHECK(value.IsInt() && value.AsInt() == 0);
+  CHECK(ParseJson("1.5e3", &value, &error));
+  CHECK(value.IsInt() && value.AsInt() == 1500);
+  CHECK(ParseJson("1e300", &value, &error));
+  CHECK(value.IsDouble() && value.AsDouble() == 1e300);
+}
+
+// -0与JS一致保留为Double
+void TestNegativeZero() {
+  Variant value;
+  for (const char* text : {"-0", "-0.0", "-0e3", "-1e-400"}) {
+    CHECK(ParseJson(text, &value));
+    CHECK(value.IsDouble() && value.AsDouble() == 0 && std::signbit(value.AsDouble()));
+  }
+  CHECK(ParseJson("0", &value));
+  CHECK(value.IsInt() && value.AsInt() == 0);
+  CHECK(ParseJson("0.0", &value));
+  CHECK(value.IsInt() && value.AsInt() == 0);
+}
+
+// 字符串中的控制字符必须转义，\u代理项必须成对
+void TestStrings() {
+  Variant value;
+  std::string error;
+  CHECK(!ParseJson("\"a\nb\"", &value, &error));
+  CHECK(error.find("control character") != std::string::npos);
+  // SIMD查找路径(16字节以上)同样拒绝
+  CHECK(!ParseJson("[\"0123456789abcdef0123\tx\"]", &value, &error));
+  CHECK(!ParseJson(std::string("\"a\0b\"", 5), &value, &error));
+  CHECK(ParseJson("\"a\\nb\\t\x7f\"", &value, &error));
+  CHECK(value.StringRef() == "a\nb\t\x7f");
+
+  CHECK(ParseJson("\"\\ud83d\\ude00\"", &value, &error));
+  CHECK(value.StringRef() == "\xF0\x9F\x98\x80");
+  for (const char* text : {"\"\\ud83d\"", "\"\\ud83dx\"", "\"\\ude00\"", "\"\\ud83d\\u0041\"",
+                           "\"\\ud83d\\ud83d\\ude00\""}) {
+    CHECK(!ParseJson(text, &value, &error));
+    CHECK(error.find("unpaired surrogate") != std::string::npos);
+  }
+}
+
+// 各SIMD实现与标量实现的第一步结果逐位一致，包括跨块的转义和字符串状态
+void TestScannerEquivalence() {
+  static const char kAlphabet[] = "\"\\{}[]:, \t\n\rab1-.e\xC3\xA9\x80\xFF";
+  std::mt19937 random(20261019);
+  std::vector<std::string> names = JsonScannerNames();
+  CHECK(names.back() == "scalar");
+  for (int round = 0; round < 2000; ++round) {
+    std::string text(random() % 700, ' ');
+    // 一部分输入以长串反斜杠为主，覆盖奇偶反斜杠序列跨块的情况
+    size_t alphabet = round % 4 == 0 ? 3 : sizeof(kAlphabet) - 1;
+    for (char& c : text) {
+      c = kAlphabet[random() % alphabet];
+    }
+
+    std::vector<uint32_t> expected;
+    JsonStructuralScanner scalar("scalar");
+    scalar.Scan(text.data(), text.size(), true, 0, &expected);
+    for (const std::string& name : names) {
+      JsonStructuralScanner scanner(name.c_str());
+      std::vector<uint32_t> index;
+      // 随机分块输入，未扫描的部分下次重新送入
+      size_t pos = 0;
+      while (pos < text.size()) {
+        size_t end = std::min(text.size(), pos + 1 + random() % 200);
+        bool final = end == text.size();
+        pos += scanner.Scan(text.data() + pos, end - pos, final, static_cast<uint32_t>(pos),
+                            &index);
+      }
+      CHECK(index == expected);
+      CHECK(scanner.InString() == scalar.InString());
+    }
+  }
+}
+
+}   // namespace
+
+int main() {
+  TestNumberRange();
+  TestNegativeZero();
+  TestStrings();
+  TestScannerEquivalence();
+  return test::Finish("variant_json_test");
+}
@@ -0,0 +1,142 @@
+/*
+ * @Author: Nana5aki
+ * @Date: 2026-10-19 12:31:05
+ * @LastEditors: Nana5aki
+ * @LastEditTime: 2026-10-19 12:31:05
+ * @FilePath: \life_view\backend\tests\viewmodel_snapshot_test.cc
+ */
+#include "framework/core/epoch.h"
+#include "framework/mvvm/viewmodel.h"
+#include "test_util.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using framework::Epoch;
+using framework::EpochGuard;
+using framework::Variant;
+using framework::VariantArray;
+using framework::ViewModel;
+
+namespace {
+
+constexpr int kReaders = 4;
+constexpr int kWrites = 20000;
+
+struct TestViewModel : ViewModel {
+  TestViewModel()
+    : ViewModel("snapshot_test") {}
+};
+
+// 写者在一个WriteBatch里同时写入a、b和长度为a % 64的列表，读者在任意时刻都应看到三者一致
+void TestConcurrentReads() {
+  auto viewmodel = std::make_unique<TestViewModel>();
+  viewmodel->SetProp("a", Variant(0));
+  viewmodel->SetProp("b", Variant(0));
+  viewmodel->SetProp("list", Variant(VariantArray()));
+  viewmodel->EnableConcurrentReads();
+  // 开启后不再换出，快照会继续持有旧值
+  CHECK(!viewmodel->SpillProp("list"));
+
+  std::atomic<bool> stop{false};
+  std::atomic<int> torn{0};
+  std::atomic<int> stale{0};
+  std::atomic<uint64_t> reads{0};
+  std::vector<std::thread> readers;
+  for (int i = 0; i < kReaders; ++i) {
+    readers.emplace_back([&]() {
+      uint64_t last_version = 0;
+      uint64_t count = 0;
+      while (!stop.load(std::memory_order_relaxed)) {
+        EpochGuard guard;
+        const ViewModel::PropSnapshot* snapshot = viewmodel->ReadSnapshot();
+        const Variant* a = snapshot->Find("a");
+        const Variant* b = snapshot->Find("b");
+        const Variant* list = snapshot->Find("list");
+        if (!a || !b || !list || a->AsInt() != b->AsInt() ||
+            list->ArrayRef().size() != static_cast<size_t>(a->AsInt() % 64)) {
+          ++torn;
+        }
+        if (snapshot->Version() < last_version) {
+          ++stale;
+        }
+        last_version = snapshot->Version();
+        ++count;
+      }
+      reads += count;
+    });
+  }
+
+  uint64_t first_version = viewmodel->ReadSnapshot()->Version();
+  for (int i = 1; i <= kWrites; ++i) {
+    ViewModel::WriteBatch batch(viewmodel.get());
+    viewmodel->SetProp("a", Variant(i));
+    viewmodel->SetProp("b", Variant(i));
+    viewmodel->SetProp("list", Variant(VariantArray(i % 64, Variant(i))));
+    if (i % 1000 == 0) {
+      // 单核上让读者有机会运行
+      std::this_thread::yield();
+    }
+  }
+  stop = true;
+  for (auto& reader : readers) {
+    reader.join();
+  }
+
+  CHECK(torn == 0);
+  CHECK(stale == 0);
+  CHECK(reads > 0);
+  // 每个批次只发布一次
+  CHECK(viewmodel->ReadSnapshot()->Version() == first_version + kWrites);
+  CHECK(viewmodel->ReadSnapshot()->Find("a")->AsInt() == kWrites);
+
+  viewmodel.reset();
+  // 没有读者后，最多推进两次epoch即可回收全部快照
+  size_t pending = Epoch::Reclaim();
+  for (int i = 0; i < 3 && pending > 0; ++i) {
+    pending = Epoch::Reclaim();
+  }
+  CHECK(pending == 0);
+}
+
+// 未开启时不发布快照；Guard可以嵌套
+void TestDisabled() {
+  TestViewModel viewmodel;
+  viewmodel.SetProp("a", Variant(1));
+  EpochGuard outer;
+  {
+    EpochGuard inner;
+    CHECK(viewmodel.ReadSnapshot() == nullptr);
+  }
+}
+
+// Enable/Disable成对计数，全部关闭后撤下快照并恢复换出
+void TestEnableCount() {
+  TestViewModel viewmodel;
+  viewmodel.SetProp("list", Variant(VariantArray(200, Variant("a todo title"))));
+  viewmodel.EnableConcurrentReads();
+  viewmodel.EnableConcurrentReads();
+  viewmodel.DisableConcurrentReads();
+  {
+    EpochGuard guard;
+    CHECK(viewmodel.ReadSnapshot() != nullptr);
+  }
+  CHECK(!viewmodel.SpillProp("list"));
+  viewmodel.DisableConcurrentReads();
+  CHECK(!viewmodel.ConcurrentReadsEnabled());
+  CHECK(viewmodel.ReadSnapshot() == nullptr);
+  CHECK(viewmodel.SpillProp("list"));
+  // 多余的Disable不影响之后再开启
+  viewmodel.DisableConcurrentReads();
+  viewmodel.EnableConcurrentReads();
+  CHECK(viewmodel.ReadSnapshot()->Find("list")->ArrayRef().size() == 200);
+}
+
+}   // namespace
+
+int main() {
+  TestDisabled();
+  TestEnableCount();
+  TestConcurrentReads();
+  return test::Finish("viewmodel_snapshot_test");
+}
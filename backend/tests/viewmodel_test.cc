@@ -0,0 +1,182 @@
+/*
+ * @Author: Nana5aki
+ * @Date: 2026-10-19 13:02:47
+ * @LastEditors: Nana5aki
+ * @LastEditTime: 2026-10-19 13:02:47
+ * @FilePath: \life_view\backend\tests\viewmodel_test.cc
+ */
+#include "framework/mvvm/mvvm_manager.h"
+#include "framework/mvvm/viewmodel.h"
+#include "test_util.h"
+#include <memory>
+
+using framework::Variant;
+using framework::VariantArray;
+using framework::ViewModel;
+
+namespace {
+
+Variant List(int size, const char* text) {
+  return Variant(VariantArray(size, Variant(text)));
+}
+
+// 读过的属性(JS镜像只保存weak_ptr)换出后内存照常释放，读回的值也只有一份
+void TestSpillAfterRead() {
+  ViewModel viewmodel("viewmodel_test");
+  viewmodel.SetProp("list", List(1000, "a todo title that is long enough"));
+  std::weak_ptr<const Variant> read = viewmodel.FindPropShared("list");
+  size_t before = viewmodel.GetMemoryUsage().resident_bytes;
+
+  CHECK(viewmodel.SpillProp("list"));
+  CHECK(read.expired());
+  size_t spilled = viewmodel.GetMemoryUsage().resident_bytes;
+  CHECK(spilled + 30000 < before);
+
+  CHECK(viewmodel.FindProp("list")->ArrayRef().size() == 1000);
+  CHECK(viewmodel.GetMemoryUsage().resident_bytes == before);
+}
+
+// 通知期间旧值仍可取到，通知结束后释放
+void TestOldValueDuringNotify() {
+  ViewModel viewmodel("viewmodel_test");
+  viewmodel.SetProp("list", List(10, "old"));
+  std::weak_ptr<const Variant> read = viewmodel.FindPropShared("list");
+
+  int notified = 0;
+  viewmodel.BindProperty("list", [&](const std::string&, const Variant& value) {
+    ++notified;
+    ViewModel::PropValue old_value = read.lock();
+    CHECK(old_value != nullptr);
+    CHECK(old_value && old_value->ArrayRef()[0].StringRef() == "old");
+    CHECK(value.ArrayRef()[0].StringRef() == "new");
+  });
+  viewmodel.SetProp("list", List(10, "new"));
+  CHECK(notified == 1);
+  CHECK(read.expired());
+
+  // 右值版本同样保留旧值
+  viewmodel.SetProp("other", List(5, "old"));
+  std::weak_ptr<const Variant> other = viewmodel.FindPropShared("other");
+  viewmodel.BindProperty("other", [&](const std::string&, const Variant&) {
+    CHECK(!other.expired());
+  });
+  Variant next = List(5, "new");
+  viewmodel.SetProp("other", std::move(next));
+  CHECK(other.expired());
+}
+
+struct EventViewModel : ViewModel {
+  EventViewModel()
+    : ViewModel("viewmodel_test") {
+    RegisterEventProp("result");
+    RegisterCommand("Check", [](const Variant* params) { return params && params->IsInt(); });
+  }
+};
+
+// Command返回处理函数的结果，未注册的命令返回false
+void TestCommandResult() {
+  EventViewModel viewmodel;
+  Variant number(1);
+  Variant text("1");
+  CHECK(viewmodel.HasCommand("Check"));
+  CHECK(viewmodel.Command("Check", &number));
+  CHECK(!viewmodel.Command("Check", &text));
+  CHECK(!viewmodel.Command("Check", nullptr));
+  CHECK(!viewmodel.HasCommand("Missing"));
+  CHECK(!viewmodel.Command("Missing", &number));
+}
+
+// 普通属性写入相同的值不通知，事件属性每次都通知
+void TestEventProp() {
+  EventViewModel viewmodel;
+  int results = 0;
+  int states = 0;
+  viewmodel.BindProperty("result", [&](const std::string&, const Variant&) { ++results; });
+  viewmodel.BindProperty("state", [&](const std::string&, const Variant&) { ++states; });
+  for (int i = 0; i < 3; ++i) {
+    viewmodel.SetProp("result", List(3, "same"));
+    viewmodel.SetProp("state", List(3, "same"));
+  }
+  CHECK(results == 3);
+  CHECK(states == 1);
+  CHECK(viewmodel.GetPropStats().at("result").skips == 0);
+  CHECK(viewmodel.GetPropStats().at("state").skips == 2);
+
+  // 换出后写入相同的值同样通知
+  CHECK(viewmodel.SpillProp("result"));
+  viewmodel.SetProp("result", List(3, "same"));
+  CHECK(results == 4);
+}
+
+size_t TotalResident(const std::vector<std::shared_ptr<ViewModel>>& viewmodels) {
+  size_t total = 0;
+  for (const auto& viewmodel : viewmodels) {
+    total += viewmodel->GetMemoryUsage().resident_bytes;
+  }
+  return total;
+}
+
+bool Spilled(ViewModel* viewmodel, const std::string& name) {
+  return viewmodel->GetPropMemory().at(name).spilled;
+}
+
+// 超出预算时跨ViewModel按最久未访问的顺序换出，小于1KB和有属性监听的不换出
+void TestMemoryBudget() {
+  MVVMManager* manager = MVVMManager::getInstance();
+  manager->registerViewModelFactory("budget_test",
+                                    []() { return std::make_shared<ViewModel>("budget_test"); });
+  std::shared_ptr<ViewModel> first = manager->createViewModel("budget_test");
+  std::shared_ptr<ViewModel> second = manager->createViewModel("budget_test");
+  std::vector<std::shared_ptr<ViewModel>> viewmodels = {first, second};
+
+  const char* text = "a todo title that is long enough";
+  first->SetProp("a", List(100, text));
+  second->SetProp("b", List(100, text));
+  first->SetProp("c", List(100, text));
+  first->SetProp("small", Variant("tiny"));
+  second->SetProp("watched", List(100, text));
+  second->BindProperty("watched", [](const std::string&, const Variant&) {});
+  // 读取也算访问，a变为最近使用，冷热顺序为b、c、a
+  CHECK(first->FindProp("a") != nullptr);
+
+  // 没有预算时写入只标记过期，查询时补算的占用与写入时直接计算的一致
+  size_t lazy_bytes = first->GetPropMemory().at("a").bytes;
+  CHECK(lazy_bytes > 1024);
+  CHECK(first->GetPropMemory().at("small").bytes < 1024);
+  CHECK(manager->enforceMemoryBudget() == 0);
+
+  // 刚好超出预算，换出最冷的一个即可降到90%以下
+  manager->setMemoryBudget(TotalResident(viewmodels) - 1);
+  CHECK(Spilled(second.get(), "b"));
+  CHECK(!Spilled(first.get(), "c") && !Spilled(first.get(), "a"));
+  CHECK(TotalResident(viewmodels) <= manager->getMemoryBudget() / 10 * 9);
+
+  // 设置预算后写入立即计算占用；写入也算访问，c变为最近使用
+  first->SetProp("c", List(101, text));
+  CHECK(!first->GetPropMemory().at("c").stale);
+  manager->setMemoryBudget(TotalResident(viewmodels) - 1);
+  CHECK(Spilled(first.get(), "a"));
+  CHECK(!Spilled(first.get(), "c"));
+
+  // 预算再小也不换出小属性和有监听的属性
+  manager->setMemoryBudget(1);
+  CHECK(Spilled(first.get(), "c"));
+  CHECK(!Spilled(first.get(), "small"));
+  CHECK(!Spilled(second.get(), "watched"));
+  CHECK(manager->enforceMemoryBudget() == 0);
+
+  manager->setMemoryBudget(0);
+  CHECK(first->FindProp("a")->ArrayRef().size() == 100);
+  CHECK(first->GetPropMemory().at("a").bytes == lazy_bytes);
+}
+
+}   // namespace
+
+int main() {
+  TestSpillAfterRead();
+  TestOldValueDuringNotify();
+  TestEventProp();
+  TestCommandResult();
+  TestMemoryBudget();
+  return test::Finish("viewmodel_test");
+}
@@ -0,0 +1,37 @@
+/*
+ * @Author: Nana5aki
+ * @Date: 2026-10-19 14:52:37
+ * @LastEditors: Nana5aki
+ * @LastEditTime: 2026-10-19 14:52:37
+ * @FilePath: \life_view\backend\tools\bench\bench_todos.h
+ */
+#pragma once
+
+#include "model/todo/todo_codec.h"
+#include <string>
+
+// 基准测试共用的todo数据，内容只由序号决定，各基准和脚本生成的数据一致
+namespace bench {
+
+// 2026-01-01 00:00:00 UTC
+constexpr double kTodoEpochMs = 1767225600000.0;
+
+inline framework::VariantMap MakeTodo(size_t i) {
+  static const char* const kStatuses[] = {"todo", "doing", "done", "cancelled"};
+  framework::VariantMap todo = LifeV::MakeEmptyTodo();
+  todo["id"] = framework::Variant("todo-" + std::to_string(i));
+  todo["title"] = framework::Variant("Task number " + std::to_string(i));
+  todo["notes"] = framework::Variant(i % 3 == 0 ? "call back, then \"confirm\"" : "");
+  todo["status"] = framework::Variant(kStatuses[i % 4]);
+  todo["priority"] = framework::Variant(static_cast<int>(i % 5));
+  todo["due"] = framework::Variant(kTodoEpochMs + static_cast<double>(i % 1000) * 3600000.0);
+  framework::VariantArray tags;
+  tags.emplace_back("work");
+  if (i % 2 == 0) {
+    tags.emplace_back("home");
+  }
+  todo["tags"] = framework::Variant(std::move(tags));
+  return todo;
+}
+
+}   // namespace bench
@@ -0,0 +1,83 @@
+/*
+ * @Author: Nana5aki
+ * @Date: 2026-10-19 14:10:22
+ * @LastEditors: Nana5aki
+ * @LastEditTime: 2026-10-19 14:10:22
+ * @FilePath: \life_view\backend\tools\bench\bench_util.h
+ */
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 基准测试共用的计时和参数解析。参数均为 --name=value 形式
+namespace bench {
+
+using Clock = std::chrono::steady_clock;
+
+inline double ElapsedMs(Clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// 取 --name=value 的值，没有时返回nullptr
+inline const char* Option(int argc, char** argv, const char* name) {
+  size_t length = strlen(name);
+  for (int i = 1; i < argc; ++i) {
+    if (strncmp(argv[i], "--", 2) == 0 && strncmp(argv[i] + 2, name, length) == 0 &&
+        argv[i][2 + length] == '=') {
+      return argv[i] + 3 + length;
+    }
+  }
+  return nullptr;
+}
+
+inline size_t SizeOption(int argc, char** argv, const char* name, size_t fallback) {
+  const char* value = Option(argc, argv, name);
+  return value ? static_cast<size_t>(std::strtoull(value, nullptr, 10)) : fallback;
+}
+
+// 运行环境，单核结果不能说明并行部分的扩展性
+inline void PrintEnvironment() {
+  printf("hardware threads: %u\n", std::thread::hardware_concurrency());
+}
+
+// 跑repeat次取最快的一次，毫秒
+template <typename Fn>
+double BestOf(size_t repeat, Fn fn) {
+  double best = 0;
+  for (size_t i = 0; i < std::max<size_t>(repeat, 1); ++i) {
+    Clock::time_point start = Clock::now();
+    fn();
+    double elapsed = ElapsedMs(start);
+    best = i == 0 ? elapsed : std::min(best, elapsed);
+  }
+  return best;
+}
+
+inline double Percentile(std::vector<double> values, double percent) {
+  if (values.empty()) {
+    return 0;
+  }
+  std::sort(values.begin(), values.end());
+  size_t rank = static_cast<size_t>(percent / 100.0 * static_cast<double>(values.size()));
+  return values[std::min(rank, values.size() - 1)];
+}
+
+// 防止编译器把结果未被使用的计算优化掉
+template <typename T>
+inline void DoNotOptimize(const T& value) {
+#ifdef _MSC_VER
+  static const void* volatile sink;
+  sink = &value;
+#else
+  asm volatile("" : : "r,m"(value) : "memory");
+#endif
+}
+
+}   // namespace bench
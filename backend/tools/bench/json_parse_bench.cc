@@ -0,0 +1,117 @@
+/*
+ * @Author: Nana5aki
+ * @Date: 2026-10-19 14:52:37
+ * @LastEditors: Nana5aki
+ * @LastEditTime: 2026-10-19 14:52:37
+ * @FilePath: \life_view\backend\tools\bench\json_parse_bench.cc
+ */
+// 原生JSON解析的吞吐：各结构扫描实现单独的第一步、完整解析和流式解析。
+//
+//   json_parse_bench [--todos=100000] [--repeat=5] [--file=todos.json]
+//
+// 与JSON.parse + NValueToVariant的对比见scripts/bench_json_parse.ts，
+// 两边默认生成相同的文档，也可以用--file解析同一个文件
+#include "bench_todos.h"
+#include "bench_util.h"
+#include "framework/mvvm/variant_json.h"
+#include <fstream>
+#include <sstream>
+
+using framework::JsonStreamParser;
+using framework::JsonStructuralScanner;
+using framework::Variant;
+using framework::VariantArray;
+
+namespace {
+
+std::string MakeDocument(size_t todos) {
+  VariantArray array;
+  array.reserve(todos);
+  for (size_t i = 0; i < todos; ++i) {
+    array.emplace_back(bench::MakeTodo(i));
+  }
+  return framework::ToJson(Variant(std::move(array)));
+}
+
+bool ReadDocument(const char* path, std::string* out) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    return false;
+  }
+  std::ostringstream text;
+  text << file.rdbuf();
+  *out = text.str();
+  return true;
+}
+
+void PrintRow(const std::string& name, double ms, size_t bytes) {
+  double mb = static_cast<double>(bytes) / (1024 * 1024);
+  printf("%-24s %10.2f %10.1f\n", name.c_str(), ms, mb / ms * 1000);
+}
+
+}   // namespace
+
+int main(int argc, char** argv) {
+  size_t repeat = bench::SizeOption(argc, argv, "repeat", 5);
+  std::string document;
+  if (const char* path = bench::Option(argc, argv, "file")) {
+    if (!ReadDocument(path, &document)) {
+      fprintf(stderr, "cannot read %s\n", path);
+      return 1;
+    }
+  } else {
+    document = MakeDocument(bench::SizeOption(argc, argv, "todos", 100000));
+  }
+  bench::PrintEnvironment();
+  printf("document: %.1f MB, default scanner %s, best of %zu\n",
+         static_cast<double>(document.size()) / (1024 * 1024), framework::JsonScannerName(),
+         repeat);
+  printf("%-24s %10s %10s\n", "stage", "ms", "MB/s");
+
+  for (const std::string& name : framework::JsonScannerNames()) {
+    std::vector<uint32_t> index;
+    index.reserve(document.size() / 4 + 16);
+    double ms = bench::BestOf(repeat, [&]() {
+      index.clear();
+      JsonStructuralScanner scanner(name.c_str());
+      scanner.Scan(document.data(), document.size(), true, 0, &index);
+      bench::DoNotOptimize(index.data());
+    });
+    PrintRow("scan " + name, ms, document.size());
+  }
+
+  std::string error;
+  bool ok = true;
+  double parse_ms = bench::BestOf(repeat, [&]() {
+    Variant value;
+    ok = ok && framework::ParseJson(document, &value, &error);
+    bench::DoNotOptimize(value);
+  });
+  PrintRow("ParseJson", parse_ms, document.size());
+
+  // 与导入相同的64KB分块
+  size_t values = 0;
+  double stream_ms = bench::BestOf(repeat, [&]() {
+    values = 0;
+    JsonStreamParser parser(JsonStreamParser::Mode::TopLevelArray,
+                            [&values](Variant&&) { ++values; });
+    for (size_t pos = 0; pos < document.size(); pos += 65536) {
+      ok = ok && parser.Feed(document.data() + pos, std::min<size_t>(65536, document.size() - pos));
+    }
+    ok = ok && parser.Finish();
+  });
+  PrintRow("JsonStreamParser", stream_ms, document.size());
+
+  Variant value;
+  if (!ok || !framework::ParseJson(document, &value, &error)) {
+    fprintf(stderr, "parse failed: %s\n", error.c_str());
+    return 1;
+  }
+  std::string json;
+  double write_ms = bench::BestOf(repeat, [&]() {
+    json.clear();
+    framework::WriteJson(value, &json);
+  });
+  PrintRow("WriteJson", write_ms, json.size());
+  return 0;
+}
@@ -0,0 +1,148 @@
+/*
+ * @Author: Nana5aki
+ * @Date: 2026-10-19 17:12:36
+ * @LastEditors: Nana5aki
+ * @LastEditTime: 2026-10-19 17:12:36
+ * @FilePath: \life_view\backend\tools\bench\snapshot_read_bench.cc
+ */
+// 跨线程读取属性的扩展性：1..N个读线程在写线程持续写入的同时读取，
+// 对比快照读取(EpochGuard + ReadSnapshot)与读写锁保护下拷贝属性值。
+//
+//   snapshot_read_bench [--threads=硬件线程数] [--ms=500] [--rows=1000]
+//
+// 每轮读线程数翻倍直到threads；单核机器上各轮只能说明开销，不能说明扩展性。
+// writes为同一时间内写入的次数，读者持续持有读锁时写者可能几乎拿不到锁
+#include "bench_todos.h"
+#include "bench_util.h"
+#include "framework/core/epoch.h"
+#include "framework/mvvm/viewmodel.h"
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+
+using framework::EpochGuard;
+using framework::Variant;
+using framework::VariantArray;
+using framework::ViewModel;
+
+namespace {
+
+struct BenchViewModel : ViewModel {
+  BenchViewModel()
+    : ViewModel("snapshot_read_bench") {}
+};
+
+Variant MakeList(size_t rows, size_t version) {
+  VariantArray todos;
+  todos.reserve(rows);
+  for (size_t i = 0; i < rows; ++i) {
+    todos.emplace_back(bench::MakeTodo(version + i));
+  }
+  return Variant(std::move(todos));
+}
+
+struct Result {
+  uint64_t reads = 0;
+  uint64_t writes = 0;
+};
+
+// 读线程持续读取，写线程每隔约1ms写入一次，ms毫秒后全部停止。
+// 写线程单独运行：加锁时写者可能长时间拿不到锁，不能让它决定何时结束
+template <typename Read, typename Write>
+Result Run(size_t threads, size_t ms, Read read, Write write) {
+  std::atomic<bool> stop{false};
+  std::atomic<uint64_t> reads{0};
+  std::vector<std::thread> readers;
+  for (size_t i = 0; i < threads; ++i) {
+    readers.emplace_back([&]() {
+      uint64_t count = 0;
+      while (!stop.load(std::memory_order_relaxed)) {
+        read();
+        ++count;
+      }
+      reads += count;
+    });
+  }
+  Result result;
+  std::thread writer([&]() {
+    while (!stop.load(std::memory_order_relaxed)) {
+      write(++result.writes);
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+  stop = true;
+  for (auto& reader : readers) {
+    reader.join();
+  }
+  writer.join();
+  result.reads = reads;
+  return result;
+}
+
+}   // namespace
+
+int main(int argc, char** argv) {
+  size_t max_threads = bench::SizeOption(
+    argc, argv, "threads", std::max<size_t>(std::thread::hardware_concurrency(), 1));
+  size_t ms = bench::SizeOption(argc, argv, "ms", 500);
+  size_t rows = bench::SizeOption(argc, argv, "rows", 1000);
+  bench::PrintEnvironment();
+  printf("list of %zu todos, %zu ms per run\n", rows, ms);
+
+  // 写入的值预先生成，计时只包含写入和发布本身
+  std::vector<Variant> lists = {MakeList(rows, 0), MakeList(rows, 1)};
+
+  BenchViewModel viewmodel;
+  viewmodel.SetProp("count", Variant(0));
+  viewmodel.SetProp("list", lists[0]);
+  viewmodel.EnableConcurrentReads();
+
+  // 对照：读写锁保护属性表，读者拷贝出值后再使用，相当于在主线程外调用GetProp
+  std::shared_mutex mutex;
+  Variant locked_count(0);
+  Variant locked_list = lists[0];
+
+  printf("%-8s %14s %14s %14s %14s\n", "readers", "snapshot_rps", "writes", "locked_rps",
+         "writes");
+  for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+    Result snapshot = Run(
+      threads,
+      ms,
+      [&]() {
+        EpochGuard guard;
+        const ViewModel::PropSnapshot* props = viewmodel.ReadSnapshot();
+        const Variant* count = props->Find("count");
+        const Variant* list = props->Find("list");
+        bench::DoNotOptimize(count->AsInt() + static_cast<int>(list->ArrayRef().size()));
+      },
+      [&](uint64_t version) {
+        ViewModel::WriteBatch batch(&viewmodel);
+        viewmodel.SetProp("count", Variant(static_cast<int>(version)));
+        viewmodel.SetProp("list", lists[version % 2]);
+      });
+
+    Result locked = Run(
+      threads,
+      ms,
+      [&]() {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        Variant count = locked_count;
+        Variant list = locked_list;
+        bench::DoNotOptimize(count.AsInt() + static_cast<int>(list.ArrayRef().size()));
+      },
+      [&](uint64_t version) {
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        locked_count = Variant(static_cast<int>(version));
+        locked_list = lists[version % 2];
+      });
+
+    printf("%-8zu %14.0f %14llu %14.0f %14llu\n",
+           threads,
+           static_cast<double>(snapshot.reads) / static_cast<double>(ms) * 1000,
+           static_cast<unsigned long long>(snapshot.writes),
+           static_cast<double>(locked.reads) / static_cast<double>(ms) * 1000,
+           static_cast<unsigned long long>(locked.writes));
+  }
+  return 0;
+}
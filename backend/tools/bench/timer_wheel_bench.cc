@@ -0,0 +1,151 @@
+/*
+ * @Author: Nana5aki
+ * @Date: 2026-10-19 15:40:12
+ * @LastEditors: Nana5aki
+ * @LastEditTime: 2026-10-19 15:40:12
+ * @FilePath: \life_view\backend\tools\bench\timer_wheel_bench.cc
+ */
+// 大量提醒时定时器的开销：插入、取消一半、推进到全部到期，与std::multimap对比。
+//
+//   timer_wheel_bench [--timers=500000] [--span_ms=604800000] [--step_ms=1000] [--repeat=3]
+//
+// 到期时间在span_ms内均匀分布(默认一周)，推进按step_ms一步，模拟主线程定期醒来
+#include "bench_util.h"
+#include "framework/core/timer_wheel.h"
+#include <map>
+#include <random>
+
+using framework::TimerWheel;
+
+namespace {
+
+struct Result {
+  double insert_ms = 0;
+  double cancel_ms = 0;
+  double advance_ms = 0;
+  size_t fired = 0;
+};
+
+Result RunWheel(const std::vector<uint64_t>& expiries, uint64_t step) {
+  Result result;
+  TimerWheel wheel(0);
+  std::vector<TimerWheel::TimerId> ids(expiries.size());
+  size_t fired = 0;
+  bench::Clock::time_point start = bench::Clock::now();
+  for (size_t i = 0; i < expiries.size(); ++i) {
+    ids[i] = wheel.Insert(expiries[i], [&fired]() { ++fired; });
+  }
+  result.insert_ms = bench::ElapsedMs(start);
+
+  start = bench::Clock::now();
+  for (size_t i = 0; i < ids.size(); i += 2) {
+    wheel.Cancel(ids[i]);
+  }
+  result.cancel_ms = bench::ElapsedMs(start);
+
+  start = bench::Clock::now();
+  std::vector<TimerWheel::Task> tasks;
+  for (uint64_t now = 0; wheel.Size() > 0; now += step) {
+    tasks.clear();
+    wheel.Advance(now, &tasks);
+    for (auto& task : tasks) {
+      task();
+    }
+  }
+  result.advance_ms = bench::ElapsedMs(start);
+  result.fired = fired;
+  return result;
+}
+
+// 常见的替代实现：有序容器，插入和取消O(log n)
+Result RunMultimap(const std::vector<uint64_t>& expiries, uint64_t step) {
+  using Timers = std::multimap<uint64_t, TimerWheel::Task>;
+  Result result;
+  Timers timers;
+  std::vector<Timers::iterator> ids(expiries.size());
+  size_t fired = 0;
+  bench::Clock::time_point start = bench::Clock::now();
+  for (size_t i = 0; i < expiries.size(); ++i) {
+    ids[i] = timers.emplace(expiries[i], [&fired]() { ++fired; });
+  }
+  result.insert_ms = bench::ElapsedMs(start);
+
+  start = bench::Clock::now();
+  for (size_t i = 0; i < ids.size(); i += 2) {
+    timers.erase(ids[i]);
+  }
+  result.cancel_ms = bench::ElapsedMs(start);
+
+  start = bench::Clock::now();
+  std::vector<TimerWheel::Task> tasks;
+  for (uint64_t now = 0; !timers.empty(); now += step) {
+    tasks.clear();
+    auto end = timers.upper_bound(now);
+    for (auto it = timers.begin(); it != end; ++it) {
+      tasks.push_back(std::move(it->second));
+    }
+    timers.erase(timers.begin(), end);
+    for (auto& task : tasks) {
+      task();
+    }
+  }
+  result.advance_ms = bench::ElapsedMs(start);
+  result.fired = fired;
+  return result;
+}
+
+void PrintResult(const char* name, const Result& result, size_t timers) {
+  auto ns_per = [](double ms, size_t count) { return ms * 1e6 / static_cast<double>(count); };
+  printf("%-10s %10.1f %10.1f %10.1f %10.1f %10.1f %10.1f\n",
+         name,
+         result.insert_ms,
+         ns_per(result.insert_ms, timers),
+         result.cancel_ms,
+         ns_per(result.cancel_ms, timers / 2),
+         result.advance_ms,
+         ns_per(result.advance_ms, result.fired));
+}
+
+}   // namespace
+
+int main(int argc, char** argv) {
+  size_t count = bench::SizeOption(argc, argv, "timers", 500000);
+  uint64_t span = bench::SizeOption(argc, argv, "span_ms", 7ull * 24 * 3600 * 1000);
+  uint64_t step = std::max<size_t>(1, bench::SizeOption(argc, argv, "step_ms", 1000));
+  size_t repeat = bench::SizeOption(argc, argv, "repeat", 3);
+
+  std::mt19937_64 random(42);
+  std::vector<uint64_t> expiries(count);
+  for (auto& expiry : expiries) {
+    expiry = 1 + random() % std::max<uint64_t>(span, 1);
+  }
+
+  printf("%zu timers over %llu ms, advancing %llu ms per step, best of %zu\n", count,
+         static_cast<unsigned long long>(span), static_cast<unsigned long long>(step), repeat);
+  printf("%-10s %10s %10s %10s %10s %10s %10s\n", "impl", "insert_ms", "ns/insert", "cancel_ms",
+         "ns/cancel", "advance_ms", "ns/fire");
+  Result best_wheel, best_map;
+  for (size_t i = 0; i < std::max<size_t>(repeat, 1); ++i) {
+    Result wheel = RunWheel(expiries, step);
+    Result map = RunMultimap(expiries, step);
+    // 偶数下标的已取消
+    if (wheel.fired != count / 2 || map.fired != wheel.fired) {
+      fprintf(stderr, "fired %zu / %zu timers\n", wheel.fired, map.fired);
+      return 1;
+    }
+    auto keep_best = [i](Result* best, const Result& result) {
+      if (i == 0) {
+        *best = result;
+        return;
+      }
+      best->insert_ms = std::min(best->insert_ms, result.insert_ms);
+      best->cancel_ms = std::min(best->cancel_ms, result.cancel_ms);
+      best->advance_ms = std::min(best->advance_ms, result.advance_ms);
+    };
+    keep_best(&best_wheel, wheel);
+    keep_best(&best_map, map);
+  }
+  PrintResult("wheel", best_wheel, count);
+  PrintResult("multimap", best_map, count);
+  return 0;
+}
@@ -0,0 +1,127 @@
+/*
+ * @Author: Nana5aki
+ * @Date: 2026-10-19 16:34:50
+ * @LastEditors: Nana5aki
+ * @LastEditTime: 2026-10-19 16:34:50
+ * @FilePath: \life_view\backend\tools\bench\todo_columns_bench.cc
+ */
+// todo列式查询的耗时：各核函数实现的区间过滤和计数，以及过滤、分组与逐行遍历Variant的对比。
+//
+//   todo_columns_bench [--rows=1000000] [--repeat=5]
+//
+// 单线程，结果与核数无关；核函数实现可用 LIFE_VIEW_COLUMN_KERNELS 指定
+#include "bench_todos.h"
+#include "bench_util.h"
+#include "framework/core/column_kernels.h"
+#include "model/todo/todo_columns.h"
+
+using framework::ColumnKernels;
+using framework::Variant;
+using framework::VariantArray;
+using LifeV::TodoColumns;
+using LifeV::TodoFilter;
+using LifeV::TodoGroupKey;
+
+namespace {
+
+constexpr int64_t kDayMs = 86400000;
+
+// 各实现对同一列做[from, to)过滤再计数
+void BenchKernels(const std::vector<int64_t>& due, int64_t from, int64_t to, size_t repeat) {
+  printf("%-8s %12s %12s %12s\n", "kernels", "mask_ms", "count_ms", "rows_per_s");
+  std::vector<uint64_t> mask(framework::BitmapWords(due.size()));
+  for (const ColumnKernels& kernels : framework::AvailableColumnKernels()) {
+    double mask_ms = bench::BestOf(repeat, [&]() {
+      kernels.range_mask(due.data(), due.size(), from, to, mask.data());
+      bench::DoNotOptimize(mask.data());
+    });
+    size_t count = 0;
+    double count_ms = bench::BestOf(repeat, [&]() {
+      count = kernels.bitmap_count(mask.data(), mask.size());
+      bench::DoNotOptimize(count);
+    });
+    printf("%-8s %12.3f %12.3f %12.0f\n", kernels.name, mask_ms, count_ms,
+           static_cast<double>(due.size()) / (mask_ms + count_ms) * 1000);
+  }
+}
+
+// 不使用列式副本，逐行读取Variant判断状态和截止时间
+size_t CountRows(const VariantArray& todos, const TodoFilter& filter) {
+  size_t count = 0;
+  for (const Variant& todo : todos) {
+    const framework::VariantMap& map = todo.MapRef();
+    auto status = map.find("status");
+    if (status == map.end() || !status->second.IsString() ||
+        status->second.StringRef() != filter.statuses.front()) {
+      continue;
+    }
+    auto due = map.find("due");
+    if (due == map.end() || due->second.IsNull()) {
+      continue;
+    }
+    int64_t ms = static_cast<int64_t>(due->second.AsDouble());
+    count += ms >= filter.due.from && ms < filter.due.to;
+  }
+  return count;
+}
+
+}   // namespace
+
+int main(int argc, char** argv) {
+  size_t rows = bench::SizeOption(argc, argv, "rows", 1000000);
+  size_t repeat = bench::SizeOption(argc, argv, "repeat", 5);
+  bench::PrintEnvironment();
+  printf("column kernels: %s, %zu rows, best of %zu\n", framework::ColumnKernelName(), rows,
+         repeat);
+
+  VariantArray todos;
+  todos.reserve(rows);
+  for (size_t i = 0; i < rows; ++i) {
+    todos.emplace_back(bench::MakeTodo(i));
+  }
+  TodoColumns columns;
+  bench::Clock::time_point start = bench::Clock::now();
+  columns.Append(todos);
+  printf("append: %.1f ms\n\n", bench::ElapsedMs(start));
+
+  // MakeTodo的截止时间分布在1000小时内，取其中十天
+  int64_t epoch = static_cast<int64_t>(bench::kTodoEpochMs);
+  TodoFilter filter;
+  filter.statuses.push_back("todo");
+  filter.due.enabled = true;
+  filter.due.from = epoch + 10 * kDayMs;
+  filter.due.to = epoch + 20 * kDayMs;
+
+  std::vector<int64_t> due(rows);
+  for (size_t i = 0; i < rows; ++i) {
+    due[i] = static_cast<int64_t>(todos[i].MapRef().at("due").AsDouble());
+  }
+  BenchKernels(due, filter.due.from, filter.due.to, repeat);
+
+  size_t expected = CountRows(todos, filter);
+  size_t counted = 0;
+  double rows_ms = bench::BestOf(repeat, [&]() { bench::DoNotOptimize(CountRows(todos, filter)); });
+  double count_ms = bench::BestOf(repeat, [&]() { counted = columns.Count(filter); });
+
+  std::vector<uint64_t> mask;
+  columns.Filter(TodoFilter(), &mask);
+  std::vector<std::pair<std::string, size_t>> groups;
+  std::vector<size_t> days;
+  double status_ms = bench::BestOf(repeat, [&]() { columns.CountByStatus(mask, &groups); });
+  double tag_ms = bench::BestOf(repeat, [&]() { columns.CountByTag(mask, &groups); });
+  double day_ms = bench::BestOf(repeat, [&]() {
+    columns.CountByDay(TodoGroupKey::DueDay, mask, LifeV::TodoDayIndex(epoch), 42, &days);
+  });
+
+  printf("\n%-20s %10s\n", "query", "ms");
+  printf("%-20s %10.3f\n", "count (row loop)", rows_ms);
+  printf("%-20s %10.3f\n", "count (columns)", count_ms);
+  printf("%-20s %10.3f\n", "group by status", status_ms);
+  printf("%-20s %10.3f\n", "group by tag", tag_ms);
+  printf("%-20s %10.3f\n", "group by due day", day_ms);
+  if (counted != expected) {
+    fprintf(stderr, "count mismatch: columns %zu, row loop %zu\n", counted, expected);
+    return 1;
+  }
+  return 0;
+}
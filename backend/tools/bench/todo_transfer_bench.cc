@@ -0,0 +1,97 @@
+/*
+ * @Author: Nana5aki
+ * @Date: 2026-10-19 14:10:22
+ * @LastEditors: Nana5aki
+ * @LastEditTime: 2026-10-19 14:10:22
+ * @FilePath: \life_view\backend\tools\bench\todo_transfer_bench.cc
+ */
+// todo批量导入导出的吞吐，三种格式各先导出再导入同一份数据。
+//
+//   todo_transfer_bench [--rows=1000000] [--repeat=3]
+//
+// 导入导出在共享线程池中并行，吞吐随核数变化，结果需要带上打印的线程数一起看
+#include "bench_todos.h"
+#include "bench_util.h"
+#include "framework/core/thread_pool.h"
+#include "model/todo/todo_transfer.h"
+#include <filesystem>
+#include <memory>
+
+using framework::VariantArray;
+using LifeV::TodoFileFormat;
+using LifeV::TodoSegment;
+
+namespace {
+
+constexpr size_t kSegmentRows = 65536;
+
+std::vector<TodoSegment> MakeTodos(size_t rows) {
+  std::vector<TodoSegment> segments;
+  VariantArray segment;
+  for (size_t i = 0; i < rows; ++i) {
+    segment.emplace_back(bench::MakeTodo(i));
+    if (segment.size() == kSegmentRows || i + 1 == rows) {
+      segments.push_back(std::make_shared<const VariantArray>(std::move(segment)));
+      segment = VariantArray();
+    }
+  }
+  return segments;
+}
+
+}   // namespace
+
+int main(int argc, char** argv) {
+  size_t rows = bench::SizeOption(argc, argv, "rows", 1000000);
+  size_t repeat = bench::SizeOption(argc, argv, "repeat", 3);
+  bench::PrintEnvironment();
+  printf("thread pool: %zu threads, %zu rows, best of %zu\n",
+         framework::ThreadPool::GetInstance()->ThreadCount(), rows, repeat);
+
+  std::vector<TodoSegment> segments = MakeTodos(rows);
+  std::filesystem::path dir = std::filesystem::temp_directory_path() / "life_view_transfer_bench";
+  std::filesystem::create_directories(dir);
+
+  struct Format {
+    const char* name;
+    TodoFileFormat format;
+  };
+  const Format formats[] = {{"csv", TodoFileFormat::Csv},
+                            {"ics", TodoFileFormat::ICalendar},
+                            {"json", TodoFileFormat::Json}};
+  printf("%-6s %12s %12s %12s %12s %10s\n", "format", "export_ms", "export_rps", "import_ms",
+         "import_rps", "file_mb");
+  int status = 0;
+  for (const Format& format : formats) {
+    std::string path = (dir / (std::string("todos.") + format.name)).string();
+    std::string error;
+    bool ok = true;
+    double export_ms = bench::BestOf(repeat, [&]() {
+      ok = ok && LifeV::ExportTodoFile(path, format.format, segments, nullptr, &error);
+    });
+    size_t imported = 0;
+    double import_ms = bench::BestOf(repeat, [&]() {
+      imported = 0;
+      ok = ok && LifeV::ImportTodoFile(
+                   path,
+                   format.format,
+                   [&imported](VariantArray&& todos, double, double) { imported += todos.size(); },
+                   &error);
+    });
+    if (!ok || imported != rows) {
+      fprintf(stderr, "%s: failed (%s), imported %zu rows\n", format.name, error.c_str(),
+              imported);
+      status = 1;
+      continue;
+    }
+    double file_mb = static_cast<double>(std::filesystem::file_size(path)) / (1024 * 1024);
+    printf("%-6s %12.1f %12.0f %12.1f %12.0f %10.1f\n",
+           format.name,
+           export_ms,
+           static_cast<double>(rows) / export_ms * 1000,
+           import_ms,
+           static_cast<double>(rows) / import_ms * 1000,
+           file_mb);
+  }
+  std::filesystem::remove_all(dir);
+  return status;
+}
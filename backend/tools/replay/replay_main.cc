@@ -0,0 +1,307 @@
+/*
+ * @Author: Nana5aki
+ * @Date: 2026-10-18 22:58:12
+ * @LastEditors: Nana5aki
+ * @LastEditTime: 2026-10-18 22:58:12
+ * @FilePath: \life_view\backend\tools\replay\replay_main.cc
+ */
+// 无界面回放CommandTrace录制的命令流，输出每个命令的延迟分位数。
+//
+//   life_view_replay <trace> [--speed=max|real|<倍数>] [--settle-ms=N] [--strict]
+//
+// --speed     max(默认)连续执行；real按录制时的间隔；数字为相对录制速度的倍数
+// --settle-ms 最后一条命令之后等待后台任务投递回主线程的空闲时间，默认1000；
+//             也是每条命令前等待异步结果的上限
+// --strict    录制了属性值且回放后最终值不同时返回2
+#include "framework/core/main_thread.h"
+#include "framework/mvvm/command_trace.h"
+#include "framework/mvvm/mvvm_manager.h"
+#include "viewmodel/view_model_registry.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using framework::MainThread;
+using framework::TraceReader;
+using framework::TraceRecord;
+using framework::TraceRecordType;
+using framework::Variant;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+struct Options {
+  std::string trace_path;
+  // 0表示不等待
+  double speed = 0;
+  int settle_ms = 1000;
+  bool strict = false;
+};
+
+struct CommandStats {
+  std::vector<double> replay_us;
+  std::vector<double> recorded_us;
+};
+
+struct PropState {
+  uint64_t recorded_count = 0;
+  uint64_t replay_count = 0;
+  bool has_recorded_value = false;
+  uint64_t recorded_hash = 0;
+  bool has_replay_value = false;
+  uint64_t replay_hash = 0;
+};
+
+// 主线程任务循环：MainThread::Post唤醒这里，代替Node的事件循环
+std::mutex wake_mutex;
+std::condition_variable wake_cv;
+bool woken = false;
+
+void InstallWaker() {
+  MainThread::SetWaker([]() {
+    std::lock_guard<std::mutex> lock(wake_mutex);
+    woken = true;
+    wake_cv.notify_one();
+  });
+}
+
+// 执行投递的任务直到deadline
+void PumpUntil(Clock::time_point deadline) {
+  for (;;) {
+    MainThread::RunPending();
+    std::unique_lock<std::mutex> lock(wake_mutex);
+    if (!wake_cv.wait_until(lock, deadline, []() { return woken; })) {
+      return;
+    }
+    woken = false;
+  }
+}
+
+// 执行投递的任务直到done()返回true，最多等到deadline
+template <typename Done>
+bool PumpUntilDone(Clock::time_point deadline, Done done) {
+  for (;;) {
+    MainThread::RunPending();
+    if (done()) {
+      return true;
+    }
+    std::unique_lock<std::mutex> lock(wake_mutex);
+    if (!wake_cv.wait_until(lock, deadline, []() { return woken; })) {
+      return false;
+    }
+    woken = false;
+  }
+}
+
+// 连续idle_ms没有新任务为止，最多等max_ms
+void PumpUntilIdle(int idle_ms, int max_ms) {
+  Clock::time_point limit = Clock::now() + std::chrono::milliseconds(max_ms);
+  for (;;) {
+    MainThread::RunPending();
+    std::unique_lock<std::mutex> lock(wake_mutex);
+    Clock::time_point deadline =
+      std::min(limit, Clock::now() + std::chrono::milliseconds(idle_ms));
+    if (!wake_cv.wait_until(lock, deadline, []() { return woken; })) {
+      return;
+    }
+    woken = false;
+  }
+}
+
+double Percentile(std::vector<double>& values, double percent) {
+  if (values.empty()) {
+    return 0;
+  }
+  std::sort(values.begin(), values.end());
+  size_t rank = static_cast<size_t>(percent / 100.0 * static_cast<double>(values.size()));
+  return values[std::min(rank, values.size() - 1)];
+}
+
+bool ParseOptions(int argc, char** argv, Options* options) {
+  for (int i = 1; i < argc; ++i) {
+    const char* arg = argv[i];
+    if (strncmp(arg, "--speed=", 8) == 0) {
+      const char* value = arg + 8;
+      if (strcmp(value, "max") == 0) {
+        options->speed = 0;
+      } else if (strcmp(value, "real") == 0) {
+        options->speed = 1;
+      } else {
+        options->speed = std::atof(value);
+        if (options->speed <= 0) {
+          return false;
+        }
+      }
+    } else if (strncmp(arg, "--settle-ms=", 12) == 0) {
+      options->settle_ms = std::atoi(arg + 12);
+    } else if (strcmp(arg, "--strict") == 0) {
+      options->strict = true;
+    } else if (arg[0] != '-' && options->trace_path.empty()) {
+      options->trace_path = arg;
+    } else {
+      return false;
+    }
+  }
+  return !options->trace_path.empty();
+}
+
+}   // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  if (!ParseOptions(argc, argv, &options)) {
+    fprintf(stderr,
+            "usage: %s <trace> [--speed=max|real|<factor>] [--settle-ms=N] [--strict]\n",
+            argv[0]);
+    return 1;
+  }
+
+  // 先读完整个文件，回放计时不包含解码
+  TraceReader reader;
+  std::string error;
+  if (!reader.Open(options.trace_path, &error)) {
+    fprintf(stderr, "%s\n", error.c_str());
+    return 1;
+  }
+  std::vector<TraceRecord> records;
+  TraceRecord record;
+  while (reader.Next(&record, &error)) {
+    records.push_back(std::move(record));
+  }
+  if (!error.empty()) {
+    // 录制进程被强制结束时最后一条记录可能不完整，之前的照常回放
+    fprintf(stderr, "warning: %s, replaying %zu records before it\n", error.c_str(),
+            records.size());
+  }
+
+  // 命令执行结束后才写入记录，时间戳是开始时间。按时间稳定排序后，
+  // 命令排在它同步触发的属性通知之前；同一微秒内命令优先
+  std::stable_sort(records.begin(), records.end(), [](const TraceRecord& a, const TraceRecord& b) {
+    bool a_notify = a.type == TraceRecordType::PropChanged;
+    bool b_notify = b.type == TraceRecordType::PropChanged;
+    return a.time_us != b.time_us ? a.time_us < b.time_us : !a_notify && b_notify;
+  });
+
+  InstallWaker();
+  LifeV::RegisterViewModels();
+
+  std::unordered_map<uint64_t, std::shared_ptr<framework::ViewModel>> instances;
+  std::map<std::pair<uint64_t, std::string>, PropState> props;
+  std::map<std::string, CommandStats> commands;
+  // 每个实例截至当前录制的通知数和回放已产生的通知数。
+  // 命令前录制里出现的通知多半来自之前命令的异步结果(如导入完成)，回放要等它们到齐，
+  // 否则依赖这些结果的命令会在不同的状态上执行
+  std::unordered_map<uint64_t, uint64_t> recorded_notifications;
+  std::unordered_map<uint64_t, uint64_t> replay_notifications;
+  size_t skipped = 0;
+  size_t barrier_timeouts = 0;
+
+  Clock::time_point start = Clock::now();
+  for (const auto& item : records) {
+    switch (item.type) {
+    case TraceRecordType::Create: {
+      auto viewmodel = MVVMManager::getInstance()->createViewModel(item.name);
+      if (!viewmodel) {
+        ++skipped;
+        break;
+      }
+      uint64_t instance = item.instance;
+      viewmodel->BindAnyProperty([&props, &replay_notifications, instance](
+                                   const std::string& name, const Variant& value) {
+        ++replay_notifications[instance];
+        PropState& state = props[{instance, name}];
+        ++state.replay_count;
+        state.has_replay_value = true;
+        state.replay_hash = value.Hash();
+      });
+      instances[instance] = viewmodel;
+      break;
+    }
+    case TraceRecordType::Command: {
+      auto it = instances.find(item.instance);
+      if (it == instances.end()) {
+        // 录制开始前创建且类型未知的ViewModel
+        ++skipped;
+        break;
+      }
+      if (options.speed > 0) {
+        PumpUntil(start + std::chrono::microseconds(
+                            static_cast<int64_t>(static_cast<double>(item.time_us) / options.speed)));
+      }
+      uint64_t expected = recorded_notifications[item.instance];
+      if (!PumpUntilDone(Clock::now() + std::chrono::milliseconds(options.settle_ms),
+                         [&]() { return replay_notifications[item.instance] >= expected; })) {
+        ++barrier_timeouts;
+      }
+      Clock::time_point begin = Clock::now();
+      it->second->Command(item.name, item.has_value ? &item.value : nullptr);
+      double elapsed =
+        std::chrono::duration<double, std::micro>(Clock::now() - begin).count();
+      CommandStats& stats = commands[item.name];
+      stats.replay_us.push_back(elapsed);
+      stats.recorded_us.push_back(static_cast<double>(item.duration_us));
+      break;
+    }
+    case TraceRecordType::PropChanged: {
+      if (instances.find(item.instance) == instances.end()) {
+        break;
+      }
+      ++recorded_notifications[item.instance];
+      PropState& state = props[{item.instance, item.name}];
+      ++state.recorded_count;
+      if (item.has_value) {
+        state.has_recorded_value = true;
+        state.recorded_hash = item.value.Hash();
+      }
+      break;
+    }
+    }
+  }
+  double command_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+  PumpUntilIdle(options.settle_ms, 60 * 1000);
+  double total_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+  printf("%zu records, %zu skipped, %zu waits for async results timed out, "
+         "commands done in %.1f ms, settled after %.1f ms\n",
+         records.size(), skipped, barrier_timeouts, command_ms, total_ms);
+  printf("%-24s %8s %10s %10s %10s %10s %12s %12s\n", "command", "count", "p50_us", "p90_us",
+         "p99_us", "max_us", "rec_p50_us", "rec_p99_us");
+  for (auto& [name, stats] : commands) {
+    printf("%-24s %8zu %10.1f %10.1f %10.1f %10.1f %12.1f %12.1f\n",
+           name.c_str(),
+           stats.replay_us.size(),
+           Percentile(stats.replay_us, 50),
+           Percentile(stats.replay_us, 90),
+           Percentile(stats.replay_us, 99),
+           Percentile(stats.replay_us, 100),
+           Percentile(stats.recorded_us, 50),
+           Percentile(stats.recorded_us, 99));
+  }
+
+  uint64_t recorded_total = 0;
+  uint64_t replay_total = 0;
+  size_t diverged = 0;
+  for (const auto& [key, state] : props) {
+    recorded_total += state.recorded_count;
+    replay_total += state.replay_count;
+    if (state.has_recorded_value &&
+        (!state.has_replay_value || state.recorded_hash != state.replay_hash)) {
+      ++diverged;
+      printf("diverged: instance %llu %s\n", static_cast<unsigned long long>(key.first),
+             key.second.c_str());
+    }
+  }
+  printf("property notifications: recorded %llu, replayed %llu, final values diverged %zu\n",
+         static_cast<unsigned long long>(recorded_total),
+         static_cast<unsigned long long>(replay_total), diverged);
+  return options.strict && diverged > 0 ? 2 : 0;
+}
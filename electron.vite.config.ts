@@ -12,7 +12,16 @@ export default defineConfig({
     }
   },
   preload: {
-    plugins: [externalizeDepsPlugin()]
+    plugins: [externalizeDepsPlugin()],
+    build: {
+      rollupOptions: {
+        input: {
+          index: resolve(__dirname, 'src/preload/index.ts'),
+          // worker模式下运行C++后端的线程入口
+          mvvm_worker: resolve(__dirname, 'src/preload/mvvm_worker.ts')
+        }
+      }
+    }
   },
   renderer: {
     resolve: {
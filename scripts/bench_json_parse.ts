@@ -0,0 +1,152 @@
+/*
+ * @Author: Nana5aki
+ * @Date: 2026-10-19 14:52:37
+ * @LastEditors: Nana5aki
+ * @LastEditTime: 2026-10-19 14:52:37
+ * @FilePath: \life_view\scripts\bench_json_parse.ts
+ */
+
+// JSON.parse + NValueToVariant与原生JSON解析的对比。
+//
+//   npm run bench:json -- [--todos=N] [--repeat=N] [--keep]
+//
+// 需要Node 22.6+和已编译的backend。对同一个todo数组文档测量：
+//   JSON.parse：读文件并解析为JS对象
+//   convert：把解析结果作为命令参数传给原生模块，只包含NValueToVariant（命令名不存在，不执行）
+//   ImportTodos：原生导入同一文件，包含解析和写入Model，不创建JS对象
+// 纯原生解析(不含Model)用backend的json_parse_bench测量，--keep保留文档后用--file=解析同一个文件
+import { mkdtempSync, readFileSync, rmSync, statSync, writeFileSync } from 'node:fs'
+import { tmpdir } from 'node:os'
+import { join } from 'node:path'
+
+interface Options {
+  todos: number
+  repeat: number
+  keep: boolean
+}
+
+interface NativeViewModel {
+  BindProperty(prop_name: string, callback: (change_info: { value: unknown }) => void): void
+  ExcuteCommand(command_name: string, param?: unknown): void
+}
+
+const STATUSES = ['todo', 'doing', 'done', 'cancelled']
+
+function ParseOptions(): Options {
+  const options: Options = { todos: 100000, repeat: 5, keep: false }
+  for (const arg of process.argv.slice(2)) {
+    const [key, value] = arg.replace(/^--/, '').split('=')
+    if (key === 'todos' || key === 'repeat') {
+      options[key] = Number(value)
+    } else if (key === 'keep') {
+      options.keep = true
+    }
+  }
+  return options
+}
+
+// 与backend/tools/bench/bench_todos.h的MakeTodo内容相同
+function WriteTodoJson(dir: string, count: number): string {
+  const epoch = Date.UTC(2026, 0, 1)
+  const todos: unknown[] = []
+  for (let i = 0; i < count; ++i) {
+    todos.push({
+      id: `todo-${i}`,
+      title: `Task number ${i}`,
+      notes: i % 3 === 0 ? 'call back, then "confirm"' : '',
+      status: STATUSES[i % 4],
+      priority: i % 5,
+      due: epoch + (i % 1000) * 3600000,
+      tags: i % 2 === 0 ? ['work', 'home'] : ['work']
+    })
+  }
+  const path = join(dir, 'todos.json')
+  writeFileSync(path, JSON.stringify(todos))
+  return path
+}
+
+// 跑repeat次取最快的一次，毫秒
+async function BestOf(repeat: number, run: () => unknown): Promise<number> {
+  let best = Infinity
+  for (let i = 0; i < Math.max(1, repeat); ++i) {
+    const start = performance.now()
+    await run()
+    best = Math.min(best, performance.now() - start)
+  }
+  return best
+}
+
+// 每次导入完成时结束对应的等待
+class Importer {
+  private target: NativeViewModel
+  private pending: { resolve: () => void; reject: (error: Error) => void } | null = null
+
+  constructor(target: NativeViewModel) {
+    this.target = target
+    target.BindProperty('transfer_progress', ({ value }) => {
+      const progress = value as { state?: string; error?: string } | null
+      const pending = this.pending
+      if (!pending || progress?.state === 'running') {
+        return
+      }
+      this.pending = null
+      if (progress?.state === 'done') {
+        pending.resolve()
+      } else {
+        pending.reject(new Error(`import failed: ${progress?.error}`))
+      }
+    })
+  }
+
+  Import(path: string): Promise<void> {
+    return new Promise<void>((resolve, reject) => {
+      this.pending = { resolve, reject }
+      this.target.ExcuteCommand('ImportTodos', { path, format: 'json', replace: true })
+    })
+  }
+}
+
+async function Main(): Promise<void> {
+  const options = ParseOptions()
+  const dir = mkdtempSync(join(tmpdir(), 'life_view_bench_'))
+  const path = WriteTodoJson(dir, options.todos)
+  const megabytes = statSync(path).size / (1024 * 1024)
+
+  // 与preload的进程内模式相同的加载方式，路径相对src/preload
+  const RequireFunc = eval('require')
+  const native = RequireFunc('../../backend/build/Release/life_view_backend.node')
+  const viewmodel: NativeViewModel = native.createViewModel('todo_view_model')
+
+  let parsed: unknown = null
+  const parse_ms = await BestOf(options.repeat, () => {
+    parsed = JSON.parse(readFileSync(path, 'utf8'))
+  })
+  const convert_ms = await BestOf(options.repeat, () => {
+    viewmodel.ExcuteCommand('BenchConvertOnly', parsed)
+  })
+  const importer = new Importer(viewmodel)
+  const import_ms = await BestOf(options.repeat, () => importer.Import(path))
+
+  const Row = (name: string, ms: number): string =>
+    `${name.padEnd(24)} ${ms.toFixed(2).padStart(10)} ${((megabytes / ms) * 1000)
+      .toFixed(1)
+      .padStart(10)}`
+  console.log(`${options.todos} todos, ${megabytes.toFixed(1)} MB, best of ${options.repeat}`)
+  console.log(`${'stage'.padEnd(24)} ${'ms'.padStart(10)} ${'MB/s'.padStart(10)}`)
+  console.log(Row('JSON.parse', parse_ms))
+  console.log(Row('convert', convert_ms))
+  console.log(Row('JSON.parse + convert', parse_ms + convert_ms))
+  console.log(Row('ImportTodos (native)', import_ms))
+
+  if (options.keep) {
+    console.log(`document kept at ${path}`)
+  } else {
+    rmSync(dir, { recursive: true, force: true })
+  }
+  process.exit(0)
+}
+
+Main().catch((error) => {
+  console.error(error)
+  process.exit(1)
+})
@@ -0,0 +1,196 @@
+/*
+ * @Author: Nana5aki
+ * @Date: 2026-10-19 11:05:20
+ * @LastEditors: Nana5aki
+ * @LastEditTime: 2026-10-19 11:05:20
+ * @FilePath: \life_view\scripts\bench_mvvm_transport.ts
+ */
+
+// worker传输(SharedArrayBuffer环 + worker线程)与进程内直接调用的延迟和吞吐对比。
+//
+//   npm run bench:transport -- [--todos=N] [--iterations=N]
+//
+// 需要Node 22.6+和已编译的backend。两条路径使用同一个原生模块和同一份数据：
+// 导入N条todo后反复执行FilterTodos，每次换一个offset，保证filtered_todos都会变化并通知。
+//   延迟：发出命令到收到filtered_todos通知的时间，逐条等待
+//   吞吐：连续发出所有命令，到最后一条通知到达为止
+// 进程内路径在命令中同步完成，包含C++执行和Variant转JS对象；
+// worker路径另外包含编码、环形缓冲区和解码，但执行不占用调用方线程
+import { mkdtempSync, rmSync, writeFileSync } from 'node:fs'
+import { tmpdir } from 'node:os'
+import { join } from 'node:path'
+import { WorkerTransport } from '../src/preload/mvvm_worker_client'
+import type { ViewModelProxy } from '../src/preload/mvvm_client'
+
+interface Options {
+  todos: number
+  iterations: number
+}
+
+interface Sample {
+  latency_us: number[]
+  per_second: number
+}
+
+// 单次结果中的todo条数
+const PAYLOADS = [
+  { name: '1 todo', limit: 1 },
+  { name: '100 todos', limit: 100 },
+  { name: '1000 todos', limit: 1000 }
+]
+
+type PropCallback = (change_info: { prop_name: string; value: unknown }) => void
+
+// 进程内原生ViewModel与ViewModelProxy共用的部分
+interface BenchTarget {
+  BindProperty(prop_name: string, callback: PropCallback): void
+  ExcuteCommand(command_name: string, param?: unknown): void
+}
+
+function ParseOptions(): Options {
+  const options: Options = { todos: 20000, iterations: 2000 }
+  for (const arg of process.argv.slice(2)) {
+    const [key, value] = arg.replace(/^--/, '').split('=')
+    if (key === 'todos' || key === 'iterations') {
+      options[key] = Number(value)
+    }
+  }
+  return options
+}
+
+function WriteTodoCsv(dir: string, count: number): string {
+  const lines = ['id,title,notes,status,priority,due,tags']
+  const day = 24 * 3600 * 1000
+  for (let i = 0; i < count; ++i) {
+    const due = new Date(Date.UTC(2026, 0, 1) + (i % 365) * day).toISOString()
+    lines.push(`todo-${i},Task number ${i},some notes here,todo,${i % 4},${due},work;home`)
+  }
+  const path = join(dir, 'todos.csv')
+  writeFileSync(path, lines.join('\n') + '\n')
+  return path
+}
+
+function Percentile(values: number[], percent: number): number {
+  const sorted = [...values].sort((a, b) => a - b)
+  return sorted[Math.min(sorted.length - 1, Math.floor((percent / 100) * sorted.length))]
+}
+
+// 每个属性通知唤醒一次等待者
+class Notifications {
+  count = 0
+  private waiter: { target: number; resolve: () => void } | null = null
+
+  constructor(target: BenchTarget, prop_name: string) {
+    target.BindProperty(prop_name, () => {
+      ++this.count
+      if (this.waiter && this.count >= this.waiter.target) {
+        const resolve = this.waiter.resolve
+        this.waiter = null
+        resolve()
+      }
+    })
+  }
+
+  WaitFor(target: number): Promise<void> {
+    if (this.count >= target) {
+      return Promise.resolve()
+    }
+    return new Promise((resolve) => {
+      this.waiter = { target, resolve }
+    })
+  }
+}
+
+async function Import(target: BenchTarget, path: string): Promise<void> {
+  await new Promise<void>((resolve, reject) => {
+    target.BindProperty('transfer_progress', ({ value }) => {
+      const progress = value as { state?: string; error?: string } | null
+      if (progress?.state === 'done') {
+        resolve()
+      } else if (progress?.state === 'failed' || progress?.state === 'rejected') {
+        reject(new Error(`import failed: ${progress.error}`))
+      }
+    })
+    target.ExcuteCommand('ImportTodos', { path, format: 'csv', replace: true })
+  })
+}
+
+async function Measure(
+  target: BenchTarget,
+  notifications: Notifications,
+  limit: number,
+  options: Options
+): Promise<Sample> {
+  const span = Math.max(1, options.todos - limit)
+  let offset = 0
+  const Next = (): unknown => ({ offset: (offset = (offset + 1) % span), limit })
+
+  const latency_us: number[] = []
+  for (let i = 0; i < options.iterations; ++i) {
+    const expected = notifications.count + 1
+    const start = performance.now()
+    target.ExcuteCommand('FilterTodos', Next())
+    await notifications.WaitFor(expected)
+    latency_us.push((performance.now() - start) * 1000)
+  }
+
+  const expected = notifications.count + options.iterations
+  const start = performance.now()
+  for (let i = 0; i < options.iterations; ++i) {
+    target.ExcuteCommand('FilterTodos', Next())
+  }
+  await notifications.WaitFor(expected)
+  const seconds = (performance.now() - start) / 1000
+  return { latency_us, per_second: options.iterations / seconds }
+}
+
+function FormatSample(sample: Sample): string {
+  const p50 = Percentile(sample.latency_us, 50).toFixed(1)
+  const p99 = Percentile(sample.latency_us, 99).toFixed(1)
+  return `${p50.padStart(10)} ${p99.padStart(10)} ${sample.per_second.toFixed(0).padStart(10)}`
+}
+
+async function Main(): Promise<void> {
+  const options = ParseOptions()
+  const dir = mkdtempSync(join(tmpdir(), 'life_view_bench_'))
+  const csv_path = WriteTodoCsv(dir, options.todos)
+
+  // 与preload的进程内模式相同的加载方式，路径相对src/preload
+  const RequireFunc = eval('require')
+  const native = RequireFunc('../../backend/build/Release/life_view_backend.node')
+  const direct: BenchTarget = native.createViewModel('todo_view_model')
+  const transport = new WorkerTransport(
+    new URL('../src/preload/mvvm_worker.ts', import.meta.url).pathname
+  )
+  const remote: ViewModelProxy = transport.CreateViewModel('todo_view_model')
+
+  await Import(direct, csv_path)
+  await Import(remote, csv_path)
+  const direct_notifications = new Notifications(direct, 'filtered_todos')
+  const remote_notifications = new Notifications(remote, 'filtered_todos')
+
+  console.log(
+    `${options.todos} todos, ${options.iterations} FilterTodos per payload; ` +
+      'latency in us, throughput in commands/s'
+  )
+  console.log(
+    `${'payload'.padEnd(12)} ${'direct p50'.padStart(10)} ${'p99'.padStart(10)} ` +
+      `${'per_s'.padStart(10)} ${'worker p50'.padStart(10)} ${'p99'.padStart(10)} ` +
+      `${'per_s'.padStart(10)}`
+  )
+  for (const payload of PAYLOADS) {
+    const direct_sample = await Measure(direct, direct_notifications, payload.limit, options)
+    const remote_sample = await Measure(remote, remote_notifications, payload.limit, options)
+    console.log(
+      `${payload.name.padEnd(12)} ${FormatSample(direct_sample)} ${FormatSample(remote_sample)}`
+    )
+  }
+
+  rmSync(dir, { recursive: true, force: true })
+  process.exit(0)
+}
+
+Main().catch((error) => {
+  console.error(error)
+  process.exit(1)
+})
@@ -0,0 +1,26 @@
+/*
+ * @Author: Nana5aki
+ * @Date: 2026-10-19 11:05:20
+ * @LastEditors: Nana5aki
+ * @LastEditTime: 2026-10-19 11:05:20
+ * @FilePath: \life_view\scripts\ts_register.mjs
+ */
+
+// 用Node直接运行src下的TS源码(不经过electron-vite打包)时的预加载脚本：
+//   node --experimental-strip-types --import ./scripts/ts_register.mjs <script.ts>
+// worker线程继承execArgv，同样会加载这里
+import { createRequire, register } from 'node:module'
+import { resolve } from 'node:path'
+
+// 源码中的相对导入不带扩展名
+register('./ts_resolve.mjs', import.meta.url)
+
+// 打包后的preload是CommonJS，源码用eval('require')加载原生模块。
+// 基准路径取src/preload，'../../backend/build/Release/...'与打包后的位置一致。
+// LIFE_VIEW_BENCH_NATIVE可以换成其他实现了相同接口的模块(相对当前目录)
+const preload_require = createRequire(new URL('../src/preload/index.ts', import.meta.url))
+const native_override = process.env['LIFE_VIEW_BENCH_NATIVE']
+globalThis.require ??= (id) =>
+  native_override && id.endsWith('life_view_backend.node')
+    ? preload_require(resolve(native_override))
+    : preload_require(id)
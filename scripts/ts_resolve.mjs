@@ -0,0 +1,19 @@
+/*
+ * @Author: Nana5aki
+ * @Date: 2026-10-19 11:05:20
+ * @LastEditors: Nana5aki
+ * @LastEditTime: 2026-10-19 11:05:20
+ * @FilePath: \life_view\scripts\ts_resolve.mjs
+ */
+
+// 模块解析钩子：找不到的相对导入再尝试加上.ts
+export async function resolve(specifier, context, next) {
+  try {
+    return await next(specifier, context)
+  } catch (error) {
+    if (error?.code !== 'ERR_MODULE_NOT_FOUND' || !specifier.startsWith('.')) {
+      throw error
+    }
+    return next(`${specifier}.ts`, context)
+  }
+}
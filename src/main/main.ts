@@ -9,6 +9,7 @@ import { app, BrowserWindow, shell } from 'electron'
 import { join } from 'path'
 import { electronApp, optimizer, is } from '@electron-toolkit/utils'
 import icon from '../../resources/icon.png?asset'
+import { MVVMHub } from './mvvm_hub'
 
 function createWindow(): void {
   // Create the browser window.
@@ -44,6 +45,11 @@ function createWindow(): void {
   }
 }
 
+// worker模式下preload与后端worker通过SharedArrayBuffer通信，需要在ready之前开启
+if (process.env['LIFE_VIEW_MVVM_MODE'] === 'worker') {
+  app.commandLine.appendSwitch('enable-features', 'SharedArrayBuffer')
+}
+
 // This method will be called when Electron has finished
 // initialization and is ready to create browser windows.
 // Some APIs can only be used after this event occurs.
@@ -58,6 +64,12 @@ app.whenReady().then(() => {
     optimizer.watchWindowShortcuts(window)
   })
 
+  // 共享模式下由主进程持有ViewModel，所有窗口连接到同一份状态
+  if (process.env['LIFE_VIEW_MVVM_MODE'] === 'shared') {
+    const RequireFunc = eval('require')
+    new MVVMHub(RequireFunc('../../backend/build/Release/life_view_backend.node'))
+  }
+
   createWindow()
 
   app.on('activate', function () {
@@ -0,0 +1,278 @@
+/*
+ * @Author: Nana5aki
+ * @Date: 2026-10-18 20:05:41
+ * @LastEditors: Nana5aki
+ * @LastEditTime: 2026-10-18 21:10:26
+ * @FilePath: \life_view\src\main\mvvm_hub.ts
+ */
+
+// 共享模式：主进程持有唯一一份ViewModel，多个窗口通过MessagePort连接。
+// 同类型的ViewModel在所有窗口间共享；属性变化只编码一次，按各窗口的订阅过滤后发送。
+// 窗口用Ack确认已处理的事件数，未确认数超过上限的窗口进入积压状态，
+// 期间只记录哪些属性变了，恢复后每个属性只补发最新值。
+import { ipcMain, MessageChannelMain } from 'electron'
+import type { MessagePortMain } from 'electron'
+import {
+  ApplyMemoryBudget,
+  EventOp,
+  ExecuteBatch,
+  MVVM_CONNECT_CHANNEL,
+  MVVM_PORT_CHANNEL,
+  RequestOp
+} from '../preload/mvvm_protocol'
+import { BinaryReader, BinaryWriter } from '../preload/variant_codec'
+
+interface NativeViewModel {
+  GetPropStats(): Record<string, { sets: number; skips: number }>
+  GetPropsEncodedAsync(callback: (props: Uint8Array) => void): void
+  BindAnyPropertyEncoded(callback: (prop_name: string, value: Uint8Array) => void): void
+  ExcuteCommandEncoded(command_name: string, param?: Uint8Array): boolean
+}
+
+interface SharedViewModel {
+  channel: number
+  native: NativeViewModel
+  // 每个属性最近一次变化编码后的事件，积压补发和新订阅时直接复用
+  last_events: Map<string, Uint8Array>
+  peers: Set<Peer>
+}
+
+interface Peer {
+  port: MessagePortMain
+  // 窗口的请求id -> 共享ViewModel
+  instances: Map<number, SharedViewModel>
+  subscriptions: Map<SharedViewModel, Set<string>>
+  unacked: number
+  throttled: boolean
+  // 积压期间变化过的属性
+  dirty: Map<SharedViewModel, Set<string>>
+}
+
+// 未确认事件数达到HIGH_WATER后暂停推送，回落到LOW_WATER后补发
+const HIGH_WATER = 1024
+const LOW_WATER = 256
+
+interface NativeModule {
+  createViewModel(type: string): NativeViewModel
+  setMemoryBudget(bytes: number): void
+}
+
+export class MVVMHub {
+  private native: NativeModule
+  private shared = new Map<string, SharedViewModel>()
+  private next_channel = 1
+  private writer = new BinaryWriter()
+
+  constructor(native: NativeModule) {
+    this.native = native
+    ApplyMemoryBudget(native)
+    ipcMain.on(MVVM_CONNECT_CHANNEL, (event) => {
+      const { port1, port2 } = new MessageChannelMain()
+      this.AddPeer(port1)
+      event.sender.postMessage(MVVM_PORT_CHANNEL, null, [port2])
+    })
+  }
+
+  private AddPeer(port: MessagePortMain): void {
+    const peer: Peer = {
+      port,
+      instances: new Map(),
+      subscriptions: new Map(),
+      unacked: 0,
+      throttled: false,
+      dirty: new Map()
+    }
+    port.on('message', (message) => {
+      try {
+        this.HandleRequest(peer, message.data)
+      } catch (error) {
+        console.error('MVVM hub: bad request', error)
+      }
+    })
+    // 窗口关闭或刷新时端口关闭，共享的ViewModel保留
+    port.on('close', () => {
+      for (const shared of peer.instances.values()) {
+        shared.peers.delete(peer)
+      }
+      peer.instances.clear()
+      peer.subscriptions.clear()
+      peer.dirty.clear()
+    })
+    port.start()
+  }
+
+  private HandleRequest(peer: Peer, data: Uint8Array): void {
+    const reader = new BinaryReader(data)
+    const op = reader.ReadU8()
+    const id = reader.ReadVarint()
+
+    if (op === RequestOp.Ack) {
+      this.OnAck(peer, reader.ReadVarint())
+      return
+    }
+    if (op === RequestOp.Create) {
+      this.Attach(peer, id, reader.ReadString())
+      return
+    }
+
+    const shared = peer.instances.get(id)
+    if (!shared) {
+      this.PostError(peer, id, 'ViewModel not initialized')
+      return
+    }
+
+    switch (op) {
+      case RequestOp.Command: {
+        const command_name = reader.ReadString()
+        const has_param = reader.ReadU8() !== 0
+        const param = has_param ? reader.ReadBytes(reader.Remaining()) : undefined
+        try {
+          shared.native.ExcuteCommandEncoded(command_name, param)
+        } catch (error) {
+          this.PostError(peer, id, `execute command ${command_name} failed: ${error}`)
+        }
+        break
+      }
+      case RequestOp.Batch:
+        ExecuteBatch(reader, shared.native, (message) => this.PostError(peer, id, message))
+        break
+      case RequestOp.Subscribe: {
+        const prop_name = reader.ReadString()
+        const props = peer.subscriptions.get(shared)!
+        if (props.has(prop_name)) {
+          break
+        }
+        props.add(prop_name)
+        // 快照之后、订阅之前的变化没有推送给这个窗口，补发最新值
+        const last_event = shared.last_events.get(prop_name)
+        if (last_event) {
+          this.Deliver(peer, shared, prop_name, last_event)
+        }
+        break
+      }
+      case RequestOp.GetStats:
+        this.writer.Reset()
+        this.writer.WriteU8(EventOp.Stats)
+        this.writer.WriteVarint(id)
+        this.writer.WriteValue(shared.native.GetPropStats())
+        this.Post(peer, this.writer.Bytes().slice())
+        break
+      default:
+        this.PostError(peer, id, `unknown request ${op}`)
+    }
+  }
+
+  private Attach(peer: Peer, id: number, type: string): void {
+    let shared = this.shared.get(type)
+    if (!shared) {
+      let native: NativeViewModel
+      try {
+        native = this.native.createViewModel(type)
+      } catch (error) {
+        this.PostError(peer, id, `create ${type} failed: ${error}`)
+        return
+      }
+      const created: SharedViewModel = {
+        channel: this.next_channel++,
+        native,
+        last_events: new Map(),
+        peers: new Set()
+      }
+      native.BindAnyPropertyEncoded((prop_name, value) => {
+        this.Broadcast(created, prop_name, value)
+      })
+      this.shared.set(type, created)
+      shared = created
+    }
+
+    peer.instances.set(id, shared)
+    shared.peers.add(peer)
+    if (!peer.subscriptions.has(shared)) {
+      peer.subscriptions.set(shared, new Set())
+    }
+
+    // 主进程为所有窗口服务，快照在C++线程池中编码，不阻塞其他窗口的请求和推送
+    const attached = shared
+    attached.native.GetPropsEncodedAsync((props) => {
+      if (!attached.peers.has(peer)) {
+        return
+      }
+      this.writer.Reset()
+      this.writer.WriteU8(EventOp.Snapshot)
+      this.writer.WriteVarint(id)
+      this.writer.WriteVarint(attached.channel)
+      this.writer.WriteBytes(props)
+      this.Post(peer, this.writer.Bytes().slice())
+      // 编码期间的变化可能已先于快照送出(窗口会丢弃或只更新已有镜像)，
+      // 快照可能比它们旧，对已订阅的属性补发最新值
+      for (const prop_name of peer.subscriptions.get(attached) ?? []) {
+        const last_event = attached.last_events.get(prop_name)
+        if (last_event) {
+          this.Deliver(peer, attached, prop_name, last_event)
+        }
+      }
+    })
+  }
+
+  private Broadcast(shared: SharedViewModel, prop_name: string, value: Uint8Array): void {
+    // 只编码一次，所有窗口发送同一份字节
+    this.writer.Reset()
+    this.writer.WriteU8(EventOp.PropChanged)
+    this.writer.WriteVarint(shared.channel)
+    this.writer.WriteString(prop_name)
+    this.writer.WriteBytes(value)
+    const event = this.writer.Bytes().slice()
+    shared.last_events.set(prop_name, event)
+
+    for (const peer of shared.peers) {
+      if (peer.subscriptions.get(shared)?.has(prop_name)) {
+        this.Deliver(peer, shared, prop_name, event)
+      }
+    }
+  }
+
+  private Deliver(peer: Peer, shared: SharedViewModel, prop_name: string, event: Uint8Array): void {
+    if (peer.throttled) {
+      let props = peer.dirty.get(shared)
+      if (!props) {
+        props = new Set()
+        peer.dirty.set(shared, props)
+      }
+      props.add(prop_name)
+      return
+    }
+    this.Post(peer, event)
+    if (peer.unacked >= HIGH_WATER) {
+      peer.throttled = true
+    }
+  }
+
+  private OnAck(peer: Peer, count: number): void {
+    peer.unacked = Math.max(0, peer.unacked - count)
+    if (!peer.throttled || peer.unacked > LOW_WATER) {
+      return
+    }
+    peer.throttled = false
+    const dirty = peer.dirty
+    peer.dirty = new Map()
+    for (const [shared, props] of dirty) {
+      for (const prop_name of props) {
+        // 再次积压时剩余的属性重新记入dirty
+        this.Deliver(peer, shared, prop_name, shared.last_events.get(prop_name)!)
+      }
+    }
+  }
+
+  private PostError(peer: Peer, id: number, message: string): void {
+    this.writer.Reset()
+    this.writer.WriteU8(EventOp.Error)
+    this.writer.WriteVarint(id)
+    this.writer.WriteString(message)
+    this.Post(peer, this.writer.Bytes().slice())
+  }
+
+  private Post(peer: Peer, event: Uint8Array): void {
+    peer.port.postMessage(event)
+    ++peer.unacked
+  }
+}
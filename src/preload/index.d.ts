@@ -2,24 +2,71 @@
  * @Author: Nana5aki
  * @Date: 2025-05-30 21:21:48
  * @LastEditors: Nana5aki
- * @LastEditTime: 2025-06-15 17:45:20
+ * @LastEditTime: 2026-10-18 21:10:26
  * @FilePath: \life_view\src\preload\index.d.ts
  */
 import { ElectronAPI } from '@electron-toolkit/preload'
 
+interface CommandCall {
+  name: string
+  param?: unknown
+}
+
+interface CommandResult {
+  // 命令处理函数的返回值：参数无效或请求被拒绝时为false；导入导出等后台命令为true只表示已开始，
+  // 结果见对应属性。进程外模式下为undefined：命令已发送，结果未知
+  ok: boolean | undefined
+  // 命令未注册、名称无效、执行失败，或stop_on_error时前面的命令失败后为"skipped"
+  error?: string
+}
+
 // ViewModel实例接口
 interface ViewModelInstance {
+  // 开启contextIsolation时返回值经contextBridge传入，每次调用都是新的拷贝，
+  // 不能按引用判断是否变化；界面应通过useMVVM读取，由它按属性复用未变化的对象
   GetProp(prop_name: string): unknown
+  // 一次取多个属性，不传时取全部；不存在的属性为null
+  GetProps(prop_names?: string[]): Record<string, unknown>
   BindProperty(
     prop_name: string,
     callback: (ChangeInfo: { prop_name: string; value: unknown }) => void
   ): void
   ExcuteCommand(command_name: string, param?: unknown): void
+  // 按顺序执行一组命令，每个命令一个结果。
+  // 进程外模式下命令异步执行，返回时结果未知，ok都为undefined；失败的命令由后端在控制台报告
+  ExcuteCommands(commands: CommandCall[], options?: { stop_on_error?: boolean }): CommandResult[]
+  GetPropStats(): Record<string, { sets: number; skips: number }>
+  // 进程外模式下没有
+  GetMemoryUsage?(): ViewModelMemoryUsage
+}
+
+// 内存统计，单位字节。spilled_bytes为换出的属性在内存中时的占用
+interface ViewModelMemoryUsage {
+  view_id: string
+  prop_count: number
+  resident_bytes: number
+  spilled_count: number
+  spilled_bytes: number
+  props: Record<string, { bytes: number; spilled: boolean }>
+}
+
+interface MemoryUsageReport {
+  // 0表示不限制
+  budget: number
+  resident_bytes: number
+  spilled_bytes: number
+  spilled_count: number
+  spill_file_bytes: number
+  view_models: ViewModelMemoryUsage[]
 }
 
 // MVVM API接口
 interface MVVMAPI {
   CreateViewModel(type: string): ViewModelInstance
+  // worker/shared模式下返回null
+  GetMemoryUsage(): MemoryUsageReport | null
+  // 超出预算时换出最久未访问、没有监听的属性(不小于1KB)，不会释放整个ViewModel
+  SetMemoryBudget(bytes: number): void
 }
 
 declare global {
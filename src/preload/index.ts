@@ -2,27 +2,73 @@
  * @Author: Nana5aki
  * @Date: 2025-05-30 21:21:48
  * @LastEditors: Nana5aki
- * @LastEditTime: 2025-06-15 17:45:35
+ * @LastEditTime: 2026-10-18 21:10:26
  * @FilePath: \life_view\src\preload\index.ts
  */
 import { contextBridge } from 'electron'
 import { electronAPI } from '@electron-toolkit/preload'
+import { join } from 'path'
+import { MVVMClient } from './mvvm_client'
+import { PortTransport } from './mvvm_port_client'
+import { ApplyMemoryBudget } from './mvvm_protocol'
+import { WorkerTransport } from './mvvm_worker_client'
+
+// LIFE_VIEW_MVVM_MODE:
+//   worker  C++后端运行在worker线程中，通过SharedArrayBuffer环形缓冲区通信
+//   shared  ViewModel由主进程持有，所有窗口共享，通过MessagePort通信
+//   默认直接在渲染进程中加载
+const mvvm_mode = process.env['LIFE_VIEW_MVVM_MODE']
+let use_worker = mvvm_mode === 'worker'
 
 // 动态加载C++模块
 const RequireFunc = eval('require')
-const MVVMNative = RequireFunc('../../backend/build/Release/life_view_backend.node')
+let MVVMNative: typeof RequireFunc = null
+let remote_transport: MVVMClient | null = null
+
+// worker/shared模式下模块不在渲染进程中加载，这里延迟到第一次进程内创建时
+function LoadNative(): typeof RequireFunc {
+  if (!MVVMNative) {
+    MVVMNative = RequireFunc('../../backend/build/Release/life_view_backend.node')
+    ApplyMemoryBudget(MVVMNative)
+  }
+  return MVVMNative
+}
+
+function GetRemoteTransport(): MVVMClient | null {
+  if (!remote_transport && mvvm_mode === 'shared') {
+    remote_transport = new PortTransport()
+  }
+  if (!remote_transport && use_worker) {
+    try {
+      remote_transport = new WorkerTransport(join(__dirname, 'mvvm_worker.js'))
+    } catch (error) {
+      // 例如没有开启SharedArrayBuffer，退回到进程内调用
+      console.warn('MVVM worker unavailable, fallback to in-thread backend', error)
+      use_worker = false
+    }
+  }
+  return remote_transport
+}
 
 // Custom APIs for renderer - 创建ViewModel包装器
 const api = {
   mvvm: {
     CreateViewModel: (type: string) => {
       try {
-        const native_instance = MVVMNative.createViewModel(type)
+        const transport = GetRemoteTransport()
+        if (transport) {
+          return transport.CreateViewModel(type)
+        }
+
+        const native_instance = LoadNative().createViewModel(type)
         // 创建一个包装器对象，显式暴露方法
         const wrapper = {
           GetProp: (propName: string) => {
             return native_instance.GetProp(propName)
           },
+          GetProps: (prop_names?: string[]) => {
+            return native_instance.GetProps(prop_names)
+          },
           BindProperty: (
             prop_name: string,
             callback: (ChangeInfo: { prop_name: string; value: unknown }) => void
@@ -35,6 +81,18 @@ const api = {
             } else {
               return native_instance.ExcuteCommand(command_name)
             }
+          },
+          ExcuteCommands: (
+            commands: { name: string; param?: unknown }[],
+            options?: { stop_on_error?: boolean }
+          ) => {
+            return native_instance.ExcuteCommands(commands, options)
+          },
+          GetPropStats: () => {
+            return native_instance.GetPropStats()
+          },
+          GetMemoryUsage: () => {
+            return native_instance.GetMemoryUsage()
           }
         }
         return wrapper
@@ -42,6 +100,18 @@ const api = {
         console.error('ViewModel Create Failed', error)
         throw error
       }
+    },
+    // 内存统计和预算只对本进程加载的后端有效，worker/shared模式下通过
+    // LIFE_VIEW_MVVM_MEMORY_BUDGET在后端所在的线程/进程设置
+    GetMemoryUsage: () => {
+      return GetRemoteTransport() ? null : LoadNative().getMemoryUsage()
+    },
+    SetMemoryBudget: (bytes: number) => {
+      if (GetRemoteTransport()) {
+        console.warn('MVVM memory budget is set by the backend process in worker/shared mode')
+        return
+      }
+      LoadNative().setMemoryBudget(bytes)
     }
   }
 }
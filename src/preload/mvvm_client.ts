@@ -0,0 +1,212 @@
+/*
+ * @Author: Nana5aki
+ * @Date: 2026-10-18 20:05:41
+ * @LastEditors: Nana5aki
+ * @LastEditTime: 2026-10-18 20:05:41
+ * @FilePath: \life_view\src\preload\mvvm_client.ts
+ */
+
+// 进程外后端在preload一侧的代理：提供与原生ViewModel相同的接口。
+// 属性在本地保留一份镜像，GetProp保持同步；命令发出后立即返回。
+// 具体的传输方式(worker环形缓冲区/主进程MessagePort)由子类实现Send
+import { EventOp, RequestOp } from './mvvm_protocol'
+import { BinaryReader, BinaryWriter } from './variant_codec'
+
+type PropChangeCallback = (ChangeInfo: { prop_name: string; value: unknown }) => void
+type PropStats = Record<string, { sets: number; skips: number }>
+
+export interface CommandCall {
+  name: string
+  param?: unknown
+}
+
+export interface CommandResult {
+  // undefined表示已发送、结果未知
+  ok: boolean | undefined
+  error?: string
+}
+
+export interface ViewModelProxy {
+  GetProp(prop_name: string): unknown
+  GetProps(prop_names?: string[]): Record<string, unknown>
+  BindProperty(prop_name: string, callback: PropChangeCallback): void
+  ExcuteCommand(command_name: string, param?: unknown): void
+  ExcuteCommands(commands: CommandCall[], options?: { stop_on_error?: boolean }): CommandResult[]
+  GetPropStats(): PropStats
+}
+
+interface ViewModelMirror {
+  props: Map<string, unknown>
+  callbacks: Map<string, PropChangeCallback[]>
+  // 已向后端订阅的属性
+  subscribed: Set<string>
+  stats: PropStats
+}
+
+export abstract class MVVMClient {
+  protected writer = new BinaryWriter()
+  // 批量命令的参数先单独编码以得到长度
+  private param_writer = new BinaryWriter()
+  private next_id = 1
+  private mirrors = new Map<number, ViewModelMirror>()
+  // 后端channel -> 镜像，同一窗口多次创建同类型ViewModel时共享模式下会对应同一个channel
+  private channels = new Map<number, ViewModelMirror[]>()
+
+  CreateViewModel(type: string): ViewModelProxy {
+    const id = this.next_id++
+    const mirror: ViewModelMirror = {
+      props: new Map(),
+      callbacks: new Map(),
+      subscribed: new Set(),
+      stats: {}
+    }
+    this.mirrors.set(id, mirror)
+
+    this.BeginRequest(RequestOp.Create, id)
+    this.writer.WriteString(type)
+    this.Send()
+
+    return {
+      // 快照到达之前返回null，与原生接口读取不存在的属性一致
+      GetProp: (prop_name: string) => {
+        this.Subscribe(id, mirror, prop_name)
+        return mirror.props.has(prop_name) ? mirror.props.get(prop_name) : null
+      },
+      GetProps: (prop_names?: string[]) => {
+        const result: Record<string, unknown> = {}
+        for (const prop_name of prop_names ?? Array.from(mirror.props.keys())) {
+          this.Subscribe(id, mirror, prop_name)
+          result[prop_name] = mirror.props.has(prop_name) ? mirror.props.get(prop_name) : null
+        }
+        return result
+      },
+      BindProperty: (prop_name: string, callback: PropChangeCallback) => {
+        this.Subscribe(id, mirror, prop_name)
+        const callbacks = mirror.callbacks.get(prop_name)
+        if (callbacks) {
+          callbacks.push(callback)
+        } else {
+          mirror.callbacks.set(prop_name, [callback])
+        }
+      },
+      ExcuteCommand: (command_name: string, param?: unknown) => {
+        this.BeginRequest(RequestOp.Command, id)
+        this.writer.WriteString(command_name)
+        if (param !== undefined) {
+          this.writer.WriteU8(1)
+          this.writer.WriteValue(param)
+        } else {
+          this.writer.WriteU8(0)
+        }
+        this.Send()
+      },
+      // 整批作为一条消息发送。命令在后端异步执行，这里不知道结果，ok都为undefined；
+      // 失败的命令由后端以Error事件报告
+      ExcuteCommands: (commands: CommandCall[], options?: { stop_on_error?: boolean }) => {
+        this.BeginRequest(RequestOp.Batch, id)
+        this.writer.WriteU8(options?.stop_on_error ? 1 : 0)
+        this.writer.WriteVarint(commands.length)
+        for (const command of commands) {
+          this.writer.WriteString(command.name)
+          if (command.param !== undefined) {
+            this.param_writer.Reset()
+            this.param_writer.WriteValue(command.param)
+            const param = this.param_writer.Bytes()
+            this.writer.WriteVarint(param.length)
+            this.writer.WriteBytes(param)
+          } else {
+            this.writer.WriteVarint(0)
+          }
+        }
+        this.Send()
+        return commands.map(() => ({ ok: undefined }))
+      },
+      // 返回最近一次收到的统计并请求刷新
+      GetPropStats: () => {
+        this.BeginRequest(RequestOp.GetStats, id)
+        this.Send()
+        return mirror.stats
+      }
+    }
+  }
+
+  // 发送writer中当前的消息
+  protected abstract Send(): void
+
+  protected BeginRequest(op: number, id: number): void {
+    this.writer.Reset()
+    this.writer.WriteU8(op)
+    this.writer.WriteVarint(id)
+  }
+
+  protected HandleEvent(bytes: Uint8Array): void {
+    const reader = new BinaryReader(bytes)
+    const op = reader.ReadU8()
+    const id = reader.ReadVarint()
+
+    switch (op) {
+      case EventOp.Snapshot: {
+        const mirror = this.mirrors.get(id)
+        if (!mirror) {
+          return
+        }
+        const channel = reader.ReadVarint()
+        const mirrors = this.channels.get(channel)
+        if (mirrors) {
+          mirrors.push(mirror)
+        } else {
+          this.channels.set(channel, [mirror])
+        }
+        // 快照到达前绑定的回调在这里收到初始值
+        const props = reader.ReadValue() as Record<string, unknown>
+        for (const prop_name of Object.keys(props)) {
+          this.UpdateProp(mirror, prop_name, props[prop_name])
+        }
+        break
+      }
+      case EventOp.PropChanged: {
+        const mirrors = this.channels.get(id)
+        if (!mirrors) {
+          return
+        }
+        const prop_name = reader.ReadString()
+        const value = reader.ReadValue()
+        for (const mirror of mirrors) {
+          this.UpdateProp(mirror, prop_name, value)
+        }
+        break
+      }
+      case EventOp.Stats: {
+        const mirror = this.mirrors.get(id)
+        if (mirror) {
+          mirror.stats = reader.ReadValue() as PropStats
+        }
+        break
+      }
+      case EventOp.Error:
+        console.error('ViewModel backend error:', reader.ReadString())
+        break
+    }
+  }
+
+  // 第一次读取或绑定属性时订阅，之后该属性的变化才会推送过来
+  private Subscribe(id: number, mirror: ViewModelMirror, prop_name: string): void {
+    if (mirror.subscribed.has(prop_name)) {
+      return
+    }
+    mirror.subscribed.add(prop_name)
+    this.BeginRequest(RequestOp.Subscribe, id)
+    this.writer.WriteString(prop_name)
+    this.Send()
+  }
+
+  private UpdateProp(mirror: ViewModelMirror, prop_name: string, value: unknown): void {
+    mirror.props.set(prop_name, value)
+    const callbacks = mirror.callbacks.get(prop_name)
+    if (callbacks) {
+      for (const callback of callbacks) {
+        callback({ prop_name, value })
+      }
+    }
+  }
+}
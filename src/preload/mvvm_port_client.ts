@@ -0,0 +1,71 @@
+/*
+ * @Author: Nana5aki
+ * @Date: 2026-10-18 20:05:41
+ * @LastEditors: Nana5aki
+ * @LastEditTime: 2026-10-18 20:05:41
+ * @FilePath: \life_view\src\preload\mvvm_port_client.ts
+ */
+
+// 共享模式：ViewModel由主进程持有，所有窗口通过各自的MessagePort连接到同一份状态
+import { ipcRenderer } from 'electron'
+import { MVVMClient } from './mvvm_client'
+import { ACK_BATCH, MVVM_CONNECT_CHANNEL, MVVM_PORT_CHANNEL, RequestOp } from './mvvm_protocol'
+
+export class PortTransport extends MVVMClient {
+  private port: MessagePort | null = null
+  // 端口就绪前发出的请求
+  private pending: Uint8Array[] = []
+  private unacked = 0
+  private ack_scheduled = false
+
+  constructor() {
+    super()
+    ipcRenderer.once(MVVM_PORT_CHANNEL, (event) => {
+      const port = event.ports[0]
+      port.onmessage = (message) => this.OnMessage(message.data)
+      port.start()
+      this.port = port
+      for (const payload of this.pending) {
+        port.postMessage(payload)
+      }
+      this.pending = []
+    })
+    ipcRenderer.send(MVVM_CONNECT_CHANNEL)
+  }
+
+  protected Send(): void {
+    // postMessage会拷贝，这里的slice保证发出去的不是writer的整个缓冲区
+    const payload = this.writer.Bytes().slice()
+    if (this.port) {
+      this.port.postMessage(payload)
+    } else {
+      this.pending.push(payload)
+    }
+  }
+
+  private OnMessage(data: Uint8Array | ArrayBuffer): void {
+    try {
+      this.HandleEvent(data instanceof Uint8Array ? data : new Uint8Array(data))
+    } catch (error) {
+      console.error('MVVM shared event failed', error)
+    }
+    // 批量确认；剩余不足一批的在本轮消息处理完后确认
+    if (++this.unacked >= ACK_BATCH) {
+      this.SendAck()
+    } else if (!this.ack_scheduled) {
+      this.ack_scheduled = true
+      setTimeout(() => this.SendAck(), 0)
+    }
+  }
+
+  private SendAck(): void {
+    this.ack_scheduled = false
+    if (this.unacked === 0) {
+      return
+    }
+    this.BeginRequest(RequestOp.Ack, 0)
+    this.writer.WriteVarint(this.unacked)
+    this.unacked = 0
+    this.Send()
+  }
+}
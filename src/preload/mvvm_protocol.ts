@@ -0,0 +1,102 @@
+/*
+ * @Author: Nana5aki
+ * @Date: 2026-10-18 18:45:02
+ * @LastEditors: Nana5aki
+ * @LastEditTime: 2026-10-18 21:10:26
+ * @FilePath: \life_view\src\preload\mvvm_protocol.ts
+ */
+
+// preload与进程外后端(worker线程或主进程)之间的消息格式。
+// 每条消息 = u8操作码 + varint实例id + 各操作的字段，字符串和值的编码见variant_codec.ts
+// 请求中的id由preload分配；属性变化事件中的id为后端分配的channel，由Snapshot告知
+import type { BinaryReader } from './variant_codec'
+
+// preload -> 后端
+export const RequestOp = {
+  // type: string
+  Create: 1,
+  // command_name: string, has_param: u8, [param: Variant]
+  Command: 2,
+  // 无字段，后端回复Stats
+  GetStats: 3,
+  // prop_name: string，订阅属性变化。共享模式下只推送已订阅的属性
+  Subscribe: 4,
+  // id为0，count: varint，确认已处理的事件数，用于背压
+  Ack: 5,
+  // stop_on_error: u8, count: varint, 之后每个命令为
+  // command_name: string, param_len: varint(0表示无参数), [param: Variant]
+  Batch: 6
+} as const
+
+// 后端 -> preload
+export const EventOp = {
+  // channel: varint, props: Map，创建成功后发送一次全部属性
+  Snapshot: 1,
+  // (id为channel) prop_name: string, value: Variant
+  PropChanged: 2,
+  // stats: Map，GetPropStats的结果
+  Stats: 3,
+  // message: string
+  Error: 4
+} as const
+
+export const COMMAND_RING_BYTES = 1 << 20
+export const EVENT_RING_BYTES = 8 << 20
+
+// worker启动时通过postMessage收到的初始化参数
+export interface WorkerInit {
+  command_ring: SharedArrayBuffer
+  event_ring: SharedArrayBuffer
+}
+
+// 共享模式下窗口向主进程请求MessagePort的IPC通道
+export const MVVM_CONNECT_CHANNEL = 'mvvm:connect'
+export const MVVM_PORT_CHANNEL = 'mvvm:port'
+
+// 窗口每处理这么多事件回复一次Ack
+export const ACK_BATCH = 64
+
+interface BatchTarget {
+  // 命令未注册时返回false
+  ExcuteCommandEncoded(command_name: string, param?: Uint8Array): boolean
+}
+
+// 后端执行Batch请求的其余字段，失败的命令通过on_error报告；stop_on_error时之后的命令不再执行
+export function ExecuteBatch(
+  reader: BinaryReader,
+  target: BatchTarget,
+  on_error: (message: string) => void
+): void {
+  const stop_on_error = reader.ReadU8() !== 0
+  const count = reader.ReadVarint()
+  for (let i = 0; i < count; ++i) {
+    const command_name = reader.ReadString()
+    const param_len = reader.ReadVarint()
+    // 参数视图可能指向共享内存，拷贝一份再交给C++
+    const param = param_len > 0 ? reader.ReadBytes(param_len).slice() : undefined
+    let error: string | null = null
+    try {
+      if (!target.ExcuteCommandEncoded(command_name, param)) {
+        // 未注册或处理函数返回失败，具体原因由命令自己报告
+        error = `command ${command_name} unknown or failed`
+      }
+    } catch (exception) {
+      error = `execute command ${command_name} failed: ${exception}`
+    }
+    if (error !== null) {
+      on_error(`batch command ${i}: ${error}`)
+      if (stop_on_error) {
+        return
+      }
+    }
+  }
+}
+
+// 属性常驻内存上限(字节)，超出后C++后端把冷属性换出到临时文件。
+// 在加载C++模块的地方(渲染进程/worker/主进程)设置
+export function ApplyMemoryBudget(native: { setMemoryBudget(bytes: number): void }): void {
+  const budget = Number(process.env['LIFE_VIEW_MVVM_MEMORY_BUDGET'])
+  if (budget > 0) {
+    native.setMemoryBudget(budget)
+  }
+}
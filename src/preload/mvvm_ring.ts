@@ -0,0 +1,182 @@
+/*
+ * @Author: Nana5aki
+ * @Date: 2026-10-18 18:45:02
+ * @LastEditors: Nana5aki
+ * @LastEditTime: 2026-10-18 18:45:02
+ * @FilePath: \life_view\src\preload\mvvm_ring.ts
+ */
+
+// SharedArrayBuffer上的单生产者单消费者环形缓冲区。
+//
+// 布局：16字节头 + capacity字节数据区(2的幂)
+//   head/tail为单调递增的int32字节计数(允许回绕)，位置 = 计数 & (capacity - 1)
+//   每条消息为 u32长度 + 内容，按4字节对齐；尾部放不下时写入WRAP标记并从0开始
+// 唤醒：等待方先置位waiting标志再检查计数，另一方只在标志置位时调用Atomics.notify，
+// 连续读写时不会产生多余的唤醒。
+const HEAD = 0
+const TAIL = 1
+const CONSUMER_WAITING = 2
+const PRODUCER_WAITING = 3
+const HEADER_BYTES = 16
+const WRAP_MARKER = 0xffffffff
+
+type WaitAsyncResult = { async: boolean; value: Promise<string> | string }
+type WaitAsyncFn = (
+  array: Int32Array,
+  index: number,
+  value: number,
+  timeout?: number
+) => WaitAsyncResult
+
+// lib.es2024才有Atomics.waitAsync的类型声明
+const wait_async = (Atomics as unknown as { waitAsync: WaitAsyncFn }).waitAsync
+
+function Align4(len: number): number {
+  return (len + 3) & ~3
+}
+
+export class SharedRing {
+  private header: Int32Array
+  private bytes: Uint8Array
+  private view: DataView
+  private capacity: number
+  private mask: number
+  private peeked_len = -1
+
+  // capacity会向上取整到2的幂
+  static Allocate(capacity: number): SharedArrayBuffer {
+    let size = 1024
+    while (size < capacity) {
+      size *= 2
+    }
+    return new SharedArrayBuffer(HEADER_BYTES + size)
+  }
+
+  constructor(buffer: SharedArrayBuffer) {
+    this.header = new Int32Array(buffer, 0, HEADER_BYTES / 4)
+    this.capacity = buffer.byteLength - HEADER_BYTES
+    this.mask = this.capacity - 1
+    this.bytes = new Uint8Array(buffer, HEADER_BYTES, this.capacity)
+    this.view = new DataView(buffer, HEADER_BYTES, this.capacity)
+  }
+
+  // 单条消息的最大长度
+  MaxMessageBytes(): number {
+    return this.capacity - 4
+  }
+
+  // 生产者调用，空间不足时返回false
+  TryWrite(payload: Uint8Array): boolean {
+    const frame = 4 + Align4(payload.length)
+    if (frame > this.capacity) {
+      throw new Error(`mvvm_ring: message of ${payload.length} bytes exceeds ring capacity`)
+    }
+    let head = Atomics.load(this.header, HEAD)
+    const tail = Atomics.load(this.header, TAIL)
+    let free = this.capacity - ((head - tail) | 0)
+    let pos = head & this.mask
+    const contiguous = this.capacity - pos
+    if (contiguous < frame) {
+      if (contiguous > free) {
+        return false
+      }
+      // 尾部放不下时先单独发布WRAP标记，这样环排空后任何不超过capacity的消息都能写入
+      this.view.setUint32(pos, WRAP_MARKER, true)
+      head = (head + contiguous) | 0
+      free -= contiguous
+      pos = 0
+      this.Publish(head)
+    }
+    if (frame > free) {
+      return false
+    }
+    this.view.setUint32(pos, payload.length, true)
+    this.bytes.set(payload, pos + 4)
+    this.Publish((head + frame) | 0)
+    return true
+  }
+
+  // 消费者调用，返回下一条消息的视图(指向共享内存)，Consume之前有效；没有消息时返回null
+  Peek(): Uint8Array | null {
+    let tail = Atomics.load(this.header, TAIL)
+    const head = Atomics.load(this.header, HEAD)
+    if (tail === head) {
+      return null
+    }
+    let pos = tail & this.mask
+    let len = this.view.getUint32(pos, true)
+    if (len === WRAP_MARKER) {
+      tail = (tail + this.capacity - pos) | 0
+      this.Release(tail)
+      if (tail === head) {
+        return null
+      }
+      pos = 0
+      len = this.view.getUint32(0, true)
+    }
+    this.peeked_len = len
+    return this.bytes.subarray(pos + 4, pos + 4 + len)
+  }
+
+  Consume(): void {
+    if (this.peeked_len < 0) {
+      return
+    }
+    const tail = Atomics.load(this.header, TAIL)
+    const frame = 4 + Align4(this.peeked_len)
+    this.peeked_len = -1
+    this.Release((tail + frame) | 0)
+  }
+
+  // 消费者调用，等待直到有可读消息
+  async WaitReadable(): Promise<void> {
+    await this.WaitAsync(CONSUMER_WAITING, HEAD, () => !this.IsEmpty())
+  }
+
+  // 生产者调用，等待消费者释放空间（不保证空间足够，调用方需重试TryWrite）
+  async WaitWritable(): Promise<void> {
+    await this.WaitAsync(PRODUCER_WAITING, TAIL, () => this.IsEmpty())
+  }
+
+  // 生产者调用的阻塞版本，只能在worker中使用（浏览器主线程不允许Atomics.wait）
+  WaitWritableSync(timeout_ms: number): void {
+    Atomics.store(this.header, PRODUCER_WAITING, 1)
+    const tail = Atomics.load(this.header, TAIL)
+    if (!this.IsEmpty()) {
+      Atomics.wait(this.header, TAIL, tail, timeout_ms)
+    }
+    Atomics.store(this.header, PRODUCER_WAITING, 0)
+  }
+
+  IsEmpty(): boolean {
+    return Atomics.load(this.header, HEAD) === Atomics.load(this.header, TAIL)
+  }
+
+  private Publish(head: number): void {
+    // 原子写head之前的普通写对读到新head的消费者可见
+    Atomics.store(this.header, HEAD, head)
+    if (Atomics.load(this.header, CONSUMER_WAITING) !== 0) {
+      Atomics.notify(this.header, HEAD)
+    }
+  }
+
+  private Release(tail: number): void {
+    Atomics.store(this.header, TAIL, tail)
+    if (Atomics.load(this.header, PRODUCER_WAITING) !== 0) {
+      Atomics.notify(this.header, TAIL)
+    }
+  }
+
+  private async WaitAsync(flag: number, index: number, ready: () => boolean): Promise<void> {
+    Atomics.store(this.header, flag, 1)
+    // 置位后再检查一次，避免对方在检查之前已经写完而错过唤醒
+    const observed = Atomics.load(this.header, index)
+    if (!ready()) {
+      const result = wait_async(this.header, index, observed)
+      if (result.async) {
+        await result.value
+      }
+    }
+    Atomics.store(this.header, flag, 0)
+  }
+}
@@ -0,0 +1,156 @@
+/*
+ * @Author: Nana5aki
+ * @Date: 2026-10-18 19:02:36
+ * @LastEditors: Nana5aki
+ * @LastEditTime: 2026-10-18 21:10:26
+ * @FilePath: \life_view\src\preload\mvvm_worker.ts
+ */
+
+// worker模式下后端所在的线程：从命令环读取请求调用C++ ViewModel，属性变化写入事件环
+import { parentPort } from 'worker_threads'
+import { ApplyMemoryBudget, EventOp, ExecuteBatch, RequestOp } from './mvvm_protocol'
+import type { WorkerInit } from './mvvm_protocol'
+import { SharedRing } from './mvvm_ring'
+import { BinaryReader, BinaryWriter } from './variant_codec'
+
+interface NativeViewModel {
+  GetPropStats(): Record<string, { sets: number; skips: number }>
+  GetPropsEncoded(): Uint8Array
+  BindAnyPropertyEncoded(callback: (prop_name: string, value: Uint8Array) => void): void
+  ExcuteCommandEncoded(command_name: string, param?: Uint8Array): boolean
+}
+
+// 连续处理这么多条请求后让出一次事件循环，保证C++后台任务投递回来的回调能执行
+const REQUESTS_PER_TURN = 256
+
+const RequireFunc = eval('require')
+const MVVMNative = RequireFunc('../../backend/build/Release/life_view_backend.node')
+ApplyMemoryBudget(MVVMNative)
+
+const instances = new Map<number, NativeViewModel>()
+const writer = new BinaryWriter()
+let command_ring: SharedRing
+let event_ring: SharedRing
+
+function PostEvent(): void {
+  const payload = writer.Bytes()
+  // 渲染线程来不及消费时阻塞worker，形成背压
+  while (!event_ring.TryWrite(payload)) {
+    event_ring.WaitWritableSync(100)
+  }
+}
+
+function PostError(id: number, message: string): void {
+  writer.Reset()
+  writer.WriteU8(EventOp.Error)
+  writer.WriteVarint(id)
+  writer.WriteString(message)
+  PostEvent()
+}
+
+function CreateViewModel(id: number, type: string): void {
+  let instance: NativeViewModel
+  try {
+    instance = MVVMNative.createViewModel(type)
+  } catch (error) {
+    PostError(id, `create ${type} failed: ${error}`)
+    return
+  }
+  instances.set(id, instance)
+
+  instance.BindAnyPropertyEncoded((prop_name, value) => {
+    writer.Reset()
+    writer.WriteU8(EventOp.PropChanged)
+    writer.WriteVarint(id)
+    writer.WriteString(prop_name)
+    writer.WriteBytes(value)
+    PostEvent()
+  })
+
+  writer.Reset()
+  writer.WriteU8(EventOp.Snapshot)
+  writer.WriteVarint(id)
+  // 只有一个消费者，channel直接使用请求id
+  writer.WriteVarint(id)
+  writer.WriteBytes(instance.GetPropsEncoded())
+  PostEvent()
+}
+
+function HandleRequest(bytes: Uint8Array): void {
+  const reader = new BinaryReader(bytes)
+  const op = reader.ReadU8()
+  const id = reader.ReadVarint()
+
+  if (op === RequestOp.Create) {
+    CreateViewModel(id, reader.ReadString())
+    return
+  }
+  // 只有一个消费者，所有属性变化都会推送，不需要订阅过滤；事件环本身提供背压
+  if (op === RequestOp.Subscribe || op === RequestOp.Ack) {
+    return
+  }
+
+  const instance = instances.get(id)
+  if (!instance) {
+    PostError(id, 'ViewModel not initialized')
+    return
+  }
+
+  switch (op) {
+    case RequestOp.Command: {
+      const command_name = reader.ReadString()
+      const has_param = reader.ReadU8() !== 0
+      // 参数视图指向共享内存，拷贝一份再交给C++
+      const param = has_param ? reader.ReadBytes(reader.Remaining()).slice() : undefined
+      try {
+        instance.ExcuteCommandEncoded(command_name, param)
+      } catch (error) {
+        PostError(id, `execute command ${command_name} failed: ${error}`)
+      }
+      break
+    }
+    case RequestOp.Batch:
+      ExecuteBatch(reader, instance, (message) => PostError(id, message))
+      break
+    case RequestOp.GetStats:
+      writer.Reset()
+      writer.WriteU8(EventOp.Stats)
+      writer.WriteVarint(id)
+      writer.WriteValue(instance.GetPropStats())
+      PostEvent()
+      break
+    default:
+      PostError(id, `unknown request ${op}`)
+  }
+}
+
+async function Run(): Promise<void> {
+  for (;;) {
+    let handled = 0
+    let bytes: Uint8Array | null
+    while (handled < REQUESTS_PER_TURN && (bytes = command_ring.Peek()) !== null) {
+      try {
+        HandleRequest(bytes)
+      } catch (error) {
+        console.error('mvvm_worker: bad request', error)
+      }
+      command_ring.Consume()
+      ++handled
+    }
+    if (handled === REQUESTS_PER_TURN) {
+      await new Promise((resolve) => setImmediate(resolve))
+    } else {
+      await command_ring.WaitReadable()
+    }
+  }
+}
+
+// 保持message监听，worker不会因为没有活动句柄而退出
+parentPort?.on('message', (init: WorkerInit) => {
+  if (command_ring) {
+    return
+  }
+  command_ring = new SharedRing(init.command_ring)
+  event_ring = new SharedRing(init.event_ring)
+  void Run()
+})
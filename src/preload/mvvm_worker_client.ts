@@ -0,0 +1,92 @@
+/*
+ * @Author: Nana5aki
+ * @Date: 2026-10-18 19:02:36
+ * @LastEditors: Nana5aki
+ * @LastEditTime: 2026-10-18 20:05:41
+ * @FilePath: \life_view\src\preload\mvvm_worker_client.ts
+ */
+
+// worker模式：后端运行在同进程的worker线程中，通过SharedArrayBuffer环形缓冲区通信
+import { Worker } from 'worker_threads'
+import { MVVMClient } from './mvvm_client'
+import { COMMAND_RING_BYTES, EVENT_RING_BYTES } from './mvvm_protocol'
+import type { WorkerInit } from './mvvm_protocol'
+import { SharedRing } from './mvvm_ring'
+
+// 一次连续分发事件的时间上限，超过后让出给渲染
+const DISPATCH_BUDGET_MS = 4
+
+export class WorkerTransport extends MVVMClient {
+  private worker: Worker
+  private command_ring: SharedRing
+  private event_ring: SharedRing
+  // 命令环写满时暂存，按顺序补发。pending_head之前的已发送
+  private pending: Uint8Array[] = []
+  private pending_head = 0
+  private flushing = false
+
+  constructor(worker_path: string) {
+    super()
+    const init: WorkerInit = {
+      command_ring: SharedRing.Allocate(COMMAND_RING_BYTES),
+      event_ring: SharedRing.Allocate(EVENT_RING_BYTES)
+    }
+    this.command_ring = new SharedRing(init.command_ring)
+    this.event_ring = new SharedRing(init.event_ring)
+
+    this.worker = new Worker(worker_path)
+    this.worker.on('error', (error) => {
+      console.error('MVVM worker failed', error)
+    })
+    this.worker.postMessage(init)
+    void this.Pump()
+  }
+
+  protected Send(): void {
+    const payload = this.writer.Bytes()
+    if (this.pending.length === 0 && this.command_ring.TryWrite(payload)) {
+      return
+    }
+    this.pending.push(payload.slice())
+    if (!this.flushing) {
+      void this.Flush()
+    }
+  }
+
+  private async Flush(): Promise<void> {
+    this.flushing = true
+    while (this.pending_head < this.pending.length) {
+      if (this.command_ring.TryWrite(this.pending[this.pending_head])) {
+        ++this.pending_head
+      } else {
+        await this.command_ring.WaitWritable()
+      }
+    }
+    this.pending = []
+    this.pending_head = 0
+    this.flushing = false
+  }
+
+  private async Pump(): Promise<void> {
+    for (;;) {
+      const start = performance.now()
+      let bytes: Uint8Array | null
+      while ((bytes = this.event_ring.Peek()) !== null) {
+        try {
+          this.HandleEvent(bytes)
+        } catch (error) {
+          console.error('MVVM worker event failed', error)
+        }
+        this.event_ring.Consume()
+        if (performance.now() - start > DISPATCH_BUDGET_MS) {
+          break
+        }
+      }
+      if (this.event_ring.IsEmpty()) {
+        await this.event_ring.WaitReadable()
+      } else {
+        await new Promise((resolve) => setTimeout(resolve, 0))
+      }
+    }
+  }
+}
@@ -0,0 +1,284 @@
+/*
+ * @Author: Nana5aki
+ * @Date: 2026-10-18 18:20:14
+ * @LastEditors: Nana5aki
+ * @LastEditTime: 2026-10-18 18:20:14
+ * @FilePath: \life_view\src\preload\variant_codec.ts
+ */
+
+// Variant二进制编码的JS实现，格式见backend/src/framework/mvvm/variant_codec.h
+// JS值与Variant的对应关系和NValueToVariant/VariantToNValue一致：
+// int32范围内的整数编码为Int，其余数字为Double，undefined/函数等编码为Null
+export const VariantTag = {
+  Null: 0,
+  False: 1,
+  True: 2,
+  Int: 3,
+  Double: 4,
+  String: 5,
+  Array: 6,
+  Map: 7
+} as const
+
+const MAX_DEPTH = 1024
+const text_encoder = new TextEncoder()
+const text_decoder = new TextDecoder()
+
+export class BinaryWriter {
+  private bytes: Uint8Array
+  private view: DataView
+  private length = 0
+
+  constructor(initial_capacity = 256) {
+    this.bytes = new Uint8Array(initial_capacity)
+    this.view = new DataView(this.bytes.buffer)
+  }
+
+  Reset(): void {
+    this.length = 0
+  }
+
+  // 返回已写入部分的视图，下次写入前有效
+  Bytes(): Uint8Array {
+    return this.bytes.subarray(0, this.length)
+  }
+
+  WriteU8(value: number): void {
+    this.Reserve(1)
+    this.bytes[this.length++] = value
+  }
+
+  WriteVarint(value: number): void {
+    this.Reserve(10)
+    while (value >= 0x80) {
+      this.bytes[this.length++] = (value % 0x80) | 0x80
+      value = Math.floor(value / 0x80)
+    }
+    this.bytes[this.length++] = value
+  }
+
+  WriteString(text: string): void {
+    // UTF-16的每个码元最多对应3字节UTF-8，先按最坏情况预留长度前缀和内容
+    const max_bytes = text.length * 3
+    this.Reserve(5 + max_bytes)
+    if (text.length < 0x80 / 3) {
+      // 长度前缀只占1字节，直接编码到位
+      const start = this.length + 1
+      const { written } = text_encoder.encodeInto(text, this.bytes.subarray(start))
+      this.bytes[this.length] = written
+      this.length = start + written
+      return
+    }
+    const encoded = text_encoder.encode(text)
+    this.WriteVarint(encoded.length)
+    this.WriteBytes(encoded)
+  }
+
+  WriteBytes(data: Uint8Array): void {
+    this.Reserve(data.length)
+    this.bytes.set(data, this.length)
+    this.length += data.length
+  }
+
+  WriteValue(value: unknown, depth = 0): void {
+    if (depth > MAX_DEPTH) {
+      throw new Error('variant_codec: value nested too deeply')
+    }
+    if (value === null || value === undefined) {
+      this.WriteU8(VariantTag.Null)
+    } else if (typeof value === 'boolean') {
+      this.WriteU8(value ? VariantTag.True : VariantTag.False)
+    } else if (typeof value === 'number') {
+      if ((value | 0) === value) {
+        this.Reserve(5)
+        this.bytes[this.length] = VariantTag.Int
+        this.view.setInt32(this.length + 1, value, true)
+        this.length += 5
+      } else {
+        this.Reserve(9)
+        this.bytes[this.length] = VariantTag.Double
+        this.view.setFloat64(this.length + 1, value, true)
+        this.length += 9
+      }
+    } else if (typeof value === 'string') {
+      this.WriteU8(VariantTag.String)
+      this.WriteString(value)
+    } else if (Array.isArray(value)) {
+      this.WriteU8(VariantTag.Array)
+      this.WriteVarint(value.length)
+      for (const item of value) {
+        this.WriteValue(item, depth + 1)
+      }
+    } else if (typeof value === 'object') {
+      const keys = Object.keys(value)
+      this.WriteU8(VariantTag.Map)
+      this.WriteVarint(keys.length)
+      for (const key of keys) {
+        this.WriteString(key)
+        this.WriteValue((value as Record<string, unknown>)[key], depth + 1)
+      }
+    } else {
+      this.WriteU8(VariantTag.Null)
+    }
+  }
+
+  private Reserve(extra: number): void {
+    const required = this.length + extra
+    if (required <= this.bytes.length) {
+      return
+    }
+    let capacity = this.bytes.length * 2
+    while (capacity < required) {
+      capacity *= 2
+    }
+    const grown = new Uint8Array(capacity)
+    grown.set(this.bytes.subarray(0, this.length))
+    this.bytes = grown
+    this.view = new DataView(grown.buffer)
+  }
+}
+
+export class BinaryReader {
+  private bytes: Uint8Array
+  private view: DataView
+  offset = 0
+
+  // bytes可以是SharedArrayBuffer上的视图
+  constructor(bytes: Uint8Array) {
+    this.bytes = bytes
+    this.view = new DataView(bytes.buffer, bytes.byteOffset, bytes.byteLength)
+  }
+
+  Remaining(): number {
+    return this.bytes.length - this.offset
+  }
+
+  ReadU8(): number {
+    this.Require(1)
+    return this.bytes[this.offset++]
+  }
+
+  ReadVarint(): number {
+    let result = 0
+    let scale = 1
+    for (let i = 0; i < 8; ++i) {
+      const byte = this.ReadU8()
+      result += (byte & 0x7f) * scale
+      if (!(byte & 0x80)) {
+        return result
+      }
+      scale *= 0x80
+    }
+    throw new Error('variant_codec: varint too long')
+  }
+
+  ReadString(): string {
+    const len = this.ReadVarint()
+    this.Require(len)
+    const start = this.offset
+    this.offset += len
+    // 短字符串多为ASCII，逐字节转换比TextDecoder快
+    if (len <= 32) {
+      let text = ''
+      for (let i = start; i < start + len; ++i) {
+        const byte = this.bytes[i]
+        if (byte >= 0x80) {
+          return this.DecodeUtf8(start, len)
+        }
+        text += String.fromCharCode(byte)
+      }
+      return text
+    }
+    return this.DecodeUtf8(start, len)
+  }
+
+  // 返回接下来len字节的视图
+  ReadBytes(len: number): Uint8Array {
+    this.Require(len)
+    const start = this.offset
+    this.offset += len
+    return this.bytes.subarray(start, start + len)
+  }
+
+  ReadValue(depth = 0): unknown {
+    if (depth > MAX_DEPTH) {
+      throw new Error('variant_codec: value nested too deeply')
+    }
+    const tag = this.ReadU8()
+    switch (tag) {
+      case VariantTag.Null:
+        return null
+      case VariantTag.False:
+        return false
+      case VariantTag.True:
+        return true
+      case VariantTag.Int: {
+        this.Require(4)
+        const value = this.view.getInt32(this.offset, true)
+        this.offset += 4
+        return value
+      }
+      case VariantTag.Double: {
+        this.Require(8)
+        const value = this.view.getFloat64(this.offset, true)
+        this.offset += 8
+        return value
+      }
+      case VariantTag.String:
+        return this.ReadString()
+      case VariantTag.Array: {
+        const count = this.ReadVarint()
+        // 每个元素至少1字节
+        this.Require(count)
+        const arr = new Array(count)
+        for (let i = 0; i < count; ++i) {
+          arr[i] = this.ReadValue(depth + 1)
+        }
+        return arr
+      }
+      case VariantTag.Map: {
+        const count = this.ReadVarint()
+        this.Require(count)
+        const obj: Record<string, unknown> = {}
+        for (let i = 0; i < count; ++i) {
+          const key = this.ReadString()
+          const value = this.ReadValue(depth + 1)
+          if (key === '__proto__') {
+            Object.defineProperty(obj, key, { value, enumerable: true, writable: true })
+          } else {
+            obj[key] = value
+          }
+        }
+        return obj
+      }
+      default:
+        throw new Error(`variant_codec: unknown tag ${tag}`)
+    }
+  }
+
+  private DecodeUtf8(start: number, len: number): string {
+    // Chromium的TextDecoder不接受SharedArrayBuffer上的视图，slice会拷贝到普通ArrayBuffer
+    return text_decoder.decode(this.bytes.slice(start, start + len))
+  }
+
+  private Require(len: number): void {
+    if (len > this.bytes.length - this.offset) {
+      throw new Error('variant_codec: unexpected end of data')
+    }
+  }
+}
+
+export function EncodeValue(value: unknown): Uint8Array {
+  const writer = new BinaryWriter()
+  writer.WriteValue(value)
+  return writer.Bytes().slice()
+}
+
+export function DecodeValue(bytes: Uint8Array): unknown {
+  const reader = new BinaryReader(bytes)
+  const value = reader.ReadValue()
+  if (reader.Remaining() !== 0) {
+    throw new Error('variant_codec: trailing bytes')
+  }
+  return value
+}
@@ -7,24 +7,110 @@
  */
 import { useState, useEffect, useCallback, useRef } from 'react'
 
+interface CommandCall {
+  name: string
+  param?: unknown
+}
+
+interface CommandResult {
+  // 命令是否成功(见index.d.ts)；进程外模式下为undefined，命令已发送、结果未知
+  ok: boolean | undefined
+  error?: string
+}
+
 interface ViewModelInstance {
   GetProp(prop_name: string): unknown
+  GetProps(prop_names?: string[]): Record<string, unknown>
   BindProperty(
     prop_name: string,
     callback: (ChangeInfo: { prop_name: string; value: unknown }) => void
   ): void
   ExcuteCommand(command_name: string, param?: unknown): void
+  ExcuteCommands(commands: CommandCall[], options?: { stop_on_error?: boolean }): CommandResult[]
+  GetPropStats(): Record<string, { sets: number; skips: number }>
+}
+
+// 冻结next中新出现的对象和数组，与previous中已冻结的部分一致
+function FreezeDeep(value: unknown): unknown {
+  if (value === null || typeof value !== 'object' || Object.isFrozen(value)) {
+    return value
+  }
+  for (const item of Object.values(value)) {
+    FreezeDeep(item)
+  }
+  return Object.freeze(value)
+}
+
+// 属性值经contextBridge传入时每次都是新拷贝。这里把next中与previous结构相等的部分
+// 换回previous中的对象，整体相等时返回previous本身，React可以直接按引用比较。
+// 数组元素先按位置比较，对不上时再按末尾对齐比较，覆盖在某处插入或删除的情况
+export function ShareUnchanged(previous: unknown, next: unknown): unknown {
+  if (previous === next || next === null || typeof next !== 'object') {
+    return next
+  }
+  if (previous === null || typeof previous !== 'object') {
+    return FreezeDeep(next)
+  }
+  if (Array.isArray(next)) {
+    if (!Array.isArray(previous)) {
+      return FreezeDeep(next)
+    }
+    const shift = previous.length - next.length
+    let same = shift === 0
+    const result = next.map((item, index) => {
+      let shared = index < previous.length ? ShareUnchanged(previous[index], item) : item
+      if (shared !== previous[index] && shift !== 0 && index + shift >= 0) {
+        const shifted = ShareUnchanged(previous[index + shift], item)
+        if (shifted === previous[index + shift]) {
+          shared = shifted
+        }
+      }
+      same = same && shared === previous[index]
+      return FreezeDeep(shared)
+    })
+    return same ? previous : Object.freeze(result)
+  }
+  if (Array.isArray(previous)) {
+    return FreezeDeep(next)
+  }
+  const old_object = previous as Record<string, unknown>
+  const keys = Object.keys(next)
+  let same = keys.length === Object.keys(old_object).length
+  const result: Record<string, unknown> = {}
+  for (const key of keys) {
+    const shared = ShareUnchanged(old_object[key], (next as Record<string, unknown>)[key])
+    same = same && key in old_object && shared === old_object[key]
+    result[key] = shared
+  }
+  return same ? previous : Object.freeze(result)
 }
 
 interface UseMVVMReturn {
   ExcuteCommand: (command_name: string, ...args: unknown[]) => void
+  // 组合操作一次调用执行多个命令
+  ExcuteCommands: (
+    commands: CommandCall[],
+    options?: { stop_on_error?: boolean }
+  ) => CommandResult[]
+  // GetProp、GetProps和BindProperty回调得到的值按属性缓存：值未变化时返回同一个对象，
+  // 变化后未变的子对象沿用原实例。返回值是共享且冻结的，需要排序等修改时先拷贝
   GetProp: (prop_name: string) => unknown
+  // 界面挂载时一次取回所需的属性
+  GetProps: (prop_names?: string[]) => Record<string, unknown>
   BindProperty: (prop_name: string, callback: (value: unknown) => void) => () => void
 }
 
 export function useMVVM(viewmodel_type: string): UseMVVMReturn {
   const [viewModelInstance, setViewModelInstance] = useState<ViewModelInstance | null>(null)
   const mountedRef = useRef(true)
+  // 属性名 -> 最近一次交给界面的值
+  const sharedRef = useRef(new Map<string, unknown>())
+
+  const Share = useCallback((prop_name: string, value: unknown) => {
+    const shared = ShareUnchanged(sharedRef.current.get(prop_name), value)
+    sharedRef.current.set(prop_name, shared)
+    return shared
+  }, [])
 
   // 初始化ViewModel - 直接调用C++接口
   useEffect(() => {
@@ -37,6 +123,7 @@ export function useMVVM(viewmodel_type: string): UseMVVMReturn {
       }
 
       const instance = window.api.mvvm.CreateViewModel(viewmodel_type)
+      sharedRef.current.clear()
 
       if (mountedRef.current) {
         setViewModelInstance(instance)
@@ -73,6 +160,29 @@ export function useMVVM(viewmodel_type: string): UseMVVMReturn {
     [viewModelInstance]
   )
 
+  const ExcuteCommands = useCallback(
+    (commands: CommandCall[], options?: { stop_on_error?: boolean }) => {
+      if (!viewModelInstance) {
+        console.error('useMVVM: ViewModel not init')
+        return commands.map(() => ({ ok: false, error: 'ViewModel not init' }))
+      }
+
+      try {
+        const results = viewModelInstance.ExcuteCommands(commands, options)
+        for (const [index, result] of results.entries()) {
+          if (result.ok === false && result.error !== 'skipped') {
+            console.error('useMVVM: execute command failed:', commands[index].name, result.error)
+          }
+        }
+        return results
+      } catch (error) {
+        console.error('useMVVM: execute commands failed:', error)
+        return commands.map(() => ({ ok: false, error: String(error) }))
+      }
+    },
+    [viewModelInstance]
+  )
+
   const GetProp = useCallback(
     (prop_name: string) => {
       if (!viewModelInstance) {
@@ -81,14 +191,34 @@ export function useMVVM(viewmodel_type: string): UseMVVMReturn {
       }
 
       try {
-        const value = viewModelInstance.GetProp(prop_name)
-        return value
+        return Share(prop_name, viewModelInstance.GetProp(prop_name))
       } catch (error) {
         console.error('useMVVM: get prop failed:', prop_name, error)
         return undefined
       }
     },
-    [viewModelInstance]
+    [viewModelInstance, Share]
+  )
+
+  const GetProps = useCallback(
+    (prop_names?: string[]) => {
+      if (!viewModelInstance) {
+        console.error('useMVVM: ViewModel not init')
+        return {}
+      }
+
+      try {
+        const props = viewModelInstance.GetProps(prop_names)
+        for (const prop_name of Object.keys(props)) {
+          props[prop_name] = Share(prop_name, props[prop_name])
+        }
+        return props
+      } catch (error) {
+        console.error('useMVVM: get props failed:', prop_names, error)
+        return {}
+      }
+    },
+    [viewModelInstance, Share]
   )
 
   const BindProperty = useCallback(
@@ -102,7 +232,7 @@ export function useMVVM(viewmodel_type: string): UseMVVMReturn {
       try {
         viewModelInstance.BindProperty(prop_name, (ChangeInfo) => {
           if (mountedRef.current) {
-            callback(ChangeInfo.value)
+            callback(Share(prop_name, ChangeInfo.value))
           }
         })
       } catch (error) {
@@ -111,8 +241,8 @@ export function useMVVM(viewmodel_type: string): UseMVVMReturn {
 
       return () => {}
     },
-    [viewModelInstance]
+    [viewModelInstance, Share]
   )
 
-  return { ExcuteCommand, GetProp, BindProperty }
+  return { ExcuteCommand, ExcuteCommands, GetProp, GetProps, BindProperty }
 }